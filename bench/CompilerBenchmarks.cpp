@@ -0,0 +1,186 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./utils/benchmark_utils.hpp"
+#include "pljit/ast/ASTParser.hpp"
+#include "pljit/optimizations/CommonSubexpressionElimination.hpp"
+#include "pljit/optimizations/ConstantPropagation.hpp"
+#include "pljit/optimizations/DeadCodeElimination.hpp"
+#include "pljit/optimizations/PassManager.hpp"
+#include "pljit/pljit.hpp"
+#include <filesystem>
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::bench;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+code::SourceCodeManagement generateProgram(const benchmark::State& state) {
+    ProgramGenerator generator;
+    return code::SourceCodeManagement{ generator.generate(shapeOf(state)) };
+}
+
+/**
+ * Benchmarks a single optimization pass. The AST is rebuilt (untimed) before every run,
+ * as passes modify the function in place.
+ */
+template <typename Pass>
+void BM_OptimizationPass(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        ast::Function function = buildAST(management);
+        Pass pass;
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(pass.optimize(function));
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+static void BM_Lexer(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+    std::size_t tokens = 0;
+
+    for (auto _: state) {
+        lex::Lexer lexer{ management };
+        while (!lexer.endOfStream()) {
+            lex::Token token = lexer.next();
+            benchmark::DoNotOptimize(token);
+            ++tokens;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(tokens));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(management.content().size()));
+}
+BENCHMARK(BM_Lexer)->Apply(ProgramShapes);
+
+static void BM_Parser(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+
+    for (auto _: state) {
+        lex::Lexer lexer{ management };
+        parse::Parser parser{ lexer };
+        Result<parse::FunctionDefinition> program = parser.parse_program();
+        benchmark::DoNotOptimize(program);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(management.content().size()));
+}
+BENCHMARK(BM_Parser)->Apply(ProgramShapes);
+
+static void BM_ASTBuilder(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+    lex::Lexer lexer{ management };
+    parse::Parser parser{ lexer };
+    Result<parse::FunctionDefinition> program = parser.parse_program();
+
+    for (auto _: state) {
+        ast::ASTBuilder builder;
+        Result<ast::Function> function = builder.analyzeFunction(*program);
+        benchmark::DoNotOptimize(function);
+    }
+}
+BENCHMARK(BM_ASTBuilder)->Apply(ProgramShapes);
+
+/**
+ * Lexing, parsing and semantic analysis through the parse tree, compared to building the AST directly in `BM_ASTParser`.
+ */
+static void BM_ParseTreeToAST(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+
+    for (auto _: state) {
+        lex::Lexer lexer{ management };
+        parse::Parser parser{ lexer };
+        Result<parse::FunctionDefinition> program = parser.parse_program();
+        ast::ASTBuilder builder;
+        Result<ast::Function> function = builder.analyzeFunction(*program);
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(management.content().size()));
+}
+BENCHMARK(BM_ParseTreeToAST)->Apply(ProgramShapes);
+
+static void BM_ASTParser(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+
+    for (auto _: state) {
+        lex::Lexer lexer{ management };
+        ast::ASTParser parser{ lexer };
+        Result<ast::Function> function = parser.parseFunction();
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(management.content().size()));
+}
+BENCHMARK(BM_ASTParser)->Apply(ProgramShapes);
+
+BENCHMARK_TEMPLATE(BM_OptimizationPass, ast::optimize::ConstantPropagation)->Apply(ProgramShapes);
+BENCHMARK_TEMPLATE(BM_OptimizationPass, ast::optimize::DeadCodeElimination)->Apply(ProgramShapes);
+BENCHMARK_TEMPLATE(BM_OptimizationPass, ast::optimize::CommonSubexpressionElimination)->Apply(ProgramShapes);
+
+static void BM_PassManager(benchmark::State& state) {
+    code::SourceCodeManagement management = generateProgram(state);
+    auto level = static_cast<OptimizationLevel>(state.range(3));
+
+    for (auto _: state) {
+        state.PauseTiming();
+        ast::Function function = buildAST(management);
+        ast::optimize::PassManager manager = ast::optimize::PassManager::forLevel(level);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(manager.run(function));
+    }
+}
+BENCHMARK(BM_PassManager)
+    ->ArgNames({ "statements", "depth", "variables", "level" })
+    ->Args({ 128, 4, 16, static_cast<int>(OptimizationLevel::O1) })
+    ->Args({ 128, 4, 16, static_cast<int>(OptimizationLevel::O2) });
+
+/**
+ * Simulates a process restart: registers and compiles a set of functions on a new `Pljit` instance.
+ * The cold run starts with an empty `CodeCache` directory, the warm run with the entries of a previous run.
+ */
+static void BM_PljitStartup(benchmark::State& state) {
+    bool warm = state.range(0) != 0;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("pljit-bench-" + std::to_string(getpid()));
+    std::filesystem::remove_all(directory);
+
+    ProgramGenerator generator;
+    std::vector<std::string> sources;
+    for (unsigned index = 0; index < 64; ++index) {
+        sources.push_back(generator.generate(ProgramShape{ .statements = 128, .expression_depth = 4, .variables = 16 }));
+    }
+
+    auto startup = [&]() {
+        Pljit pljit{ { .code_cache_directory = directory } };
+        for (auto& source: sources) {
+            pljit.registerFunction(std::string{ source }, { .compilation_mode = CompilationMode::EAGER });
+        }
+    };
+
+    if (warm) {
+        startup();
+    }
+
+    for (auto _: state) {
+        if (!warm) {
+            state.PauseTiming();
+            std::filesystem::remove_all(directory);
+            state.ResumeTiming();
+        }
+        startup();
+    }
+
+    std::filesystem::remove_all(directory);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(sources.size()));
+}
+BENCHMARK(BM_PljitStartup)->ArgName("warm")->Arg(0)->Arg(1);
+//---------------------------------------------------------------------------
@@ -0,0 +1,317 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./utils/benchmark_utils.hpp"
+#include "pljit/pljit.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::bench;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+void ExecutionModes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({ "statements", "depth", "variables", "mode" });
+    for (auto mode: { ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE }) {
+        benchmark->Args({ 16, 3, 4, static_cast<int>(mode) });
+        benchmark->Args({ 128, 4, 16, static_cast<int>(mode) });
+    }
+}
+
+CompileOptions optionsOf(const benchmark::State& state) {
+    return CompileOptions{ .execution_mode = static_cast<ExecutionMode>(state.range(3)) };
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+static void BM_FunctionEvaluate(benchmark::State& state) {
+    ProgramGenerator generator;
+    code::SourceCodeManagement management{ generator.generate(shapeOf(state)) };
+    ast::Function function = buildAST(management);
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    for (auto _: state) {
+        EvaluationContext context = function.evaluate(arguments);
+        benchmark::DoNotOptimize(context);
+    }
+}
+BENCHMARK(BM_FunctionEvaluate)->Apply(ProgramShapes);
+
+static void BM_PljitCompile(benchmark::State& state) {
+    ProgramGenerator generator;
+    std::string source = generator.generate(shapeOf(state));
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // functions are compiled lazily, thus we measure registration together with the first call.
+    for (auto _: state) {
+        Pljit pljit;
+        auto function = pljit.registerFunction(std::string{ source }, optionsOf(state));
+        std::optional<long long> result = function({ arguments[0], arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_PljitCompile)->Apply(ExecutionModes);
+
+static void BM_PljitTieredFirstCall(benchmark::State& state) {
+    ProgramGenerator generator;
+    std::string source = generator.generate(shapeOf(state));
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // like `BM_PljitCompile`, but the first call only compiles the baseline tier
+    for (auto _: state) {
+        Pljit pljit;
+        auto function = pljit.registerFunction(std::string{ source }, { .tier_up_threshold = 1000 });
+        std::optional<long long> result = function({ arguments[0], arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_PljitTieredFirstCall)->Apply(ProgramShapes);
+
+static void BM_PljitFunctionHandle(benchmark::State& state) {
+    ProgramGenerator generator;
+    Pljit pljit;
+    auto function = pljit.registerFunction(generator.generate(shapeOf(state)), optionsOf(state));
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // the first call compiles the function
+    if (!function({ arguments[0], arguments[1], arguments[2] })) {
+        state.SkipWithError("Generated program failed to evaluate!");
+    }
+
+    for (auto _: state) {
+        std::optional<long long> result = function({ arguments[0], arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_PljitFunctionHandle)->Apply(ExecutionModes);
+
+static void BM_PljitSpeculatedCall(benchmark::State& state) {
+    ProgramGenerator generator;
+    Pljit pljit;
+    CompileOptions options = optionsOf(state);
+    options.value_profile_calls = 16;
+    auto function = pljit.registerFunction(generator.generate(shapeOf(state)), options);
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // like `BM_PljitFunctionHandle`, but the profiled calls always pass the same arguments
+    for (unsigned call = 0; call < options.value_profile_calls; ++call) {
+        function({ arguments[0], arguments[1], arguments[2] });
+    }
+    // the speculative version is compiled in the background, calls with too few arguments pick it up once ready
+    while (function.speculation_statistics().state == SpeculationState::COMPILING) {
+        function.call({ arguments[0] });
+    }
+    if (function.speculation_statistics().state != SpeculationState::GUARDED) {
+        state.SkipWithError("Function wasn't speculated!");
+    }
+
+    for (auto _: state) {
+        std::optional<long long> result = function({ arguments[0], arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_PljitSpeculatedCall)->Apply(ExecutionModes);
+
+static void BM_PljitMemoizedCall(benchmark::State& state) {
+    ProgramGenerator generator;
+    Pljit pljit;
+    CompileOptions options = optionsOf(state);
+    options.memoization_memory_limit = 64 * 1024;
+    auto function = pljit.registerFunction(generator.generate(shapeOf(state)), options);
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // like `BM_PljitFunctionHandle`, but cycling through 64 argument tuples which all fit into the cache
+    long long call = 0;
+    for (auto _: state) {
+        long long offset = call++ % 64;
+        std::optional<long long> result = function({ arguments[0] - offset, arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["hit_rate"] = function.memoization_statistics().hit_rate();
+}
+BENCHMARK(BM_PljitMemoizedCall)->Apply(ExecutionModes);
+
+static void BM_PljitSharedSubexpressions(benchmark::State& state) {
+    // rules repeating the same subexpressions, like the ones generated from a shared template
+    constexpr int rules = 16;
+    auto rule = [](int index) {
+        return std::string{ 'r', static_cast<char>('a' + index) };
+    };
+
+    std::string source = "PARAM a, b, c;\nVAR ";
+    std::string sum;
+    for (int index = 0; index < rules; ++index) {
+        source += (index ? ", " : "") + rule(index);
+        sum += (index ? " + " : "") + rule(index);
+    }
+    source += ";\nBEGIN\n";
+    for (int index = 0; index < rules; ++index) {
+        source += "  " + rule(index) + " := (a * b + c) * " + std::to_string(index + 1);
+        source += " + (a - c) * (a * b + c) / (b * b + 1);\n";
+    }
+    source += "  RETURN " + sum + "\nEND.";
+
+    Pljit pljit;
+    auto function = pljit.registerFunction(std::move(source), {
+        .execution_mode = static_cast<ExecutionMode>(state.range(0)),
+        .optimization_level = static_cast<OptimizationLevel>(state.range(1)),
+    });
+
+    if (!function(7, 3, 5)) {
+        state.SkipWithError("Function failed to evaluate!");
+    }
+
+    for (auto _: state) {
+        std::optional<long long> result = function(7, 3, 5);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_PljitSharedSubexpressions)
+    ->ArgNames({ "mode", "level" })
+    ->ArgsProduct({ { static_cast<int>(ExecutionMode::AST_INTERPRETER), static_cast<int>(ExecutionMode::BYTECODE), static_cast<int>(ExecutionMode::NATIVE) },
+                    { static_cast<int>(OptimizationLevel::O1), static_cast<int>(OptimizationLevel::O2) } });
+
+static void BM_PljitFunctionBatch(benchmark::State& state) {
+    ProgramGenerator generator;
+    Pljit pljit;
+    auto function = pljit.registerFunction(generator.generate(shapeOf(state)), optionsOf(state));
+
+    constexpr std::size_t rows = 1 << 14;
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+    std::vector<std::vector<long long>> columns;
+    for (long long argument: arguments) {
+        std::vector<long long>& column = columns.emplace_back(rows);
+        for (std::size_t row = 0; row < rows; ++row) {
+            column[row] = argument - static_cast<long long>(row % 64);
+        }
+    }
+    std::vector<std::span<const long long>> column_spans{ columns.begin(), columns.end() };
+    std::vector<long long> output(rows);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+
+    for (auto _: state) {
+        RuntimeErrorCode error = function.evaluateBatch(column_spans, output, errors);
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+}
+BENCHMARK(BM_PljitFunctionBatch)->Apply(ExecutionModes);
+
+static void BM_PljitWarmup(benchmark::State& state) {
+    ProgramGenerator generator;
+    std::vector<std::string> sources;
+    for (unsigned index = 0; index < 32; ++index) {
+        sources.push_back(generator.generate(ProgramShape{ .statements = 128, .expression_depth = 4, .variables = 16 }));
+    }
+
+    for (auto _: state) {
+        Pljit pljit{ { .compile_threads = static_cast<std::size_t>(state.range(0)) } };
+        for (auto& source: sources) {
+            pljit.registerFunction(std::string{ source });
+        }
+        pljit.warmup();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(sources.size()));
+}
+BENCHMARK(BM_PljitWarmup)->ArgName("compile_threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+static void BM_PljitCompileDuplicates(benchmark::State& state) {
+    ProgramGenerator generator;
+    std::string source = generator.generate(ProgramShape{ .statements = 128, .expression_depth = 4, .variables = 16 });
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+
+    // every source is registered 8 times, as if shared by multiple tenants
+    for (auto _: state) {
+        Pljit pljit{ { .compile_cache_mode = static_cast<CompileCacheMode>(state.range(0)) } };
+        for (unsigned index = 0; index < 8; ++index) {
+            auto function = pljit.registerFunction(std::string{ source });
+            std::optional<long long> result = function({ arguments[0], arguments[1], arguments[2] });
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+BENCHMARK(BM_PljitCompileDuplicates)
+    ->ArgName("cache_mode")
+    ->Arg(static_cast<int>(CompileCacheMode::DISABLED))
+    ->Arg(static_cast<int>(CompileCacheMode::EXACT))
+    ->Arg(static_cast<int>(CompileCacheMode::IGNORE_WHITESPACE));
+
+/// Shared between the threads of `BM_PljitFunctionHandleMultiThreaded`. Set up and torn down by thread 0.
+static std::unique_ptr<Pljit> shared_pljit;
+static std::optional<PljitFunctionHandle> shared_function;
+
+static void BM_PljitFunctionHandleMultiThreaded(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        ProgramGenerator generator;
+        shared_pljit = std::make_unique<Pljit>();
+        shared_function = shared_pljit->registerFunction(generator.generate(shapeOf(state)), optionsOf(state));
+    }
+
+    std::vector<long long> arguments = ProgramGenerator::arguments();
+    if (state.thread_index == 0 && !(*shared_function)({ arguments[0], arguments[1], arguments[2] })) {
+        state.SkipWithError("Generated program failed to evaluate!");
+    }
+    for (auto _: state) {
+        std::optional<long long> result = (*shared_function)({ arguments[0], arguments[1], arguments[2] });
+        benchmark::DoNotOptimize(result);
+    }
+
+    if (state.thread_index == 0) {
+        shared_function.reset();
+        shared_pljit.reset();
+    }
+}
+BENCHMARK(BM_PljitFunctionHandleMultiThreaded)
+    ->ArgNames({ "statements", "depth", "variables", "mode" })
+    ->Args({ 128, 4, 16, static_cast<int>(ExecutionMode::BYTECODE) })
+    ->Args({ 128, 4, 16, static_cast<int>(ExecutionMode::NATIVE) })
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+/// Shared between the threads of `BM_PljitLookup`. Set up and torn down by thread 0.
+static std::unique_ptr<Pljit> lookup_pljit;
+
+/**
+ * Looks up functions by name in a registry holding `functions` named functions.
+ */
+static void BM_PljitLookup(benchmark::State& state) {
+    auto function_count = static_cast<std::size_t>(state.range(0));
+    if (state.thread_index == 0) {
+        lookup_pljit = std::make_unique<Pljit>();
+        for (std::size_t index = 0; index < function_count; ++index) {
+            lookup_pljit->registerNamedFunction("rule" + std::to_string(index), "BEGIN RETURN 1 END.");
+        }
+    }
+
+    std::vector<std::string> names;
+    for (std::size_t index = state.thread_index; index < function_count; index += 997) {
+        names.push_back("rule" + std::to_string(index));
+    }
+
+    std::size_t next = 0;
+    for (auto _: state) {
+        std::optional<PljitFunctionHandle> handle = lookup_pljit->lookup(names[next]);
+        benchmark::DoNotOptimize(handle);
+        next = next + 1 == names.size() ? 0 : next + 1;
+    }
+
+    if (state.thread_index == 0) {
+        lookup_pljit.reset();
+    }
+}
+BENCHMARK(BM_PljitLookup)
+    ->ArgName("functions")
+    ->Arg(1 << 10)
+    ->Arg(1 << 20)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+//---------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./utils/benchmark_utils.hpp"
+#include "pljit/bytecode/BatchKernels.hpp"
+#include "pljit/bytecode/BytecodeCompiler.hpp"
+#include <vector>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::bench;
+using namespace pljit::bytecode;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+constexpr std::size_t ROWS = BytecodeFunction::BATCH_CHUNK_SIZE;
+
+void KernelSets(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({ "kernels" });
+    for (auto kernel_set: { KernelSet::SCALAR, KernelSet::AVX2, KernelSet::AVX512 }) {
+        benchmark->Arg(static_cast<int>(kernel_set));
+    }
+}
+
+/**
+ * @return Returns the `BatchKernels` selected by the first argument, nullptr if the CPU doesn't support them.
+ */
+const BatchKernels* kernelsOf(benchmark::State& state) {
+    auto kernel_set = static_cast<KernelSet>(state.range(0));
+    if (!BatchKernels::isSupported(kernel_set)) {
+        state.SkipWithError("KernelSet isn't supported by the CPU!");
+        return nullptr;
+    }
+    return &BatchKernels::get(kernel_set);
+}
+
+/**
+ * Register columns of a single chunk. The right hand side never contains zero.
+ */
+struct Columns {
+    std::vector<long long> target = std::vector<long long>(ROWS);
+    std::vector<long long> lhs = std::vector<long long>(ROWS);
+    std::vector<long long> rhs = std::vector<long long>(ROWS);
+    std::vector<unsigned char> failed = std::vector<unsigned char>(ROWS);
+
+    Columns() {
+        for (std::size_t row = 0; row < ROWS; ++row) {
+            lhs[row] = static_cast<long long>(row * 7919) - 1000000;
+            rhs[row] = static_cast<long long>(row % 13) + 1;
+        }
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+template <BatchKernels::BinaryKernel BatchKernels::*kernel>
+static void BM_BinaryKernel(benchmark::State& state) {
+    const BatchKernels* kernels = kernelsOf(state);
+    if (!kernels) {
+        return;
+    }
+    Columns columns;
+
+    for (auto _: state) {
+        (kernels->*kernel)(columns.target.data(), columns.lhs.data(), columns.rhs.data(), ROWS);
+        benchmark::DoNotOptimize(columns.target.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ROWS));
+}
+BENCHMARK_TEMPLATE(BM_BinaryKernel, &BatchKernels::add)->Apply(KernelSets);
+BENCHMARK_TEMPLATE(BM_BinaryKernel, &BatchKernels::multiply)->Apply(KernelSets);
+
+static void BM_DivideKernel(benchmark::State& state) {
+    const BatchKernels* kernels = kernelsOf(state);
+    if (!kernels) {
+        return;
+    }
+    Columns columns;
+
+    for (auto _: state) {
+        kernels->divide(columns.target.data(), columns.lhs.data(), columns.rhs.data(), columns.failed.data(), ROWS);
+        benchmark::DoNotOptimize(columns.target.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ROWS));
+}
+BENCHMARK(BM_DivideKernel)->Apply(KernelSets);
+
+static void BM_DivideConstantKernel(benchmark::State& state) {
+    const BatchKernels* kernels = kernelsOf(state);
+    if (!kernels) {
+        return;
+    }
+    Columns columns;
+    auto divisor = ConstantDivisor::create(7);
+
+    for (auto _: state) {
+        kernels->divideConstant(columns.target.data(), columns.lhs.data(), *divisor, ROWS);
+        benchmark::DoNotOptimize(columns.target.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ROWS));
+}
+BENCHMARK(BM_DivideConstantKernel)->Apply(KernelSets);
+
+static void BM_BytecodeBatch(benchmark::State& state) {
+    const BatchKernels* kernels = kernelsOf(state);
+    if (!kernels) {
+        return;
+    }
+
+    ProgramGenerator generator;
+    code::SourceCodeManagement management{ generator.generate(ProgramShape{ .statements = 128, .expression_depth = 4, .variables = 16 }) };
+    ast::Function function = buildAST(management);
+    BytecodeFunction bytecode = BytecodeCompiler{}.compile(function);
+
+    constexpr std::size_t rows = 1 << 14;
+    std::vector<std::vector<long long>> columns;
+    for (long long argument: ProgramGenerator::arguments()) {
+        std::vector<long long>& column = columns.emplace_back(rows);
+        for (std::size_t row = 0; row < rows; ++row) {
+            column[row] = argument - static_cast<long long>(row % 64);
+        }
+    }
+    std::vector<std::span<const long long>> column_spans{ columns.begin(), columns.end() };
+    std::vector<long long> output(rows);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+
+    for (auto _: state) {
+        RuntimeErrorCode error = bytecode.evaluateBatch(column_spans, output, errors, *kernels);
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+}
+BENCHMARK(BM_BytecodeBatch)->Apply(KernelSets);
+//---------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./ProgramGenerator.hpp"
+#include <algorithm>
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Upper bound for the absolute value of every generated (sub-)expression.
+constexpr std::uint64_t VALUE_LIMIT = std::uint64_t{ 1 } << 40;
+
+/// Identifiers may only consist of letters, thus we encode the index in base 26.
+std::string identifier(char prefix, unsigned index) {
+    std::string name(1, prefix);
+    do {
+        name += static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    return name;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+ProgramGenerator::ProgramGenerator(std::uint64_t seed) : random(seed) {}
+
+std::string ProgramGenerator::generate(const ProgramShape& shape) {
+    assert((shape.statements == 0 || shape.variables > 0) && "Assignments require at least one variable!");
+    initialized.clear();
+
+    std::string source = "PARAM ";
+    for (unsigned index = 0; index < PARAMETER_COUNT; ++index) {
+        std::string name = identifier('p', index);
+        source += (index ? ", " : "") + name;
+        initialized.emplace_back(name, ARGUMENT_BOUND);
+    }
+    source += ";\n";
+
+    if (shape.variables > 0) {
+        source += "VAR ";
+        for (unsigned index = 0; index < shape.variables; ++index) {
+            source += (index ? ", " : "") + identifier('v', index);
+        }
+        source += ";\n";
+    }
+
+    source += "CONST ";
+    for (unsigned index = 0; index < 3; ++index) {
+        std::string name = identifier('k', index);
+        std::uint64_t value = random() % 100 + 1;
+        source += (index ? ", " : "") + name + " = " + std::to_string(value);
+        initialized.emplace_back(name, value);
+    }
+    source += ";\nBEGIN\n";
+
+    for (unsigned index = 0; index < shape.statements; ++index) {
+        unsigned variable = index % shape.variables;
+        std::string name = identifier('v', variable);
+
+        source += "  " + name + " := ";
+        std::uint64_t bound = generateExpression(source, shape.expression_depth);
+        source += ";\n";
+
+        if (index < shape.variables) {
+            initialized.emplace_back(name, bound);
+        } else {
+            // the i-th variable was initialized as the (PARAMETER_COUNT + 3 + i)-th identifier
+            auto& entry = initialized[PARAMETER_COUNT + 3 + variable];
+            entry.second = std::max(entry.second, bound);
+        }
+    }
+
+    source += "  RETURN ";
+    generateExpression(source, shape.expression_depth);
+    source += "\nEND.";
+
+    return source;
+}
+
+std::vector<long long> ProgramGenerator::arguments() {
+    std::vector<long long> arguments;
+    for (unsigned index = 0; index < PARAMETER_COUNT; ++index) {
+        arguments.push_back(static_cast<long long>(ARGUMENT_BOUND) - 7 * index);
+    }
+    return arguments;
+}
+
+std::uint64_t ProgramGenerator::generateExpression(std::string& output, unsigned depth) {
+    if (depth == 0 || random() % 10 == 0) {
+        return generateLeaf(output);
+    }
+
+    if (random() % 8 == 0) {
+        output += "-(";
+        std::uint64_t bound = generateExpression(output, depth - 1);
+        output += ")";
+        return bound;
+    }
+
+    output += "(";
+    std::uint64_t lhs = generateExpression(output, depth - 1);
+
+    // decide on the operator once the bound of the left operand is known
+    // and fall back to a division by a literal if the result could exceed the `VALUE_LIMIT`.
+    switch (random() % 4) {
+        case 0:
+        case 1: {
+            std::string rhs_source;
+            std::uint64_t rhs = generateExpression(rhs_source, depth - 1);
+            if (lhs + rhs <= VALUE_LIMIT) {
+                output += (random() % 2 ? " + " : " - ") + rhs_source + ")";
+                return lhs + rhs;
+            }
+            break;
+        }
+        case 2: {
+            std::string rhs_source;
+            std::uint64_t rhs = generateExpression(rhs_source, depth - 1);
+            if (rhs == 0 || lhs <= VALUE_LIMIT / rhs) {
+                output += " * " + rhs_source + ")";
+                return lhs * rhs;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    output += " / " + std::to_string(random() % 8 + 2) + ")";
+    return lhs;
+}
+
+std::uint64_t ProgramGenerator::generateLeaf(std::string& output) {
+    if (random() % 4 == 0) {
+        std::uint64_t value = random() % 100;
+        output += std::to_string(value);
+        return value;
+    }
+
+    auto& [name, bound] = initialized[random() % initialized.size()];
+    output += name;
+    return bound;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_PROGRAMGENERATOR_HPP
+#define PLJIT_PROGRAMGENERATOR_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+/**
+ * Describes the size of a generated program.
+ */
+struct ProgramShape {
+    /// Number of assignment statements (the program additionally ends with a RETURN statement).
+    unsigned statements;
+    /// Maximum nesting depth of every expression tree.
+    unsigned expression_depth;
+    /// Number of declared VAR identifiers.
+    unsigned variables;
+};
+//---------------------------------------------------------------------------
+/**
+ * Generates syntactically and semantically valid programs of a configurable size.
+ * Generation is deterministic for a given seed.
+ *
+ * Every intermediate value is bounded (assuming the arguments are bounded by `ARGUMENT_BOUND`),
+ * such that evaluation never overflows and never divides by zero.
+ */
+class ProgramGenerator {
+    std::mt19937_64 random;
+
+    /// Names of all currently initialized identifiers together with a bound of their absolute value.
+    std::vector<std::pair<std::string, std::uint64_t>> initialized;
+
+    public:
+    /// Number of PARAM identifiers of every generated program.
+    static constexpr unsigned PARAMETER_COUNT = 3;
+    /// Absolute bound of the arguments passed to generated programs.
+    static constexpr std::uint64_t ARGUMENT_BOUND = 1000;
+
+    explicit ProgramGenerator(std::uint64_t seed = 42);
+
+    /**
+     * Generates a program of the given shape.
+     * @return Returns the source code of the program.
+     */
+    std::string generate(const ProgramShape& shape);
+
+    /**
+     * @return Returns `PARAMETER_COUNT` arguments within `ARGUMENT_BOUND`, suitable to call generated programs.
+     */
+    static std::vector<long long> arguments();
+
+    private:
+    /**
+     * Appends a random expression to `output`.
+     * @return Returns a bound of the absolute value of the expression.
+     */
+    std::uint64_t generateExpression(std::string& output, unsigned depth);
+    std::uint64_t generateLeaf(std::string& output);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_PROGRAMGENERATOR_HPP
@@ -0,0 +1,59 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_BENCHMARK_UTILS_HPP
+#define PLJIT_BENCHMARK_UTILS_HPP
+
+#include "./ProgramGenerator.hpp"
+#include "pljit/ast/AST.hpp"
+#include "pljit/ast/ASTBuilder.hpp"
+#include "pljit/code/SourceCodeManagement.hpp"
+#include "pljit/lex/Lexer.hpp"
+#include "pljit/parse/Parser.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+/**
+ * Registers the default set of program sizes as benchmark arguments.
+ * Use together with `shapeOf` to retrieve the `ProgramShape` of the current run.
+ */
+inline void ProgramShapes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({ "statements", "depth", "variables" });
+    benchmark->Args({ 16, 3, 4 });
+    benchmark->Args({ 128, 4, 16 });
+    benchmark->Args({ 1024, 5, 64 });
+}
+
+inline ProgramShape shapeOf(const benchmark::State& state) {
+    return ProgramShape{
+        .statements = static_cast<unsigned>(state.range(0)),
+        .expression_depth = static_cast<unsigned>(state.range(1)),
+        .variables = static_cast<unsigned>(state.range(2)),
+    };
+}
+
+/**
+ * Runs all compiler phases up to the AST. Generated programs are expected to be valid.
+ */
+inline ast::Function buildAST(const code::SourceCodeManagement& management) {
+    lex::Lexer lexer{ management };
+    parse::Parser parser{ lexer };
+
+    Result<parse::FunctionDefinition> program = parser.parse_program();
+    assert(program.isSuccess() && "Generated program failed to parse!");
+
+    ast::ASTBuilder builder;
+    Result<ast::Function> function = builder.analyzeFunction(*program);
+    assert(function.isSuccess() && "Generated program failed semantic analysis!");
+
+    return function.release();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_BENCHMARK_UTILS_HPP
@@ -10,5 +10,6 @@ include(EnableAddressSanitizer)
 include(EnableUndefinedSanitizer)
 include(clang-tidy)
 include(BundledGTest)
+include(BundledBenchmark)
 
 add_custom_target(lint)
@@ -0,0 +1,195 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./CodeCache.hpp"
+#include "./bytecode/BytecodeSerializer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <span>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+constexpr std::array<char, 8> MAGIC{ 'P', 'L', 'J', 'I', 'T', 'B', 'C', '\n' };
+
+/**
+ * The header of every cache entry. Written field by field, thus independent of padding.
+ */
+struct EntryHeader {
+    std::uint32_t format_version;
+    std::uint32_t compiler_version;
+    std::uint32_t optimization_level;
+    std::uint64_t source_hash;
+    std::uint64_t source_length;
+
+    static constexpr std::size_t SIZE = MAGIC.size() + 3 * 4 + 2 * 8;
+
+    bool operator==(const EntryHeader& other) const = default;
+};
+
+EntryHeader headerOf(std::string_view source_code, OptimizationLevel optimization_level) {
+    return EntryHeader{
+        .format_version = bytecode::BytecodeSerializer::FORMAT_VERSION,
+        .compiler_version = CodeCache::COMPILER_VERSION,
+        .optimization_level = static_cast<std::uint32_t>(optimization_level),
+        .source_hash = CodeCache::hash(source_code),
+        .source_length = source_code.size(),
+    };
+}
+
+void append(std::vector<std::uint8_t>& data, std::uint64_t value, unsigned bytes) {
+    for (unsigned index = 0; index < bytes; ++index) {
+        data.push_back(static_cast<std::uint8_t>(value >> (8 * index)));
+    }
+}
+
+std::uint64_t extract(std::span<const std::uint8_t> data, std::size_t offset, unsigned bytes) {
+    std::uint64_t value = 0;
+    for (unsigned index = 0; index < bytes; ++index) {
+        value |= std::uint64_t{ data[offset + index] } << (8 * index);
+    }
+    return value;
+}
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+    void* memory = MAP_FAILED; // NOLINT(performance-no-int-to-ptr)
+    std::size_t size = 0;
+
+    public:
+    explicit MappedFile(const std::filesystem::path& path) {
+        int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (descriptor < 0) {
+            return;
+        }
+
+        struct stat status {};
+        if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            size = static_cast<std::size_t>(status.st_size);
+            memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+        close(descriptor);
+    }
+    ~MappedFile() {
+        if (memory != MAP_FAILED) { // NOLINT(performance-no-int-to-ptr)
+            munmap(memory, size);
+        }
+    }
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    std::optional<std::span<const std::uint8_t>> data() const {
+        if (memory == MAP_FAILED) { // NOLINT(performance-no-int-to-ptr)
+            return {};
+        }
+        return std::span{ static_cast<const std::uint8_t*>(memory), size };
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+CodeCache::CodeCache(std::filesystem::path directory) : directory(std::move(directory)) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+}
+
+std::optional<bytecode::BytecodeFunction> CodeCache::load(const code::SourceCodeManagement& source_code, OptimizationLevel optimization_level) const {
+    MappedFile file{ entryPath(source_code.content(), optimization_level) };
+    auto data = file.data();
+    if (!data || data->size() < EntryHeader::SIZE || std::memcmp(data->data(), MAGIC.data(), MAGIC.size()) != 0) {
+        return {};
+    }
+
+    std::size_t offset = MAGIC.size();
+    EntryHeader header{
+        .format_version = static_cast<std::uint32_t>(extract(*data, offset, 4)),
+        .compiler_version = static_cast<std::uint32_t>(extract(*data, offset + 4, 4)),
+        .optimization_level = static_cast<std::uint32_t>(extract(*data, offset + 8, 4)),
+        .source_hash = extract(*data, offset + 12, 8),
+        .source_length = extract(*data, offset + 20, 8),
+    };
+    if (header != headerOf(source_code.content(), optimization_level)) {
+        return {};
+    }
+
+    // FNV-1a isn't collision resistant, another source code of the same length might share the hash
+    std::string_view content = source_code.content();
+    if (data->size() - EntryHeader::SIZE < content.size() || std::memcmp(data->data() + EntryHeader::SIZE, content.data(), content.size()) != 0) {
+        return {};
+    }
+
+    return bytecode::BytecodeSerializer::deserialize(data->subspan(EntryHeader::SIZE + content.size()), source_code);
+}
+
+bool CodeCache::store(const code::SourceCodeManagement& source_code, OptimizationLevel optimization_level, const bytecode::BytecodeFunction& function) const {
+    EntryHeader header = headerOf(source_code.content(), optimization_level);
+
+    std::vector<std::uint8_t> data{ MAGIC.begin(), MAGIC.end() };
+    append(data, header.format_version, 4);
+    append(data, header.compiler_version, 4);
+    append(data, header.optimization_level, 4);
+    append(data, header.source_hash, 8);
+    append(data, header.source_length, 8);
+    data.insert(data.end(), source_code.content().begin(), source_code.content().end());
+
+    std::vector<std::uint8_t> payload = bytecode::BytecodeSerializer::serialize(function, source_code);
+    data.insert(data.end(), payload.begin(), payload.end());
+
+    // unique within this process (counter) and across processes (pid)
+    static std::atomic<unsigned> temporary_counter{ 0 };
+    std::filesystem::path path = entryPath(source_code.content(), optimization_level);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp." + std::to_string(getpid()) + "." + std::to_string(temporary_counter++);
+
+    {
+        std::ofstream stream{ temporary, std::ios::binary | std::ios::trunc };
+        stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!stream) {
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path CodeCache::entryPath(std::string_view source_code, OptimizationLevel optimization_level) const {
+    std::array<char, 64> name{};
+    std::snprintf(name.data(), name.size(), "%016llx-O%u-v%u.pljitbc", // NOLINT(cppcoreguidelines-pro-type-vararg)
+                  static_cast<unsigned long long>(hash(source_code)),
+                  static_cast<unsigned>(optimization_level),
+                  COMPILER_VERSION);
+    return directory / name.data();
+}
+
+std::uint64_t CodeCache::hash(std::string_view source_code) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char character: source_code) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
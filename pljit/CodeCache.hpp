@@ -0,0 +1,70 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_CODECACHE_HPP
+#define PLJIT_CODECACHE_HPP
+
+#include "./CompileOptions.hpp"
+#include "./bytecode/Bytecode.hpp"
+#include "./code/SourceCodeManagement.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * A persistent cache of lowered functions within a directory, so that a restarted process
+ * doesn't have to lex, parse and analyze every function again.
+ *
+ * Every entry is a file named after the FNV-1a hash of the source code, the `OptimizationLevel`
+ * and the `COMPILER_VERSION`. It starts with a header repeating these values and the length of the
+ * source code, followed by the source code itself, which is compared on load as hashes might collide,
+ * and the function serialized by the `bytecode::BytecodeSerializer`.
+ * Entries are loaded using mmap. Entries which fail validation are treated as cache miss.
+ * Functions failing to compile aren't cached.
+ */
+class CodeCache {
+    std::filesystem::path directory;
+
+    public:
+    /// Version of the compiler. Must be increased whenever the bytecode emitted for a source code changes
+    /// (e.g. by new optimization passes), which invalidates all existing entries.
+    static constexpr std::uint32_t COMPILER_VERSION = 2;
+
+    /**
+     * @param directory The cache directory. Created if it doesn't exist yet.
+     */
+    explicit CodeCache(std::filesystem::path directory);
+
+    /**
+     * Loads the cached function of the given source code.
+     * @return Returns the `BytecodeFunction` referencing the given source code, empty on a cache miss.
+     */
+    std::optional<bytecode::BytecodeFunction> load(const code::SourceCodeManagement& source_code, OptimizationLevel optimization_level) const;
+
+    /**
+     * Stores the function compiled from the given source code. The entry is written to a temporary file first
+     * and atomically renamed, such that concurrent readers never observe partially written entries.
+     * @return Returns true if the entry was written.
+     */
+    bool store(const code::SourceCodeManagement& source_code, OptimizationLevel optimization_level, const bytecode::BytecodeFunction& function) const;
+
+    /**
+     * @return Returns the path of the entry for the given source code.
+     */
+    std::filesystem::path entryPath(std::string_view source_code, OptimizationLevel optimization_level) const;
+
+    /**
+     * @return Returns the 64 bit FNV-1a hash of the given source code.
+     */
+    static std::uint64_t hash(std::string_view source_code);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_CODECACHE_HPP
@@ -0,0 +1,104 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./CompileCache.hpp"
+#include <cassert>
+#include <cctype>
+#include <functional>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+bool isWhitespace(char character) {
+    // matches the whitespace skipped by the Lexer
+    return character == ' ' || character == '\n' || character == '\t';
+}
+
+/**
+ * @return Returns true if removing the whitespace between the two characters would join two tokens.
+ */
+bool joinsTokens(char previous, char next) {
+    auto isWordCharacter = [](char character) {
+        return std::isalnum(static_cast<unsigned char>(character)) != 0;
+    };
+    return (isWordCharacter(previous) && isWordCharacter(next)) || (previous == ':' && next == '=');
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+std::size_t CompileCache::KeyHash::operator()(const Key& key) const {
+    std::size_t hash = std::hash<std::string>{}(key.normalized_source);
+    hash ^= static_cast<std::size_t>(key.execution_mode) * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::size_t>(key.optimization_level) * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+//---------------------------------------------------------------------------
+CompileCache::CompileCache(CompileCacheMode mode, const CodeCache* code_cache) : mode(mode), code_cache(code_cache) {
+    assert(mode != CompileCacheMode::DISABLED && "Can't construct a disabled CompileCache!");
+}
+
+std::shared_ptr<const CompiledFunction> CompileCache::lookup(std::string&& source_code, ExecutionMode execution_mode, OptimizationLevel optimization_level) {
+    Key key{ normalize(source_code, mode), execution_mode, optimization_level };
+
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard lock{ entries_mutex };
+        auto& slot = entries[std::move(key)];
+        if (!slot) {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+
+    // compiling outside the lock, so distinct sources are compiled in parallel
+    std::call_once(entry->compiled, [&]() {
+        entry->function = CompiledFunction::compile(std::move(source_code), execution_mode, optimization_level, code_cache);
+        entry->ready.store(true, std::memory_order_release);
+    });
+    return entry->function;
+}
+
+std::size_t CompileCache::evictUnreferenced() {
+    std::lock_guard lock{ entries_mutex };
+    return std::erase_if(entries, [](const auto& element) {
+        const std::shared_ptr<Entry>& entry = element.second;
+        // entries held by a lookup in progress or still compiling are kept
+        return entry.use_count() == 1 && entry->ready.load(std::memory_order_acquire) && entry->function.use_count() == 1;
+    });
+}
+
+std::size_t CompileCache::size() {
+    std::lock_guard lock{ entries_mutex };
+    return entries.size();
+}
+
+std::string CompileCache::normalize(std::string_view source_code, CompileCacheMode mode) {
+    if (mode != CompileCacheMode::IGNORE_WHITESPACE) {
+        return std::string{ source_code };
+    }
+
+    std::string normalized;
+    normalized.reserve(source_code.size());
+
+    bool pending_whitespace = false;
+    for (char character: source_code) {
+        if (isWhitespace(character)) {
+            pending_whitespace = true;
+            continue;
+        }
+
+        if (pending_whitespace && !normalized.empty() && joinsTokens(normalized.back(), character)) {
+            normalized.push_back(' ');
+        }
+        pending_whitespace = false;
+        normalized.push_back(character);
+    }
+
+    return normalized;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
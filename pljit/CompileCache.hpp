@@ -0,0 +1,85 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_COMPILECACHE_HPP
+#define PLJIT_COMPILECACHE_HPP
+
+#include "./CompileOptions.hpp"
+#include "./CompiledFunction.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Deduplicates compilations of identical source code. Every distinct (normalized) source code is compiled
+ * once per `ExecutionMode` and `OptimizationLevel`, all registrations share the resulting `CompiledFunction`.
+ * Thread-safe. Concurrent lookups of the same source code wait for a single compilation.
+ */
+class CompileCache {
+    struct Key {
+        std::string normalized_source;
+        ExecutionMode execution_mode;
+        OptimizationLevel optimization_level;
+
+        bool operator==(const Key& other) const = default;
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+        std::once_flag compiled;
+        std::shared_ptr<const CompiledFunction> function;
+        /// Set once `function` was assigned.
+        std::atomic<bool> ready{ false };
+    };
+
+    CompileCacheMode mode;
+    /// Used to load and store compilations across process restarts. Might be null.
+    const CodeCache* code_cache;
+
+    std::mutex entries_mutex;
+    std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash> entries;
+
+    public:
+    /**
+     * @param mode How source code is normalized before comparison. Must not be `CompileCacheMode::DISABLED`.
+     * @param code_cache The `CodeCache` used for compilations, might be null.
+     */
+    explicit CompileCache(CompileCacheMode mode, const CodeCache* code_cache = nullptr);
+
+    /**
+     * Returns the `CompiledFunction` of the given source code, compiling it if it isn't cached yet.
+     * @param source_code The source code, moved into the `CompiledFunction` if it is compiled.
+     */
+    std::shared_ptr<const CompiledFunction> lookup(std::string&& source_code, ExecutionMode execution_mode, OptimizationLevel optimization_level);
+
+    /**
+     * Drops the compilations which are referenced by the cache only, e.g. as the functions using them were freed.
+     * Bounds the size of the cache if functions are continuously replaced with new source code.
+     * @return Returns the number of dropped compilations.
+     */
+    std::size_t evictUnreferenced();
+
+    /**
+     * @return Returns the number of distinct compilations.
+     */
+    std::size_t size();
+
+    /**
+     * Normalizes the given source code according to `mode`. With `CompileCacheMode::IGNORE_WHITESPACE`,
+     * whitespace skipped by the `Lexer` is removed, except a single space where it separates two tokens.
+     */
+    static std::string normalize(std::string_view source_code, CompileCacheMode mode);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_COMPILECACHE_HPP
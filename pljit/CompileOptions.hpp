@@ -0,0 +1,123 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_COMPILEOPTIONS_HPP
+#define PLJIT_COMPILEOPTIONS_HPP
+
+#include "./EvaluationResult.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Describes how a compiled function is executed.
+ */
+enum class ExecutionMode {
+    /// The function is evaluated by walking the AST. Serves as the reference implementation.
+    AST_INTERPRETER,
+    /// The AST is lowered into a flat bytecode array which is executed by the bytecode VM.
+    BYTECODE,
+    /// The bytecode is translated into x86-64 machine code. Falls back to BYTECODE on unsupported platforms.
+    NATIVE,
+};
+//---------------------------------------------------------------------------
+/**
+ * Describes which optimizations are run on the AST before it is executed or lowered.
+ */
+enum class OptimizationLevel {
+    /// No optimizations.
+    O0,
+    /// A single run of the default pipeline.
+    O1,
+    /// The default pipeline, followed by common subexpression elimination, is repeated till no pass changes the
+    /// function anymore.
+    O2,
+};
+//---------------------------------------------------------------------------
+/**
+ * Describes when a registered function is compiled.
+ */
+enum class CompilationMode {
+    /// The function is compiled by the first caller evaluating it.
+    LAZY,
+    /// Compilation starts on registration. It is enqueued on the compile thread pool of the `Pljit` instance
+    /// if present, otherwise the function is compiled before `registerFunction` returns.
+    EAGER,
+};
+//---------------------------------------------------------------------------
+/**
+ * Describes if and how a `Pljit` instance shares compilations between registrations of the same source code.
+ */
+enum class CompileCacheMode {
+    /// Every registered function is compiled separately.
+    DISABLED,
+    /// Registrations of byte-identical source code share one compilation.
+    EXACT,
+    /// Registrations which only differ in whitespace skipped by the `Lexer` share one compilation.
+    /// Source code references of compilation and runtime errors then point into the first registered source code.
+    IGNORE_WHITESPACE,
+};
+//---------------------------------------------------------------------------
+/**
+ * Called with the failed `EvaluationResult` whenever the evaluation of a function
+ * through `PljitFunctionHandle::operator()` raises a runtime error.
+ */
+using RuntimeErrorHandler = std::function<void(const EvaluationResult&)>;
+//---------------------------------------------------------------------------
+/**
+ * Options which control how a registered function is compiled and executed.
+ */
+struct CompileOptions {
+    /// The `ExecutionMode` used to evaluate the function.
+    ExecutionMode execution_mode = ExecutionMode::NATIVE;
+    /// The `OptimizationLevel` used to optimize the AST.
+    OptimizationLevel optimization_level = OptimizationLevel::O2;
+    /// The `CompilationMode` deciding when the function is compiled.
+    CompilationMode compilation_mode = CompilationMode::LAZY;
+    /// Reports runtime errors of `PljitFunctionHandle::operator()`. Errors aren't reported at all if empty.
+    RuntimeErrorHandler runtime_error_handler = printRuntimeError;
+    /// Enables tiered execution if non-zero: the function is first compiled for the cheap baseline tier and promoted
+    /// to the `execution_mode` and `optimization_level` once it was called this many times. The optimized tier is
+    /// compiled on the compile thread pool of the `Pljit` instance, or on a new thread if there is none.
+    std::uint64_t tier_up_threshold = 0;
+    /// The `ExecutionMode` of the baseline tier.
+    ExecutionMode baseline_execution_mode = ExecutionMode::AST_INTERPRETER;
+    /// The `OptimizationLevel` of the baseline tier.
+    OptimizationLevel baseline_optimization_level = OptimizationLevel::O0;
+    /// Enables value profiling if non-zero: the arguments of this many calls are sampled. Parameters which received
+    /// the same value in almost all of them are speculated to keep it. The function is then recompiled with these
+    /// parameters folded, which is evaluated by every call passing a guard checking the arguments. Other calls
+    /// evaluate the generic version. The speculative version is dropped if the guard keeps missing.
+    /// Compiled like the optimized tier. Batch evaluations are neither profiled nor guarded.
+    std::uint64_t value_profile_calls = 0;
+    /// Enables memoization if non-zero: the results of calls, including runtime errors, are cached by their arguments
+    /// and the cache occupies at most this many bytes. Once full, results which weren't hit recently are evicted.
+    /// Memoization is disabled if the limit doesn't fit a single result. Batch evaluations aren't memoized.
+    std::size_t memoization_memory_limit = 0;
+};
+//---------------------------------------------------------------------------
+/**
+ * Options which apply to all functions of a `Pljit` instance.
+ */
+struct PljitOptions {
+    /// The number of background threads used to compile functions registered with `CompilationMode::EAGER`
+    /// or through `compileAsync()`. No thread is started if zero.
+    std::size_t compile_threads = 0;
+    /// The `CompileCacheMode` used to deduplicate compilations of the same source code.
+    CompileCacheMode compile_cache_mode = CompileCacheMode::EXACT;
+    /// Directory of the persistent `CodeCache`, so that restarted processes skip compiling functions
+    /// compiled before. The code cache is disabled if empty.
+    std::filesystem::path code_cache_directory = {};
+    /// The maximum number of specializations created through `Pljit::specialize` which are kept alive.
+    /// Once exceeded, the least recently requested specialization is unregistered. Must not be zero.
+    std::size_t specialization_cache_size = 64;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_COMPILEOPTIONS_HPP
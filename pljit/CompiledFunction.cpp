@@ -0,0 +1,132 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./CompiledFunction.hpp"
+#include "./ast/ASTParser.hpp"
+#include "./bytecode/BytecodeCompiler.hpp"
+#include "./native/NativeCompiler.hpp"
+#include "./lex/Lexer.hpp"
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+CompiledFunction::CompiledFunction(
+    std::string&& source_code,
+    ExecutionMode execution_mode,
+    OptimizationLevel optimization_level,
+    const CodeCache* code_cache,
+    std::span<const std::optional<long long>> parameter_bindings,
+    std::span<const std::optional<long long>> assumed_parameters)
+    : source_code(std::move(source_code)), loaded_from_code_cache(false) {
+    if (execution_mode == ExecutionMode::AST_INTERPRETER || !parameter_bindings.empty() || !assumed_parameters.empty()) {
+        // the code cache only holds the lowered form of the unmodified source code
+        code_cache = nullptr;
+    }
+
+    if (code_cache) {
+        bytecode = code_cache->load(this->source_code, optimization_level);
+        loaded_from_code_cache = bytecode.has_value();
+    }
+
+    if (!bytecode) {
+        lex::Lexer lexer{this->source_code};
+        // the parse tree is only required for visualization, build the AST straight away
+        ast::ASTParser parser{lexer};
+
+        Result<ast::Function> func = parser.parseFunction();
+        if (!func) {
+            compilation_error_val = func.error();
+            return;
+        }
+
+        function = func.release();
+
+        if (!parameter_bindings.empty()) {
+            std::size_t parameters = function->getParamDeclaration() ? function->getParamDeclaration()->getDeclaredIdentifiers().size() : 0;
+            function->bindParameters(parameter_bindings.first(std::min(parameter_bindings.size(), parameters)));
+        }
+        if (!assumed_parameters.empty()) {
+            std::size_t parameters = function->getParamDeclaration() ? function->getParamDeclaration()->getDeclaredIdentifiers().size() : 0;
+            function->assumeParameters(assumed_parameters.first(std::min(assumed_parameters.size(), parameters)));
+        }
+
+        ast::optimize::PassManager passManager = ast::optimize::PassManager::forLevel(optimization_level);
+        passManager.run(*function);
+        optimization_statistics_val = passManager.getStatistics();
+
+        if (execution_mode != ExecutionMode::AST_INTERPRETER) {
+            bytecode::BytecodeCompiler compiler;
+            bytecode = compiler.compile(*function);
+
+            if (code_cache) {
+                code_cache->store(this->source_code, optimization_level, *bytecode);
+            }
+        }
+    }
+
+    if (execution_mode == ExecutionMode::NATIVE) {
+        // stays empty if native code generation isn't available, we then interpret the bytecode.
+        native::NativeCompiler compiler;
+        native_function = compiler.compile(*bytecode);
+    }
+}
+
+std::shared_ptr<const CompiledFunction> CompiledFunction::compile(
+    std::string&& source_code,
+    ExecutionMode execution_mode,
+    OptimizationLevel optimization_level,
+    const CodeCache* code_cache,
+    std::span<const std::optional<long long>> parameter_bindings,
+    std::span<const std::optional<long long>> assumed_parameters) {
+    // the constructor is private, thus we can't use `std::make_shared`
+    return std::shared_ptr<const CompiledFunction>{
+        new CompiledFunction(std::move(source_code), execution_mode, optimization_level, code_cache, parameter_bindings, assumed_parameters)
+    };
+}
+
+const code::SourceCodeManagement& CompiledFunction::getSourceCode() const {
+    return source_code;
+}
+
+std::shared_ptr<const code::SourceCodeManagement> CompiledFunction::shareSourceCode() const {
+    // aliasing constructor, the source code is owned by this function
+    return { shared_from_this(), &source_code };
+}
+
+const std::optional<ast::Function>& CompiledFunction::getFunction() const {
+    return function;
+}
+
+const std::optional<bytecode::BytecodeFunction>& CompiledFunction::getBytecode() const {
+    return bytecode;
+}
+
+const std::optional<native::NativeFunction>& CompiledFunction::getNativeFunction() const {
+    return native_function;
+}
+
+const std::optional<code::SourceCodeError>& CompiledFunction::compilation_error() const {
+    return compilation_error_val;
+}
+
+const std::vector<ast::optimize::PassStatistics>& CompiledFunction::optimization_statistics() const {
+    return optimization_statistics_val;
+}
+
+bool CompiledFunction::isLoadedFromCodeCache() const {
+    return loaded_from_code_cache;
+}
+
+std::size_t CompiledFunction::parameter_count() const {
+    if (bytecode) {
+        return bytecode->getParameterRegisters().size();
+    } else if (function && function->getParamDeclaration()) {
+        return function->getParamDeclaration()->getDeclaredIdentifiers().size();
+    }
+    return 0;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
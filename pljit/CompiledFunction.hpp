@@ -0,0 +1,101 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_COMPILEDFUNCTION_HPP
+#define PLJIT_COMPILEDFUNCTION_HPP
+
+#include "./CodeCache.hpp"
+#include "./CompileOptions.hpp"
+#include "./code/SourceCodeManagement.hpp"
+#include "./ast/AST.hpp"
+#include "./bytecode/Bytecode.hpp"
+#include "./native/NativeFunction.hpp"
+#include "./optimizations/PassManager.hpp"
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * The immutable result of compiling a source code: the AST (and its lowered forms, depending on the `ExecutionMode`)
+ * or the compilation error. As the AST references the source code it owns, it can't be copied or moved
+ * and is shared between all `PljitFunction`s registered with the same source code.
+ */
+class CompiledFunction : public std::enable_shared_from_this<CompiledFunction> {
+    /// Source code of the function.
+    code::SourceCodeManagement source_code;
+
+    /// The compiled AST. Present if no compilation error occurred.
+    std::optional<ast::Function> function;
+    /// The lowered bytecode. Present if no compilation error occurred and the `ExecutionMode` is BYTECODE or NATIVE.
+    std::optional<bytecode::BytecodeFunction> bytecode;
+    /// The generated machine code. Present if no compilation error occurred, the `ExecutionMode` is NATIVE
+    /// and the platform supports native code generation.
+    std::optional<native::NativeFunction> native_function;
+    /// A potential compilation error.
+    std::optional<code::SourceCodeError> compilation_error_val;
+    /// Statistics of the optimization passes run while compiling.
+    std::vector<ast::optimize::PassStatistics> optimization_statistics_val;
+    /// Whether the bytecode was loaded from a `CodeCache` instead of being compiled.
+    bool loaded_from_code_cache;
+
+    CompiledFunction(
+        std::string&& source_code,
+        ExecutionMode execution_mode,
+        OptimizationLevel optimization_level,
+        const CodeCache* code_cache,
+        std::span<const std::optional<long long>> parameter_bindings,
+        std::span<const std::optional<long long>> assumed_parameters
+    );
+
+    public:
+    CompiledFunction(const CompiledFunction& other) = delete;
+    CompiledFunction(CompiledFunction&& other) = delete;
+
+    /**
+     * Compiles the given source code.
+     * @param code_cache If present, the bytecode is loaded from this cache instead of being compiled
+     * (unless the `ExecutionMode` is AST_INTERPRETER). Newly compiled bytecode is stored to the cache.
+     * The AST and the optimization statistics aren't available for functions loaded from the cache.
+     * @param parameter_bindings Parameters turned into constants before optimizing, see `ast::Function::bindParameters`.
+     * Bindings beyond the declared parameters are ignored. The `code_cache` isn't used for functions with bound parameters.
+     * @param assumed_parameters Values of the remaining parameters the optimization passes may assume, see
+     * `ast::Function::assumeParameters`. The function must only be evaluated with matching arguments.
+     * @return Returns the `CompiledFunction` holding either the compiled function or the compilation error.
+     */
+    static std::shared_ptr<const CompiledFunction> compile(
+        std::string&& source_code,
+        ExecutionMode execution_mode,
+        OptimizationLevel optimization_level,
+        const CodeCache* code_cache = nullptr,
+        std::span<const std::optional<long long>> parameter_bindings = {},
+        std::span<const std::optional<long long>> assumed_parameters = {}
+    );
+
+    const code::SourceCodeManagement& getSourceCode() const;
+    /**
+     * @return Returns the source code, sharing the ownership of this function. Used to keep the references of results
+     * and errors handed out to callers valid, after the function itself was released.
+     */
+    std::shared_ptr<const code::SourceCodeManagement> shareSourceCode() const;
+    const std::optional<ast::Function>& getFunction() const;
+    const std::optional<bytecode::BytecodeFunction>& getBytecode() const;
+    const std::optional<native::NativeFunction>& getNativeFunction() const;
+
+    const std::optional<code::SourceCodeError>& compilation_error() const;
+    const std::vector<ast::optimize::PassStatistics>& optimization_statistics() const;
+    bool isLoadedFromCodeCache() const;
+    /**
+     * @return Returns the number of arguments the function expects. Zero if a compilation error occurred.
+     */
+    std::size_t parameter_count() const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_COMPILEDFUNCTION_HPP
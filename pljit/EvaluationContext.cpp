@@ -3,16 +3,41 @@
 //
 
 #include "EvaluationContext.hpp"
+#include <algorithm>
 #include <cassert>
 
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
-EvaluationContext::EvaluationContext(std::size_t symbols) : variables(symbols), return_val() {}
+EvaluationContext::EvaluationContext(std::size_t symbols)
+    : inline_variables(), heap_variables(), variable_count(0), return_val(), error_code(RuntimeErrorCode::NONE), error_reference() {
+    reset(symbols);
+}
+
+void EvaluationContext::reset(std::size_t symbols) {
+    variable_count = symbols;
+    return_val.reset();
+    error_code = RuntimeErrorCode::NONE;
+    error_reference = {};
+
+    if (symbols <= INLINE_CAPACITY) {
+        std::fill_n(inline_variables.begin(), symbols, 0);
+    } else {
+        // `assign` reuses the capacity of previous evaluations.
+        heap_variables.assign(symbols, 0);
+    }
+}
 
 long long& EvaluationContext::operator[](symbol_id symbolId) {
-    assert(symbolId > 0 && symbolId <= variables.size() && "Encountered illegal symbol id!");
-    return variables[symbolId - 1];
+    assert(symbolId > 0 && symbolId <= variable_count && "Encountered illegal symbol id!");
+    return variables()[symbolId - 1];
+}
+
+std::span<long long> EvaluationContext::variables() {
+    if (variable_count <= INLINE_CAPACITY) {
+        return { inline_variables.data(), variable_count };
+    }
+    return { heap_variables.data(), variable_count };
 }
 
 std::optional<long long>& EvaluationContext::return_value() {
@@ -20,11 +45,28 @@ std::optional<long long>& EvaluationContext::return_value() {
 }
 
 std::optional<std::string_view> EvaluationContext::runtime_error() const {
-    return runtime_error_message;
+    if (error_code == RuntimeErrorCode::NONE) {
+        return {};
+    }
+    return runtimeErrorMessage(error_code);
 }
 
-void EvaluationContext::setRuntimeError(const std::optional<std::string_view>& runtime_error) {
-    runtime_error_message = runtime_error;
+RuntimeErrorCode EvaluationContext::runtime_error_code() const {
+    return error_code;
+}
+
+void EvaluationContext::setRuntimeError(RuntimeErrorCode runtime_error, code::SourceCodeReference reference) {
+    error_code = runtime_error;
+    error_reference = reference;
+}
+
+EvaluationResult EvaluationContext::result() const {
+    if (error_code != RuntimeErrorCode::NONE) {
+        return EvaluationResult::failure(error_code, error_reference);
+    }
+
+    assert(return_val && "Evaluation neither returned a value nor failed!");
+    return EvaluationResult::success(*return_val);
 }
 //---------------------------------------------------------------------------
 } // namespace pljit
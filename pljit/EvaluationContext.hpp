@@ -5,8 +5,11 @@
 #ifndef PLJIT_EVALUATIONCONTEXT_HPP
 #define PLJIT_EVALUATIONCONTEXT_HPP
 
+#include "./EvaluationResult.hpp"
 #include "./symbol_id.hpp"
+#include <array>
 #include <optional>
+#include <span>
 #include <vector>
 #include <string_view>
 
@@ -16,18 +19,40 @@ namespace pljit {
 /**
  * The EvaluationContext is used to store contextual information within the
  * execution of a Function.
+ *
+ * Variables are stored inline for functions with up to `INLINE_CAPACITY` variables.
+ * Larger functions use heap storage, which is retained by `reset`, such that
+ * a reused context doesn't allocate in the steady state.
  */
 class EvaluationContext {
-    /// Values of allocated variables.
-    std::vector<long long> variables;
+    public:
+    /// The number of variables which are stored without any heap allocation.
+    static constexpr std::size_t INLINE_CAPACITY = 64;
+
+    private:
+    /// Values of allocated variables, if there are at most `INLINE_CAPACITY` variables.
+    std::array<long long, INLINE_CAPACITY> inline_variables;
+    /// Values of allocated variables, if there are more than `INLINE_CAPACITY` variables.
+    std::vector<long long> heap_variables;
+    /// The number of allocated variables.
+    std::size_t variable_count;
     /// The return value of a function if already evaluated.
     std::optional<long long> return_val;
 
-    /// Stores the error message of runtime errors
-    std::optional<std::string_view> runtime_error_message;
+    /// Stores the error code of runtime errors.
+    RuntimeErrorCode error_code;
+    /// The expression which caused the runtime error, if available.
+    code::SourceCodeReference error_reference;
 
     public:
-    explicit EvaluationContext(std::size_t symbols);
+    explicit EvaluationContext(std::size_t symbols = 0);
+
+    /**
+     * Prepares the context for a new evaluation. All variables are set to zero
+     * and the return value and runtime error are cleared.
+     * @param symbols The number of variables required by the evaluation.
+     */
+    void reset(std::size_t symbols);
 
     /**
      * Access the current value of a given variable.
@@ -36,6 +61,11 @@ class EvaluationContext {
      */
     long long& operator[](symbol_id symbolId);
 
+    /**
+     * @return Returns the storage of all variables. The variable with symbol id `n` is stored at index `n - 1`.
+     */
+    std::span<long long> variables();
+
     /**
      * @return Returns the return value if present. The value is present once
      * a Return statement was evaluated.
@@ -46,8 +76,22 @@ class EvaluationContext {
      * @return Returns the runtime error message if one occurred during execution.
      */
     std::optional<std::string_view> runtime_error() const;
+    /**
+     * @return Returns the `RuntimeErrorCode`. `RuntimeErrorCode::NONE` if no runtime error occurred.
+     */
+    RuntimeErrorCode runtime_error_code() const;
 
-    void setRuntimeError(const std::optional<std::string_view>& runtime_error);
+    /**
+     * Records a runtime error.
+     * @param runtime_error The `RuntimeErrorCode` describing the error.
+     * @param reference The expression which caused the error, if available.
+     */
+    void setRuntimeError(RuntimeErrorCode runtime_error, code::SourceCodeReference reference = {});
+
+    /**
+     * @return Returns the `EvaluationResult` for the return value or the runtime error of the context.
+     */
+    EvaluationResult result() const;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -0,0 +1,100 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./EvaluationResult.hpp"
+#include <cassert>
+#include <iostream>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+std::string_view runtimeErrorMessage(RuntimeErrorCode error_code) {
+    switch (error_code) {
+        case RuntimeErrorCode::NONE:
+            return {};
+        case RuntimeErrorCode::DIVISION_BY_ZERO:
+            return "Division by zero!";
+        case RuntimeErrorCode::TOO_MANY_ARGUMENTS:
+            return "Received to many arguments!";
+        case RuntimeErrorCode::TOO_FEW_ARGUMENTS:
+            return "Received to few arguments!";
+        case RuntimeErrorCode::UNEXPECTED_ARGUMENTS:
+            return "Provided arguments to function with missing PARAM declaration!";
+        case RuntimeErrorCode::COMPILATION_ERROR:
+            return "Function failed to compile!";
+        case RuntimeErrorCode::UNREGISTERED_FUNCTION:
+            return "Function was unregistered!";
+    }
+
+    assert(false && "Encountered unknown runtime error code!");
+    return {};
+}
+//---------------------------------------------------------------------------
+EvaluationResult::EvaluationResult(long long return_value, RuntimeErrorCode error_code, code::SourceCodeReference error_reference)
+    : return_value(return_value), error_code(error_code), error_reference(error_reference), source() {}
+
+EvaluationResult EvaluationResult::success(long long return_value) {
+    return EvaluationResult{ return_value, RuntimeErrorCode::NONE, {} };
+}
+
+EvaluationResult EvaluationResult::failure(RuntimeErrorCode error_code, code::SourceCodeReference error_reference) {
+    assert(error_code != RuntimeErrorCode::NONE && "A failure requires an error code!");
+    return EvaluationResult{ 0, error_code, error_reference };
+}
+
+bool EvaluationResult::isSuccess() const {
+    return error_code == RuntimeErrorCode::NONE;
+}
+
+bool EvaluationResult::isFailure() const {
+    return error_code != RuntimeErrorCode::NONE;
+}
+
+EvaluationResult::operator bool() const {
+    return isSuccess();
+}
+
+long long EvaluationResult::value() const {
+    assert(isSuccess() && "Tried to access the value of a failed evaluation!");
+    return return_value;
+}
+
+RuntimeErrorCode EvaluationResult::error() const {
+    return error_code;
+}
+
+std::string_view EvaluationResult::message() const {
+    assert(isFailure() && "Tried to access the error message of a successful evaluation!");
+    return runtimeErrorMessage(error_code);
+}
+
+bool EvaluationResult::hasReference() const {
+    return !error_reference.isEmpty();
+}
+
+const code::SourceCodeReference& EvaluationResult::reference() const {
+    return error_reference;
+}
+
+code::SourceCodeError EvaluationResult::makeError() const {
+    assert(hasReference() && "Tried to create an error without a source code reference!");
+    code::SourceCodeError error = error_reference.makeError(code::ErrorType::ERROR, message());
+    if (source) {
+        error.retainSource(source);
+    }
+    return error;
+}
+
+EvaluationResult& EvaluationResult::retainSource(std::shared_ptr<const code::SourceCodeManagement> source_code) {
+    source = std::move(source_code);
+    return *this;
+}
+//---------------------------------------------------------------------------
+void printRuntimeError(const EvaluationResult& result) {
+    // no `std::endl`, we don't want to force a flush for every error.
+    std::cout << result.message() << '\n';
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_EVALUATIONRESULT_HPP
+#define PLJIT_EVALUATIONRESULT_HPP
+
+#include "./code/SourceCode.hpp"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Describes the reason an evaluation failed.
+ */
+enum class RuntimeErrorCode : std::uint8_t {
+    /// The evaluation succeeded.
+    NONE,
+    /// The divisor of a division evaluated to zero.
+    DIVISION_BY_ZERO,
+    /// More arguments were passed than the PARAM declaration declares.
+    TOO_MANY_ARGUMENTS,
+    /// Less arguments were passed than the PARAM declaration declares.
+    TOO_FEW_ARGUMENTS,
+    /// Arguments were passed to a function without a PARAM declaration.
+    UNEXPECTED_ARGUMENTS,
+    /// The function couldn't be evaluated as it failed to compile.
+    COMPILATION_ERROR,
+    /// The function was unregistered from its `Pljit` instance.
+    UNREGISTERED_FUNCTION,
+};
+//---------------------------------------------------------------------------
+/**
+ * @return Returns the human readable message of the given `RuntimeErrorCode`.
+ */
+std::string_view runtimeErrorMessage(RuntimeErrorCode error_code);
+//---------------------------------------------------------------------------
+/**
+ * The outcome of a function evaluation. Either holds the return value or a `RuntimeErrorCode`
+ * with the `SourceCodeReference` of the failing expression, if available.
+ * Creating or copying an `EvaluationResult` never allocates.
+ *
+ * The reference only stays valid as long as its source code. Results returned by a `PljitFunctionHandle` retain
+ * the source code (see `retainSource`), so they stay valid even if the function is replaced or unregistered.
+ */
+class EvaluationResult {
+    long long return_value;
+    RuntimeErrorCode error_code;
+    code::SourceCodeReference error_reference;
+    /// Keeps the source code of `error_reference` alive, if retained.
+    std::shared_ptr<const code::SourceCodeManagement> source;
+
+    EvaluationResult(long long return_value, RuntimeErrorCode error_code, code::SourceCodeReference error_reference);
+
+    public:
+    static EvaluationResult success(long long return_value);
+    static EvaluationResult failure(RuntimeErrorCode error_code, code::SourceCodeReference error_reference = {});
+
+    bool isSuccess() const;
+    bool isFailure() const;
+    explicit operator bool() const;
+
+    /**
+     * @return Returns the return value. Must only be called on success.
+     */
+    long long value() const;
+    /**
+     * @return Returns the `RuntimeErrorCode`. `RuntimeErrorCode::NONE` on success.
+     */
+    RuntimeErrorCode error() const;
+    /**
+     * @return Returns the message of the runtime error. Must only be called on failure.
+     */
+    std::string_view message() const;
+    /**
+     * @return Returns true if the failure can be attributed to a location in the source code.
+     */
+    bool hasReference() const;
+    /**
+     * @return Returns the `SourceCodeReference` of the expression which caused the failure.
+     * Empty if `hasReference()` is false.
+     */
+    const code::SourceCodeReference& reference() const;
+    /**
+     * Creates a `SourceCodeError` for the failure, e.g. to print it with `printCompilerError()`.
+     * Must only be called if `hasReference()` is true.
+     */
+    code::SourceCodeError makeError() const;
+
+    /**
+     * Keeps the source code of the reference alive as long as this result or any copy of it exists.
+     * @param source_code The `SourceCodeManagement` of the reference, possibly sharing the ownership of its owner.
+     */
+    EvaluationResult& retainSource(std::shared_ptr<const code::SourceCodeManagement> source_code);
+};
+//---------------------------------------------------------------------------
+/**
+ * Prints the message of a failed `EvaluationResult` to standard out. The default `RuntimeErrorHandler`.
+ */
+void printRuntimeError(const EvaluationResult& result);
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_EVALUATIONRESULT_HPP
@@ -0,0 +1,326 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./FunctionRegistry.hpp"
+#include "./PljitFunction.hpp"
+#include <bit>
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The first slot stored in segment `k` has the index `FIRST_SEGMENT_SIZE * (2^k - 1)`.
+struct SegmentPosition {
+    std::size_t segment;
+    std::size_t offset;
+};
+
+SegmentPosition segmentOf(std::size_t index, std::size_t first_segment_size) {
+    std::size_t segment = std::bit_width(index / first_segment_size + 1) - 1;
+    return { segment, index - first_segment_size * ((std::size_t{ 1 } << segment) - 1) };
+}
+
+constexpr function_id GENERATION_MASK = (function_id{ 1 } << FunctionRegistry::GENERATION_BITS) - 1;
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+FunctionRegistry::NameTable::NameTable(std::size_t capacity) : entries(capacity) {}
+//---------------------------------------------------------------------------
+FunctionRegistry::ReleasedSlot::~ReleasedSlot() {
+    registry->release(*slot);
+}
+//---------------------------------------------------------------------------
+FunctionSlot FunctionRegistry::TOMBSTONE;
+
+FunctionRegistry::FunctionRegistry() : segments(), next_index(0), shards(), free_slots(), retired() {}
+
+FunctionRegistry::~FunctionRegistry() {
+    std::size_t count = next_index.load();
+    for (std::size_t index = 0; index < count; ++index) {
+        if (FunctionSlot* slot = slotAt(index)) {
+            delete slot->function.load();
+        }
+    }
+
+    for (std::size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        delete[] segments[segment].load();
+    }
+
+    for (auto& shard: shards) {
+        delete shard.table.load();
+    }
+}
+
+FunctionReference FunctionRegistry::add(std::unique_ptr<PljitFunction> function) {
+    FunctionReference reference = allocate({}, 0);
+    publish(*reference.slot, std::move(function));
+    return reference;
+}
+
+PljitFunction* FunctionRegistry::current(FunctionReference reference) {
+    PljitFunction* function = reference.slot->function.load(std::memory_order_acquire);
+    // a reused slot writes its id before publishing its function, so the function of a successor is never accepted
+    if (!function || reference.slot->id.load(std::memory_order_acquire) != reference.id) {
+        return nullptr;
+    }
+    return function;
+}
+
+std::uint64_t FunctionRegistry::requestVersion(FunctionSlot& slot) {
+    return slot.requested_version.fetch_add(1) + 1;
+}
+
+bool FunctionRegistry::replace(FunctionReference reference, std::unique_ptr<PljitFunction> function, std::uint64_t version) {
+    FunctionSlot& slot = *reference.slot;
+    PljitFunction* previous;
+    {
+        // pins the slot, it can't be reused while the referenced function is observed
+        EpochGuard guard;
+        std::lock_guard lock{ slot.replace_mutex };
+        if (version <= slot.version.load(std::memory_order_relaxed)) {
+            // superseded by a replacement which was requested later, but completed earlier
+            return false;
+        }
+
+        previous = slot.function.load(std::memory_order_acquire);
+        do {
+            if (!previous || slot.id.load(std::memory_order_acquire) != reference.id) {
+                return false;
+            }
+        } while (!slot.function.compare_exchange_weak(previous, function.get(), std::memory_order_acq_rel));
+        slot.version.store(version, std::memory_order_release);
+    }
+
+    function.release();
+    retired.retire(previous);
+    return true;
+}
+
+bool FunctionRegistry::remove(FunctionReference reference) {
+    FunctionSlot& slot = *reference.slot;
+    PljitFunction* previous;
+    {
+        // pins the slot, it can't be reused while the referenced function is observed
+        EpochGuard guard;
+        previous = slot.function.load(std::memory_order_acquire);
+        do {
+            if (!previous || slot.id.load(std::memory_order_acquire) != reference.id) {
+                return false;
+            }
+        } while (!slot.function.compare_exchange_weak(previous, nullptr, std::memory_order_acq_rel));
+    }
+
+    if (!slot.name.empty()) {
+        NameShard& shard = shardOf(slot.name_hash);
+        std::lock_guard lock{ shard.mutex };
+        removeName(shard, slot);
+    }
+
+    retired.retire(previous);
+    if (slot.name.empty() && (reference.id & GENERATION_MASK) != GENERATION_MASK) {
+        // readers which loaded the function might still check the id of the slot, so it is reused only once they are done
+        retired.retire(new ReleasedSlot{ this, &slot });
+    }
+    return true;
+}
+
+std::optional<FunctionReference> FunctionRegistry::lookup(function_id id) const {
+    std::optional<FunctionReference> reference = at(id >> GENERATION_BITS);
+    if (!reference || reference->id != id) {
+        // the slot is free, or holds a function registered before or after the one with this id
+        return {};
+    }
+    return reference;
+}
+
+std::optional<FunctionReference> FunctionRegistry::lookup(std::string_view name) const {
+    std::size_t name_hash = std::hash<std::string_view>{}(name);
+
+    // the table might be replaced and retired while probing, the slots themselves are never freed
+    EpochGuard guard;
+    FunctionSlot* slot = probe(shardOf(name_hash).table.load(std::memory_order_acquire), name, name_hash);
+    if (!slot) {
+        return {};
+    }
+
+    // named slots are never reused, so their id never changes
+    FunctionReference reference{ slot, slot->id.load(std::memory_order_acquire) };
+    if (!current(reference)) {
+        // unregistered, but the name wasn't removed yet
+        return {};
+    }
+    return reference;
+}
+
+std::optional<FunctionReference> FunctionRegistry::at(std::size_t index) const {
+    if (index >= next_index.load(std::memory_order_acquire)) {
+        return {};
+    }
+
+    FunctionSlot* slot = slotAt(index);
+    if (!slot || !slot->function.load(std::memory_order_acquire)) {
+        // the slot was handed out, but the registration isn't published yet or was removed.
+        return {};
+    }
+    return FunctionReference{ slot, slot->id.load(std::memory_order_acquire) };
+}
+
+std::size_t FunctionRegistry::size() const {
+    return next_index.load(std::memory_order_acquire);
+}
+
+std::size_t FunctionRegistry::pendingReclamation() const {
+    return retired.pending();
+}
+
+FunctionSlot* FunctionRegistry::slotAt(std::size_t index) const {
+    auto [segment, offset] = segmentOf(index, FIRST_SEGMENT_SIZE);
+    FunctionSlot* slots = segments[segment].load(std::memory_order_acquire);
+    return slots ? &slots[offset] : nullptr;
+}
+
+FunctionReference FunctionRegistry::allocate(std::string name, std::size_t name_hash) {
+    if (name.empty()) {
+        FunctionSlot* reused = nullptr;
+        {
+            std::lock_guard lock{ free_mutex };
+            if (!free_slots.empty()) {
+                reused = free_slots.back();
+                free_slots.pop_back();
+            }
+        }
+
+        if (reused) {
+            // the next generation of the slot, handles of its previous function are rejected from now on
+            function_id id = reused->id.load(std::memory_order_relaxed) + 1;
+            reused->version.store(0, std::memory_order_relaxed);
+            reused->requested_version.store(0, std::memory_order_relaxed);
+            reused->id.store(id, std::memory_order_release);
+            return { reused, id };
+        }
+    }
+
+    std::size_t index = next_index.fetch_add(1);
+    auto [segment, offset] = segmentOf(index, FIRST_SEGMENT_SIZE);
+    assert(segment < SEGMENT_COUNT && (index >> (64 - GENERATION_BITS)) == 0 && "Exceeded the capacity of the FunctionRegistry!");
+
+    FunctionSlot* slots = segments[segment].load(std::memory_order_acquire);
+    if (!slots) {
+        // concurrent registrations may race to allocate the segment, only one of them wins.
+        auto* allocated = new FunctionSlot[FIRST_SEGMENT_SIZE << segment];
+        if (segments[segment].compare_exchange_strong(slots, allocated, std::memory_order_acq_rel)) {
+            slots = allocated;
+        } else {
+            delete[] allocated;
+        }
+    }
+
+    FunctionSlot& slot = slots[offset];
+    function_id id = function_id{ index } << GENERATION_BITS;
+    slot.id.store(id, std::memory_order_relaxed);
+    slot.name = std::move(name);
+    slot.name_hash = name_hash;
+    return { &slot, id };
+}
+
+void FunctionRegistry::publish(FunctionSlot& slot, std::unique_ptr<PljitFunction> function) {
+    slot.function.store(function.release(), std::memory_order_release);
+}
+
+void FunctionRegistry::release(FunctionSlot& slot) {
+    std::lock_guard lock{ free_mutex };
+    free_slots.push_back(&slot);
+}
+
+FunctionRegistry::NameShard& FunctionRegistry::shardOf(std::size_t name_hash) {
+    return shards[name_hash % SHARD_COUNT];
+}
+
+const FunctionRegistry::NameShard& FunctionRegistry::shardOf(std::size_t name_hash) const {
+    return shards[name_hash % SHARD_COUNT];
+}
+
+FunctionSlot* FunctionRegistry::probe(const NameTable* table, std::string_view name, std::size_t name_hash) {
+    if (!table) {
+        return nullptr;
+    }
+
+    std::size_t mask = table->entries.size() - 1;
+    for (std::size_t index = (name_hash / SHARD_COUNT) & mask;; index = (index + 1) & mask) {
+        FunctionSlot* slot = table->entries[index].load(std::memory_order_acquire);
+        if (!slot) {
+            return nullptr;
+        }
+        if (slot != &TOMBSTONE && slot->name_hash == name_hash && slot->name == name) {
+            return slot;
+        }
+    }
+}
+
+void FunctionRegistry::insertName(NameShard& shard, FunctionSlot& slot) {
+    NameTable* table = shard.table.load(std::memory_order_relaxed);
+
+    if (!table || (table->count + 1) * 2 > table->entries.size()) {
+        // sized for the live names only, tables full of tombstones are rehashed without growing
+        std::size_t capacity = 16;
+        while (table && (table->live + 1) * 4 > capacity) {
+            capacity *= 2;
+        }
+
+        auto rehashed = std::make_unique<NameTable>(capacity);
+        if (table) {
+            for (auto& entry: table->entries) {
+                FunctionSlot* existing = entry.load(std::memory_order_relaxed);
+                if (existing && existing != &TOMBSTONE) {
+                    std::size_t mask = rehashed->entries.size() - 1;
+                    std::size_t index = (existing->name_hash / SHARD_COUNT) & mask;
+                    while (rehashed->entries[index].load(std::memory_order_relaxed)) {
+                        index = (index + 1) & mask;
+                    }
+                    rehashed->entries[index].store(existing, std::memory_order_relaxed);
+                    ++rehashed->count;
+                    ++rehashed->live;
+                }
+            }
+        }
+
+        shard.table.store(rehashed.get(), std::memory_order_release);
+        if (table) {
+            retired.retire(table);
+        }
+        table = rehashed.release();
+    }
+
+    std::size_t mask = table->entries.size() - 1;
+    std::size_t index = (slot.name_hash / SHARD_COUNT) & mask;
+    FunctionSlot* existing;
+    while ((existing = table->entries[index].load(std::memory_order_relaxed)) && existing != &TOMBSTONE) {
+        index = (index + 1) & mask;
+    }
+    table->entries[index].store(&slot, std::memory_order_release);
+    if (!existing) {
+        ++table->count;
+    }
+    ++table->live;
+}
+
+void FunctionRegistry::removeName(NameShard& shard, const FunctionSlot& slot) {
+    NameTable* table = shard.table.load(std::memory_order_relaxed);
+
+    std::size_t mask = table->entries.size() - 1;
+    for (std::size_t index = (slot.name_hash / SHARD_COUNT) & mask;; index = (index + 1) & mask) {
+        FunctionSlot* existing = table->entries[index].load(std::memory_order_relaxed);
+        assert(existing && "Removed a name which isn't registered!");
+        if (existing == &slot) {
+            table->entries[index].store(&TOMBSTONE, std::memory_order_release);
+            --table->live;
+            return;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
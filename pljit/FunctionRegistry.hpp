@@ -0,0 +1,237 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_FUNCTIONREGISTRY_HPP
+#define PLJIT_FUNCTIONREGISTRY_HPP
+
+#include "./util/EpochReclamation.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+class PljitFunction;
+//---------------------------------------------------------------------------
+/**
+ * Unique id of a function registered with a `Pljit` instance. Combines the index of its slot, in the upper bits,
+ * with the generation of the slot, in the lower `FunctionRegistry::GENERATION_BITS` bits.
+ * Ids are never handed out again, even if the slot of an unregistered function is reused.
+ */
+using function_id = std::uint64_t;
+//---------------------------------------------------------------------------
+/**
+ * The registry entry of a single function. Slots never move, so their address stays valid
+ * for the lifetime of the `FunctionRegistry`. The slot of an unregistered unnamed function is reused
+ * for a later registration, which is told apart by its `id`.
+ */
+struct FunctionSlot {
+    /**
+     * The registered function. Null till the registration is published and after the function was unregistered.
+     * Must only be dereferenced while holding an `EpochGuard`, replaced versions are reclaimed once no guard can refer to them.
+     */
+    std::atomic<PljitFunction*> function{ nullptr };
+    /// The version of `function`, starting at 0. Replacements are published in the order their versions were requested.
+    std::atomic<std::uint64_t> version{ 0 };
+    /// The last version handed out by `FunctionRegistry::requestVersion`.
+    std::atomic<std::uint64_t> requested_version{ 0 };
+    /// Serializes publishing replacements. Never taken by readers.
+    std::mutex replace_mutex;
+    /// The id of the function registered last. Written before a reused slot publishes its function.
+    std::atomic<function_id> id{ 0 };
+    /// The name of the function, empty for unnamed functions. Immutable, slots of named functions are never reused.
+    std::string name;
+    std::size_t name_hash = 0;
+};
+//---------------------------------------------------------------------------
+/// A slot together with the id of the function it was handed out for. Stale once the function was unregistered.
+struct FunctionReference {
+    FunctionSlot* slot;
+    function_id id;
+};
+//---------------------------------------------------------------------------
+/**
+ * Concurrent storage of all functions of a `Pljit` instance, providing lookup by `function_id` and by name.
+ *
+ * Slots live in a segmented array: segment `k` holds `FIRST_SEGMENT_SIZE << k` slots and is allocated
+ * once the first slot inside it is handed out. Looking up an id is wait-free.
+ *
+ * Names are kept in `SHARD_COUNT` open addressing tables which point to the slots. Writers of a shard
+ * are serialized by a per-shard mutex, readers never lock: they probe the table currently published for the shard.
+ * Removed names leave a tombstone. A table which is outgrown is replaced by a rehashed copy without tombstones,
+ * sized for its live names.
+ *
+ * Replaced functions and name tables might still be used by concurrent readers. They are retired and
+ * reclaimed through epoch based reclamation, so the memory of the registry stays bounded under continuous replacement.
+ *
+ * The slot of an unregistered unnamed function is retired as well and reused for a later unnamed registration
+ * once no reader can refer to the unregistered function anymore. Every reuse increments the generation of the slot,
+ * which is part of the `function_id`, so references to the unregistered function are rejected rather than resolving
+ * to its successor. A slot is no longer reused once its generation is exhausted. Slots of named functions are never
+ * reused, as their name is read without synchronization.
+ */
+class FunctionRegistry {
+    static constexpr std::size_t FIRST_SEGMENT_SIZE = 256;
+    static constexpr std::size_t SEGMENT_COUNT = 40;
+    static constexpr std::size_t SHARD_COUNT = 64;
+
+    public:
+    /// Number of bits of a `function_id` holding the generation of its slot.
+    static constexpr unsigned GENERATION_BITS = 24;
+
+    private:
+
+    struct NameTable {
+        /// Number of occupied entries, including tombstones.
+        std::size_t count = 0;
+        /// Number of entries referring to a slot.
+        std::size_t live = 0;
+        std::vector<std::atomic<FunctionSlot*>> entries;
+
+        explicit NameTable(std::size_t capacity);
+    };
+    struct NameShard {
+        std::mutex mutex;
+        /// Owns the current table. Previous tables are retired.
+        std::atomic<NameTable*> table{ nullptr };
+    };
+
+    /// Retired by `remove`, returns the slot to the free list once its unregistered function is reclaimed.
+    struct ReleasedSlot {
+        FunctionRegistry* registry;
+        FunctionSlot* slot;
+
+        ~ReleasedSlot();
+    };
+
+    /// Marks the entry of a removed name. Probing continues past it.
+    static FunctionSlot TOMBSTONE;
+
+    std::array<std::atomic<FunctionSlot*>, SEGMENT_COUNT> segments;
+    /// The number of slots handed out so far.
+    std::atomic<std::size_t> next_index;
+    std::array<NameShard, SHARD_COUNT> shards;
+    std::mutex free_mutex;
+    /// Slots of unregistered unnamed functions, ready to be reused. Declared before `retired`, which fills it.
+    std::vector<FunctionSlot*> free_slots;
+    /// Replaced functions, released slots and name tables, which might still be referenced by concurrent readers.
+    RetireList retired;
+
+    public:
+    FunctionRegistry();
+    ~FunctionRegistry();
+
+    FunctionRegistry(const FunctionRegistry& other) = delete;
+    FunctionRegistry& operator=(const FunctionRegistry& other) = delete;
+
+    /**
+     * Registers an unnamed function, reusing the slot of an unregistered unnamed function if one is free.
+     * @param function The function, owned by the registry from now on.
+     * @return Returns the reference to the function.
+     */
+    FunctionReference add(std::unique_ptr<PljitFunction> function);
+    /**
+     * Registers a function under the given name.
+     * @param create Called to create the function, only if the name isn't taken yet.
+     * @return Returns the reference to the function, or an empty optional if a function with the name is already registered.
+     */
+    template <typename F>
+    std::optional<FunctionReference> add(std::string name, F&& create);
+
+    /**
+     * @return Returns the current version of the referenced function, null if it was unregistered.
+     * Must only be dereferenced while holding an `EpochGuard`, like `FunctionSlot::function`.
+     */
+    static PljitFunction* current(FunctionReference reference);
+
+    /**
+     * Hands out the version of a replacement of the function of the given slot, before its function is created.
+     */
+    static std::uint64_t requestVersion(FunctionSlot& slot);
+    /**
+     * Publishes a new version of the function of the given slot. Threads already executing the previous
+     * version finish with it, it is reclaimed afterwards.
+     * @param version The version returned by `requestVersion` for this replacement.
+     * @return Returns false, and drops the given function, if the referenced function was unregistered or a
+     * more recently requested version was published already.
+     */
+    bool replace(FunctionReference reference, std::unique_ptr<PljitFunction> function, std::uint64_t version);
+    /**
+     * Unregisters the referenced function and frees its name for new registrations.
+     * The function is reclaimed once no thread is executing it anymore. The slot itself stays valid,
+     * unnamed slots are reused afterwards.
+     * @return Returns false if the function was already unregistered.
+     */
+    bool remove(FunctionReference reference);
+
+    /**
+     * @return Returns the reference to the function with the given id, or an empty optional if there is none. Wait-free.
+     */
+    std::optional<FunctionReference> lookup(function_id id) const;
+    /**
+     * @return Returns the reference to the function with the given name, or an empty optional if there is none. Never blocks.
+     */
+    std::optional<FunctionReference> lookup(std::string_view name) const;
+    /**
+     * @return Returns the reference to the function registered in the slot at the given index, or an empty optional
+     * if the slot is free. Wait-free.
+     */
+    std::optional<FunctionReference> at(std::size_t index) const;
+
+    /**
+     * @return Returns the number of slots handed out so far. Enumerate the functions through `at` for every index below it.
+     */
+    std::size_t size() const;
+
+    /**
+     * @return Returns the number of replaced functions and name tables which weren't reclaimed yet.
+     */
+    std::size_t pendingReclamation() const;
+
+    private:
+    /// @return Returns the slot at the given index, or null if its segment isn't allocated yet.
+    FunctionSlot* slotAt(std::size_t index) const;
+    /// Hands out a slot, a free one for unnamed functions if available, and assigns the id of its next function.
+    FunctionReference allocate(std::string name, std::size_t name_hash);
+    void publish(FunctionSlot& slot, std::unique_ptr<PljitFunction> function);
+    /// Returns the slot to the free list. Called once its unregistered function was reclaimed.
+    void release(FunctionSlot& slot);
+
+    NameShard& shardOf(std::size_t name_hash);
+    const NameShard& shardOf(std::size_t name_hash) const;
+    /// Probes the given table. The caller must hold an `EpochGuard` or the mutex of the shard.
+    static FunctionSlot* probe(const NameTable* table, std::string_view name, std::size_t name_hash);
+    /// Inserts the slot into its shard. The mutex of the shard must be held.
+    void insertName(NameShard& shard, FunctionSlot& slot);
+    /// Replaces the entry of the slot with a tombstone. The mutex of the shard must be held.
+    static void removeName(NameShard& shard, const FunctionSlot& slot);
+};
+
+template <typename F>
+std::optional<FunctionReference> FunctionRegistry::add(std::string name, F&& create) {
+    std::size_t name_hash = std::hash<std::string_view>{}(name);
+    NameShard& shard = shardOf(name_hash);
+
+    std::lock_guard lock{ shard.mutex };
+    if (probe(shard.table.load(std::memory_order_relaxed), name, name_hash)) {
+        return {};
+    }
+
+    FunctionReference reference = allocate(std::move(name), name_hash);
+    publish(*reference.slot, create());
+    insertName(shard, *reference.slot);
+    return reference;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_FUNCTIONREGISTRY_HPP
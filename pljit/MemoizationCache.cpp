@@ -0,0 +1,139 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./MemoizationCache.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Shards are only split off while every shard keeps at least this many slots,
+/// so that small caches don't lose hits to an uneven distribution over the shards.
+constexpr std::size_t MIN_SHARD_CAPACITY = 64;
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+MemoizationCache::MemoizationCache(std::size_t arity, std::size_t memory_limit) : arity(arity), shard_capacity(0), shards() {
+    std::size_t capacity = memory_limit / entrySize(arity);
+    assert(capacity > 0 && "Can't construct a MemoizationCache which can't hold a single result!");
+
+    std::size_t shard_count = std::clamp<std::size_t>(std::bit_floor(capacity / MIN_SHARD_CAPACITY), 1, MAX_SHARD_COUNT);
+    shard_capacity = std::min<std::size_t>(capacity / shard_count, std::numeric_limits<std::uint32_t>::max() / 2);
+
+    shards = std::vector<Shard>(shard_count);
+    for (auto& shard: shards) {
+        shard.index.resize(std::bit_ceil(shard_capacity * 2));
+    }
+}
+
+std::size_t MemoizationCache::entrySize(std::size_t arity) {
+    return arity * sizeof(long long) + sizeof(EvaluationResult) + sizeof(std::size_t) + sizeof(bool)
+        + INDEX_ENTRIES_PER_SLOT * sizeof(std::uint32_t);
+}
+
+MemoizationStatistics MemoizationCache::statistics() {
+    MemoizationStatistics statistics;
+    statistics.capacity = shard_capacity * shards.size();
+    statistics.memory_bytes = statistics.capacity * entrySize(arity);
+
+    for (auto& shard: shards) {
+        std::lock_guard lock{ shard.mutex };
+        statistics.hits += shard.hits;
+        statistics.misses += shard.misses;
+        statistics.evictions += shard.evictions;
+        statistics.entries += shard.results.size();
+    }
+    return statistics;
+}
+
+std::size_t MemoizationCache::hash(std::span<const long long> arguments) const {
+    std::size_t hash = 0x9e3779b97f4a7c15ULL;
+    for (long long argument: arguments) {
+        // the finalizer of splitmix64, so that neighbouring arguments end up in different shards
+        hash = (hash ^ static_cast<std::size_t>(argument)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+MemoizationCache::Shard& MemoizationCache::shardOf(std::size_t hash) {
+    // the index of a shard probes from the low bits
+    return shards[(hash >> 56) & (shards.size() - 1)];
+}
+
+std::uint32_t MemoizationCache::find(const Shard& shard, std::span<const long long> arguments, std::size_t hash) const {
+    std::size_t mask = shard.index.size() - 1;
+    for (std::size_t position = hash & mask;; position = (position + 1) & mask) {
+        std::uint32_t entry = shard.index[position];
+        if (entry == 0) {
+            return 0;
+        }
+
+        std::uint32_t slot = entry - 1;
+        if (shard.hashes[slot] == hash && std::equal(arguments.begin(), arguments.end(), shard.arguments.begin() + static_cast<std::ptrdiff_t>(slot * arity))) {
+            return entry;
+        }
+    }
+}
+
+void MemoizationCache::insert(Shard& shard, std::span<const long long> arguments, std::size_t hash, const EvaluationResult& result) {
+    std::uint32_t slot;
+    if (shard.results.size() < shard_capacity) {
+        slot = static_cast<std::uint32_t>(shard.results.size());
+        shard.arguments.insert(shard.arguments.end(), arguments.begin(), arguments.end());
+        shard.results.push_back(result);
+        shard.hashes.push_back(hash);
+        shard.referenced.push_back(false);
+    } else {
+        // CLOCK: results hit since the hand passed them last get a second chance
+        while (shard.referenced[shard.hand]) {
+            shard.referenced[shard.hand] = false;
+            shard.hand = (shard.hand + 1) % shard_capacity;
+        }
+        slot = static_cast<std::uint32_t>(shard.hand);
+        shard.hand = (shard.hand + 1) % shard_capacity;
+
+        erase(shard, slot);
+        ++shard.evictions;
+
+        std::copy(arguments.begin(), arguments.end(), shard.arguments.begin() + static_cast<std::ptrdiff_t>(slot * arity));
+        shard.results[slot] = result;
+        shard.hashes[slot] = hash;
+    }
+
+    std::size_t mask = shard.index.size() - 1;
+    std::size_t position = hash & mask;
+    while (shard.index[position] != 0) {
+        position = (position + 1) & mask;
+    }
+    shard.index[position] = slot + 1;
+}
+
+void MemoizationCache::erase(Shard& shard, std::uint32_t slot) {
+    std::size_t mask = shard.index.size() - 1;
+    std::size_t position = shard.hashes[slot] & mask;
+    while (shard.index[position] != slot + 1) {
+        position = (position + 1) & mask;
+    }
+
+    // backward shift deletion: moves entries of the probe sequence into the gap, so lookups never need tombstones
+    for (std::size_t next = (position + 1) & mask; shard.index[next] != 0; next = (next + 1) & mask) {
+        std::size_t home = shard.hashes[shard.index[next] - 1] & mask;
+        // the entry may only move if its home doesn't lie cyclically within (position, next]
+        if (((next - home) & mask) >= ((next - position) & mask)) {
+            shard.index[position] = shard.index[next];
+            position = next;
+        }
+    }
+    shard.index[position] = 0;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
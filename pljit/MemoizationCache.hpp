@@ -0,0 +1,129 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_MEMOIZATIONCACHE_HPP
+#define PLJIT_MEMOIZATIONCACHE_HPP
+
+#include "./EvaluationResult.hpp"
+#include "./MemoizationStatistics.hpp"
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Caches the `EvaluationResult`s of a single function keyed by their arguments. Functions can't have side effects,
+ * so a cached result, including a runtime error, is exactly what evaluating the arguments again would return.
+ * Thread-safe.
+ *
+ * The results are spread over up to `MAX_SHARD_COUNT` shards by the hash of their arguments, each guarded by its own
+ * mutex. A shard stores its results in a fixed number of slots, sized so that all shards together stay within the
+ * memory limit, and finds them through an open addressing index using linear probing.
+ * Once a shard is full, the CLOCK algorithm picks the slot to reuse: the hand sweeps over the slots and evicts
+ * the first result which wasn't hit since the hand passed it last.
+ */
+class MemoizationCache {
+    static constexpr std::size_t MAX_SHARD_COUNT = 16;
+    /// The index of a shard has at most this many entries per slot, so that it is at most half full.
+    static constexpr std::size_t INDEX_ENTRIES_PER_SLOT = 4;
+
+    struct Shard {
+        std::mutex mutex;
+        /// The arguments of every slot, `arity` values per slot.
+        std::vector<long long> arguments;
+        std::vector<EvaluationResult> results;
+        std::vector<std::size_t> hashes;
+        /// Whether the slot was hit since the hand passed it.
+        std::vector<bool> referenced;
+        /// Refers to the slots, `slot + 1`. Zero marks an empty entry.
+        std::vector<std::uint32_t> index;
+        /// The next slot considered for eviction.
+        std::size_t hand = 0;
+
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
+    std::size_t arity;
+    /// The number of slots of every shard.
+    std::size_t shard_capacity;
+    std::vector<Shard> shards;
+
+    public:
+    /**
+     * @param arity The number of arguments of the function. Calls with a different number of arguments aren't cached.
+     * @param memory_limit The memory all cached results may occupy at most. Must fit at least one result,
+     * see `entrySize`.
+     */
+    MemoizationCache(std::size_t arity, std::size_t memory_limit);
+
+    MemoizationCache(const MemoizationCache& other) = delete;
+    MemoizationCache& operator=(const MemoizationCache& other) = delete;
+
+    /**
+     * @return Returns the memory a single cached result of a function with the given arity occupies.
+     */
+    static std::size_t entrySize(std::size_t arity);
+
+    /**
+     * Returns the cached result for the given arguments, or caches the result of `evaluate` otherwise.
+     * @param evaluate Called without any lock held to evaluate the function for the given arguments.
+     */
+    template <typename F>
+    EvaluationResult memoize(std::span<const long long> arguments, F&& evaluate);
+
+    /**
+     * @return Returns the hit, miss and eviction counters of all shards.
+     */
+    MemoizationStatistics statistics();
+
+    private:
+    std::size_t hash(std::span<const long long> arguments) const;
+    Shard& shardOf(std::size_t hash);
+    /// @return Returns `slot + 1` of the slot holding the given arguments, zero if there is none.
+    /// The mutex of the shard must be held.
+    std::uint32_t find(const Shard& shard, std::span<const long long> arguments, std::size_t hash) const;
+    /// Caches the result, evicting another one if the shard is full. The mutex of the shard must be held.
+    void insert(Shard& shard, std::span<const long long> arguments, std::size_t hash, const EvaluationResult& result);
+    /// Removes the slot from the index of the shard. The mutex of the shard must be held.
+    static void erase(Shard& shard, std::uint32_t slot);
+};
+
+template <typename F>
+EvaluationResult MemoizationCache::memoize(std::span<const long long> arguments, F&& evaluate) {
+    if (arguments.size() != arity) {
+        // fails with an argument count error, not worth caching
+        return evaluate();
+    }
+
+    std::size_t arguments_hash = hash(arguments);
+    Shard& shard = shardOf(arguments_hash);
+    {
+        std::lock_guard lock{ shard.mutex };
+        if (std::uint32_t slot = find(shard, arguments, arguments_hash)) {
+            ++shard.hits;
+            shard.referenced[slot - 1] = true;
+            return shard.results[slot - 1];
+        }
+    }
+
+    EvaluationResult result = evaluate();
+
+    std::lock_guard lock{ shard.mutex };
+    ++shard.misses;
+    if (!find(shard, arguments, arguments_hash)) {
+        // otherwise a concurrent call evaluated the same arguments
+        insert(shard, arguments, arguments_hash, result);
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_MEMOIZATIONCACHE_HPP
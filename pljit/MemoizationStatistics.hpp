@@ -0,0 +1,43 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_MEMOIZATIONSTATISTICS_HPP
+#define PLJIT_MEMOIZATIONSTATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Snapshot of the result cache of a single function, see `CompileOptions::memoization_memory_limit`.
+ */
+struct MemoizationStatistics {
+    /// The number of calls answered from the cache.
+    std::uint64_t hits = 0;
+    /// The number of calls which were evaluated and whose result was cached.
+    std::uint64_t misses = 0;
+    /// The number of results evicted to make room for newer ones.
+    std::uint64_t evictions = 0;
+    /// The number of currently cached results.
+    std::size_t entries = 0;
+    /// The maximum number of cached results fitting into the memory limit. Zero if memoization is disabled.
+    std::size_t capacity = 0;
+    /// The memory the cache occupies once all `capacity` results are cached.
+    std::size_t memory_bytes = 0;
+
+    /**
+     * @return Returns the share of memoized calls which were answered from the cache. Zero if no call was memoized.
+     */
+    double hit_rate() const {
+        std::uint64_t calls = hits + misses;
+        return calls == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(calls);
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_MEMOIZATIONSTATISTICS_HPP
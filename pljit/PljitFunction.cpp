@@ -3,30 +3,168 @@
 //
 
 #include "PljitFunction.hpp"
-#include "./ast/ASTBuilder.hpp"
-#include "./lex/Lexer.hpp"
-#include "./parse/Parser.hpp"
-#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
-PljitFunction::PljitFunction(std::string&& source_code) : source_code(std::move(source_code)) {}
+namespace {
+//---------------------------------------------------------------------------
+std::shared_ptr<const CompiledFunction> compileTier(
+    std::string&& source_code,
+    ExecutionMode execution_mode,
+    OptimizationLevel optimization_level,
+    CompileCache* compile_cache,
+    const CodeCache* code_cache,
+    std::span<const std::optional<long long>> parameter_bindings) {
+    if (compile_cache && parameter_bindings.empty()) {
+        return compile_cache->lookup(std::move(source_code), execution_mode, optimization_level);
+    }
+    return CompiledFunction::compile(std::move(source_code), execution_mode, optimization_level, code_cache, parameter_bindings);
+}
+
+/// Runs the task on the compile thread pool if present or a new thread otherwise.
+template <typename F>
+std::future<void> runInBackground(ThreadPool* compile_pool, F&& task) {
+    if (compile_pool) {
+        return compile_pool->submit(std::forward<F>(task));
+    }
+    return std::async(std::launch::async, std::forward<F>(task));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+PljitFunction::Speculation::Speculation(std::size_t parameter_count)
+    : candidates(parameter_count), votes(parameter_count), matches(parameter_count) {}
+//---------------------------------------------------------------------------
+PljitFunction::PljitFunction(
+    std::string&& source_code,
+    CompileOptions options,
+    ThreadPool* compile_pool,
+    CompileCache* compile_cache,
+    const CodeCache* code_cache,
+    std::vector<std::optional<long long>> parameter_bindings)
+    : source_code(std::move(source_code)), options(std::move(options)), compile_pool(compile_pool),
+      compile_cache(compile_cache), code_cache(code_cache), parameter_bindings(std::move(parameter_bindings)), active(nullptr), tier_state(TierState::SETTLED), baseline_calls(0),
+      speculation_state(SpeculationState::DISABLED) {
+    if (this->options.tier_up_threshold > 0) {
+        tier_state = TierState::COUNTING;
+        promotion = std::make_shared<Promotion>();
+    }
+}
 
-std::optional<long long> PljitFunction::evaluate(const std::vector<long long>& arguments) {
+std::optional<long long> PljitFunction::evaluate(std::span<const long long> arguments) {
+    EvaluationResult result = call(arguments);
+    if (result) {
+        return result.value();
+    }
+
+    // compilation errors are accessed through `compilation_error()`
+    if (result.error() != RuntimeErrorCode::COMPILATION_ERROR && options.runtime_error_handler) {
+        options.runtime_error_handler(result);
+    }
+    return {};
+}
+
+EvaluationResult PljitFunction::call(std::span<const long long> arguments) {
     ensure_compiled();
 
-    if (compilation_error_val) {
-        return {};
+    if (memoization) [[unlikely]] {
+        return memoization->memoize(arguments, [&]() { return execute(arguments); });
+    }
+    return execute(arguments);
+}
+
+EvaluationResult PljitFunction::execute(std::span<const long long> arguments) {
+    if (tier_state.load(std::memory_order_relaxed) != TierState::SETTLED) [[unlikely]] {
+        countBaselineCalls(1);
     }
+    const CompiledFunction* current = active.load(std::memory_order_acquire);
 
-    auto context = function->evaluate(arguments);
-    if (context.runtime_error()) {
-        // specification said it is enough to print the error to std out.
-        std::cout << *context.runtime_error() << std::endl;
+    SpeculationState state = speculation_state.load(std::memory_order_relaxed);
+    if (state != SpeculationState::DISABLED && state < SpeculationState::UNSTABLE) [[unlikely]] {
+        current = speculate(arguments, current);
     }
 
-    return context.return_value();
+    if (const auto& error = current->compilation_error()) {
+        return EvaluationResult::failure(RuntimeErrorCode::COMPILATION_ERROR, error->reference()).retainSource(current->shareSourceCode());
+    }
+
+    // Reused by every evaluation on this thread. Its heap storage (only required for functions
+    // with more than `EvaluationContext::INLINE_CAPACITY` variables) is therefore only allocated once.
+    thread_local EvaluationContext context;
+
+    if (const auto& native_function = current->getNativeFunction()) {
+        native_function->evaluate(arguments, context);
+    } else if (const auto& bytecode = current->getBytecode()) {
+        bytecode->evaluate(arguments, context);
+    } else {
+        current->getFunction()->evaluate(arguments, context);
+    }
+
+    EvaluationResult result = context.result();
+    if (result.hasReference()) [[unlikely]] {
+        // the function might be replaced while the caller still holds on to the result
+        result.retainSource(current->shareSourceCode());
+    }
+    return result;
+}
+
+RuntimeErrorCode PljitFunction::evaluateBatch(
+    std::span<const std::span<const long long>> columns,
+    std::span<long long> output,
+    std::span<std::uint64_t> error_bitmap) {
+    // checked for both paths, the AST interpreter accesses the buffers row by row
+    assert(error_bitmap.size() >= (output.size() + 63) / 64 && "Error bitmap is too small!");
+    for ([[maybe_unused]] auto& column: columns) {
+        assert(column.size() == output.size() && "Every column must provide a value for every row!");
+    }
+
+    ensure_compiled();
+
+    if (tier_state.load(std::memory_order_relaxed) != TierState::SETTLED) [[unlikely]] {
+        countBaselineCalls(output.size());
+    }
+    const CompiledFunction* current = active.load(std::memory_order_acquire);
+
+    if (current->compilation_error()) {
+        return RuntimeErrorCode::COMPILATION_ERROR;
+    }
+
+    if (const auto& bytecode = current->getBytecode()) {
+        return bytecode->evaluateBatch(columns, output, error_bitmap);
+    }
+
+    const ast::Function& function = *current->getFunction();
+
+    std::fill_n(error_bitmap.begin(), (output.size() + 63) / 64, 0);
+
+    RuntimeErrorCode batch_error = RuntimeErrorCode::NONE;
+    EvaluationContext context;
+    std::vector<long long> arguments(columns.size());
+
+    for (std::size_t row = 0; row < output.size(); ++row) {
+        for (std::size_t column = 0; column < columns.size(); ++column) {
+            arguments[column] = columns[column][row];
+        }
+
+        function.evaluate(arguments, context);
+        output[row] = context.return_value().value_or(0);
+
+        RuntimeErrorCode error = context.runtime_error_code();
+        if (error == RuntimeErrorCode::DIVISION_BY_ZERO) {
+            error_bitmap[row / 64] |= std::uint64_t{ 1 } << (row % 64);
+            batch_error = error;
+        } else if (error != RuntimeErrorCode::NONE) {
+            // argument count errors affect every row
+            std::fill(output.begin(), output.end(), 0);
+            return error;
+        }
+    }
+
+    return batch_error;
 }
 
 void PljitFunction::ensure_compiled() {
@@ -52,20 +190,27 @@ void PljitFunction::ensure_compiled() {
             return;
         }
 
-        lex::Lexer lexer{source_code};
-        parse::Parser parser{lexer};
-        ast::ASTBuilder builder;
+        // with tiered execution, the function starts in the baseline tier
+        ExecutionMode execution_mode = promotion ? options.baseline_execution_mode : options.execution_mode;
+        OptimizationLevel optimization_level = promotion ? options.baseline_optimization_level : options.optimization_level;
 
-        Result<parse::FunctionDefinition> program = parser.parse_program();
-        if (!program) {
-            compilation_error_val = program.error();
-        } else {
-            Result<ast::Function> func = builder.analyzeFunction(*program);
-            if (!func) {
-                compilation_error_val = func.error();
-            } else {
-                function = func.release();
-            }
+        compiled = compileTier(std::move(source_code), execution_mode, optimization_level, compile_cache, code_cache, parameter_bindings);
+        // releases the source code if it wasn't moved because of a cache hit
+        source_code = std::string{};
+
+        if (compiled->compilation_error()) {
+            // the optimized tier would fail to compile as well
+            tier_state.store(TierState::SETTLED);
+        }
+        active.store(compiled.get(), std::memory_order_release);
+
+        if (options.value_profile_calls > 0 && !compiled->compilation_error() && compiled->parameter_count() > 0) {
+            speculation = std::make_shared<Speculation>(compiled->parameter_count());
+            speculation_state.store(SpeculationState::PROFILING);
+        }
+
+        if (!compiled->compilation_error() && options.memoization_memory_limit >= MemoizationCache::entrySize(compiled->parameter_count())) {
+            memoization = std::make_unique<MemoizationCache>(compiled->parameter_count(), options.memoization_memory_limit);
         }
 
         // the order we release things here is important.
@@ -78,8 +223,255 @@ void PljitFunction::ensure_compiled() {
     function_compiled.notify_all();
 }
 
+void PljitFunction::countBaselineCalls(std::uint64_t calls) {
+    std::uint64_t total = baseline_calls.fetch_add(calls, std::memory_order_relaxed) + calls;
+
+    TierState state = tier_state.load(std::memory_order_acquire);
+    if (state == TierState::COUNTING && total >= options.tier_up_threshold) {
+        startPromotion();
+    } else if (state == TierState::PROMOTING && promotion->ready.load(std::memory_order_acquire)) {
+        completePromotion();
+    }
+}
+
+void PljitFunction::startPromotion() {
+    TierState expected = TierState::COUNTING;
+    if (!tier_state.compare_exchange_strong(expected, TierState::PROMOTING)) {
+        // another call crossed the threshold concurrently
+        return;
+    }
+
+    auto compile = [promotion = promotion,
+                    source_code = std::string{ compiled->getSourceCode().content() },
+                    execution_mode = options.execution_mode,
+                    optimization_level = options.optimization_level,
+                    compile_cache = compile_cache,
+                    code_cache = code_cache,
+                    parameter_bindings = parameter_bindings]() mutable {
+        auto start = std::chrono::steady_clock::now();
+        promotion->function = compileTier(std::move(source_code), execution_mode, optimization_level, compile_cache, code_cache, parameter_bindings);
+        promotion->time = std::chrono::steady_clock::now() - start;
+        promotion->ready.store(true, std::memory_order_release);
+    };
+
+    // calls keep evaluating the baseline tier till the optimized tier is ready
+    promotion_compilation = runInBackground(compile_pool, std::move(compile));
+}
+
+void PljitFunction::completePromotion() {
+    // concurrent calls might complete the promotion at the same time, which is harmless
+    if (!promotion->function->compilation_error()) {
+        active.store(promotion->function.get(), std::memory_order_release);
+    }
+    tier_state.store(TierState::SETTLED, std::memory_order_release);
+}
+
+const CompiledFunction* PljitFunction::speculate(std::span<const long long> arguments, const CompiledFunction* generic) {
+    SpeculationState state = speculation_state.load(std::memory_order_acquire);
+    if (state == SpeculationState::PROFILING) {
+        profile(arguments);
+        return generic;
+    } else if (state == SpeculationState::COMPILING) {
+        if (!speculation->ready.load(std::memory_order_acquire)) {
+            return generic;
+        }
+        completeSpeculation();
+        if (speculation_state.load(std::memory_order_acquire) != SpeculationState::GUARDED) {
+            return generic;
+        }
+    }
+
+    const std::vector<std::optional<long long>>& guards = speculation->guards;
+    if (arguments.size() != guards.size()) {
+        // fails with an argument count error, which isn't a miss
+        return generic;
+    }
+
+    bool passed = true;
+    for (std::size_t index = 0; index < guards.size(); ++index) {
+        if (guards[index] && *guards[index] != arguments[index]) {
+            passed = false;
+            break;
+        }
+    }
+
+    if (passed) {
+        speculation->hits.fetch_add(1, std::memory_order_relaxed);
+        return speculation->function.get();
+    }
+
+    std::uint64_t misses = speculation->misses.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (misses >= DROP_MIN_MISSES && misses * 4 > speculation->hits.load(std::memory_order_relaxed)) {
+        SpeculationState expected = SpeculationState::GUARDED;
+        speculation_state.compare_exchange_strong(expected, SpeculationState::DROPPED, std::memory_order_release);
+    }
+    return generic;
+}
+
+void PljitFunction::profile(std::span<const long long> arguments) {
+    if (arguments.size() != speculation->candidates.size()) {
+        return;
+    }
+
+    std::uint64_t index = speculation->profiled_calls.fetch_add(1, std::memory_order_relaxed);
+    if (index >= options.value_profile_calls) {
+        // profiling completed concurrently
+        return;
+    }
+
+    // Boyer-Moore majority vote, then counting the calls passing the elected candidate.
+    // Races between concurrently profiled calls only affect the accuracy of the profile.
+    bool voting = index < votingCalls();
+    for (std::size_t parameter = 0; parameter < arguments.size(); ++parameter) {
+        std::atomic<long long>& candidate = speculation->candidates[parameter];
+
+        if (!voting) {
+            if (candidate.load(std::memory_order_relaxed) == arguments[parameter]) {
+                speculation->matches[parameter].fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        std::atomic<std::uint64_t>& votes = speculation->votes[parameter];
+        std::uint64_t current = votes.load(std::memory_order_relaxed);
+        if (current == 0) {
+            candidate.store(arguments[parameter], std::memory_order_relaxed);
+            votes.store(1, std::memory_order_relaxed);
+        } else if (candidate.load(std::memory_order_relaxed) == arguments[parameter]) {
+            votes.store(current + 1, std::memory_order_relaxed);
+        } else {
+            votes.store(current - 1, std::memory_order_relaxed);
+        }
+    }
+
+    if (index + 1 == options.value_profile_calls) {
+        startSpeculation();
+    }
+}
+
+std::uint64_t PljitFunction::votingCalls() const {
+    return (options.value_profile_calls + 1) / 2;
+}
+
+void PljitFunction::startSpeculation() {
+    std::uint64_t compared = options.value_profile_calls - votingCalls();
+
+    bool stable = false;
+    speculation->guards.resize(speculation->candidates.size());
+    for (std::size_t parameter = 0; parameter < speculation->candidates.size(); ++parameter) {
+        if (speculation->matches[parameter].load(std::memory_order_relaxed) * 100 >= compared * STABLE_PERCENTAGE) {
+            speculation->guards[parameter] = speculation->candidates[parameter].load(std::memory_order_relaxed);
+            stable = true;
+        }
+    }
+
+    if (!stable) {
+        speculation_state.store(SpeculationState::UNSTABLE, std::memory_order_release);
+        return;
+    }
+    speculation_state.store(SpeculationState::COMPILING, std::memory_order_release);
+
+    auto compile = [speculation = speculation,
+                    source_code = std::string{ compiled->getSourceCode().content() },
+                    execution_mode = options.execution_mode,
+                    optimization_level = options.optimization_level,
+                    parameter_bindings = parameter_bindings]() mutable {
+        speculation->function = CompiledFunction::compile(
+            std::move(source_code), execution_mode, optimization_level, nullptr, parameter_bindings, speculation->guards
+        );
+        speculation->ready.store(true, std::memory_order_release);
+    };
+
+    // calls keep evaluating the generic version till the speculative version is ready
+    speculation_compilation = runInBackground(compile_pool, std::move(compile));
+}
+
+void PljitFunction::completeSpeculation() {
+    SpeculationState expected = SpeculationState::COMPILING;
+    SpeculationState completed = speculation->function->compilation_error() ? SpeculationState::DROPPED : SpeculationState::GUARDED;
+    // concurrent calls might complete the speculation at the same time, only one of them succeeds
+    speculation_state.compare_exchange_strong(expected, completed, std::memory_order_release);
+}
+
 std::optional<code::SourceCodeError> PljitFunction::compilation_error() const {
-    return compilation_error_val;
+    if (!function_compiled.load()) {
+        return {};
+    }
+    std::optional<code::SourceCodeError> error = compiled->compilation_error();
+    if (error) {
+        // the function might be replaced while the caller still holds on to the error
+        error->retainSource(compiled->shareSourceCode());
+    }
+    return error;
+}
+
+const CompileOptions& PljitFunction::compile_options() const {
+    return options;
+}
+
+ThreadPool* PljitFunction::thread_pool() const {
+    return compile_pool;
+}
+
+std::vector<ast::optimize::PassStatistics> PljitFunction::optimization_statistics() const {
+    if (!function_compiled.load()) {
+        return {};
+    }
+    return active.load(std::memory_order_acquire)->optimization_statistics();
+}
+
+std::shared_ptr<const CompiledFunction> PljitFunction::compiled_function() const {
+    if (!function_compiled.load()) {
+        return nullptr;
+    }
+    if (promotion && promotion->ready.load(std::memory_order_acquire) && active.load(std::memory_order_acquire) == promotion->function.get()) {
+        return promotion->function;
+    }
+    return compiled;
+}
+
+TierStatistics PljitFunction::tier_statistics() const {
+    TierStatistics statistics;
+    statistics.tier_up_threshold = options.tier_up_threshold;
+    statistics.baseline_calls = baseline_calls.load(std::memory_order_relaxed);
+    if (!promotion) {
+        return statistics;
+    }
+
+    bool ready = promotion->ready.load(std::memory_order_acquire);
+    bool promoted = ready && active.load(std::memory_order_acquire) == promotion->function.get();
+    statistics.tier = promoted ? ExecutionTier::OPTIMIZED : ExecutionTier::BASELINE;
+    statistics.promotion_pending = tier_state.load(std::memory_order_acquire) == TierState::PROMOTING && !ready;
+    statistics.promotion_time = promoted ? promotion->time : std::chrono::nanoseconds{ 0 };
+    return statistics;
+}
+
+SpeculationStatistics PljitFunction::speculation_statistics() const {
+    SpeculationStatistics statistics;
+    if (!function_compiled.load() || !speculation) {
+        return statistics;
+    }
+
+    statistics.state = speculation_state.load(std::memory_order_acquire);
+    statistics.profiled_calls = std::min(speculation->profiled_calls.load(std::memory_order_relaxed), options.value_profile_calls);
+    if (statistics.state != SpeculationState::PROFILING) {
+        // assigned before profiling completed
+        statistics.guarded_values = speculation->guards;
+    }
+    statistics.guard_hits = speculation->hits.load(std::memory_order_relaxed);
+    statistics.guard_misses = speculation->misses.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+MemoizationStatistics PljitFunction::memoization_statistics() const {
+    if (!function_compiled.load() || !memoization) {
+        return {};
+    }
+    return memoization->statistics();
+}
+
+const std::vector<std::optional<long long>>& PljitFunction::bound_parameters() const {
+    return parameter_bindings;
 }
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -5,34 +5,133 @@
 #ifndef PLJIT_PLJITFUNCTION_HPP
 #define PLJIT_PLJITFUNCTION_HPP
 
-#include "./code/SourceCodeManagement.hpp"
-#include "./ast/AST.hpp"
+#include "./CompileCache.hpp"
+#include "./CompileOptions.hpp"
+#include "./CompiledFunction.hpp"
+#include "./MemoizationCache.hpp"
+#include "./SpeculationStatistics.hpp"
+#include "./TierStatistics.hpp"
+#include "./util/ThreadPool.hpp"
 #include <atomic>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
 /**
- * A Pljit Function instance. This object holds the source code and the compiled AST.
+ * A Pljit Function instance. This object holds the source code till it is compiled,
+ * and the `CompiledFunction` afterwards.
+ *
+ * With tiered execution, the function is compiled for the baseline tier first and counts its calls.
+ * Crossing the `CompileOptions::tier_up_threshold` starts compiling the optimized tier, which is picked up
+ * by the first call after the compilation completed. Both tiers are kept till the function is destroyed,
+ * as evaluations of the baseline tier might still be in progress.
+ *
+ * With value profiling, the first calls sample their arguments. Parameters which turned out to be stable are
+ * speculated: a version assuming their values is compiled like the optimized tier and evaluates the calls
+ * whose arguments match. It is dropped if the guard misses too often, but kept alive like the tiers.
+ *
+ * With memoization, calls are answered from a `MemoizationCache` in front of all of the above. Only the calls
+ * missing the cache are evaluated, counted for the tier promotion and profiled.
  */
 class PljitFunction {
-    /// Source code of the function.
-    code::SourceCodeManagement source_code;
+    /// Progress of the promotion to the optimized tier.
+    enum class TierState : std::uint8_t {
+        /// Calls are counted till the threshold is crossed.
+        COUNTING,
+        /// The optimized tier is compiled in the background.
+        PROMOTING,
+        /// No further tier transitions, calls aren't counted anymore.
+        SETTLED,
+    };
+    /// The compilation of the optimized tier, shared with the background task compiling it.
+    /// The task never accesses the `PljitFunction`, which might be destroyed before the task completes.
+    struct Promotion {
+        /// Set once `function` and `time` were assigned.
+        std::atomic<bool> ready{ false };
+        std::shared_ptr<const CompiledFunction> function;
+        std::chrono::nanoseconds time{ 0 };
+    };
+
+    /// The value profile and the speculative version, shared with the background task compiling it.
+    struct Speculation {
+        /// Per parameter: the candidate elected by a majority vote over the first half of the profiled calls,
+        /// the votes of the candidate and the number of calls of the second half passing the candidate.
+        std::vector<std::atomic<long long>> candidates;
+        std::vector<std::atomic<std::uint64_t>> votes;
+        std::vector<std::atomic<std::uint64_t>> matches;
+        std::atomic<std::uint64_t> profiled_calls{ 0 };
+        /// The speculated value of every parameter. Immutable once profiling completed.
+        std::vector<std::optional<long long>> guards;
+        /// Set once `function` was assigned.
+        std::atomic<bool> ready{ false };
+        std::shared_ptr<const CompiledFunction> function;
+        std::atomic<std::uint64_t> hits{ 0 };
+        std::atomic<std::uint64_t> misses{ 0 };
+
+        explicit Speculation(std::size_t parameter_count);
+    };
+
+    /// A parameter is speculated if at least this percentage of the second half of the profiled calls passed its candidate.
+    static constexpr std::uint64_t STABLE_PERCENTAGE = 90;
+    /// The speculative version is dropped once the guard missed this many times
+    /// and for more than a fifth of the guarded calls.
+    static constexpr std::uint64_t DROP_MIN_MISSES = 64;
+
+    /// Source code of the function. Moved into the `CompiledFunction` (or dropped on a cache hit) once compiled.
+    std::string source_code;
+    /// Options controlling compilation and execution of the function.
+    CompileOptions options;
+    /// The thread pool used for asynchronous compilation. Might be null.
+    ThreadPool* compile_pool;
+    /// The cache used to share compilations of the same source code. Might be null.
+    CompileCache* compile_cache;
+    /// The persistent cache used if there is no `compile_cache`. Might be null.
+    const CodeCache* code_cache;
+    /// Parameters turned into constants, see `Pljit::specialize`. Functions with bound parameters bypass both caches.
+    std::vector<std::optional<long long>> parameter_bindings;
 
     /// Atomic bool which makes it easy and fast to check if the function was already compiled.
     std::atomic<bool> function_compiled;
     /// A mutex to ensure mutual exclusion when compiling the function.
     std::mutex compile_mutex;
 
-    /// The compiled AST. Present if compiled and no compilation error occurred.
-    std::optional<ast::Function> function;
-    /// A potential compilation error. Present if compiled and a compilation error occurred.
-    std::optional<code::SourceCodeError> compilation_error_val;
+    /// The compiled function, possibly shared with other `PljitFunction`s. Present once compiled.
+    /// With tiered execution, this is the baseline tier.
+    std::shared_ptr<const CompiledFunction> compiled;
+    /// The tier evaluations are executed with. Either `compiled` or the function of `promotion`. Set once compiled.
+    std::atomic<const CompiledFunction*> active;
+
+    std::atomic<TierState> tier_state;
+    /// Calls evaluated in the baseline tier.
+    std::atomic<std::uint64_t> baseline_calls;
+    /// Present if tiered execution is enabled.
+    std::shared_ptr<Promotion> promotion;
+    /// Completes once the optimized tier was compiled. Destroying it waits for a compilation running on its own thread.
+    std::future<void> promotion_compilation;
+
+    std::atomic<SpeculationState> speculation_state;
+    /// Present once compiled if value profiling is enabled and the function has parameters.
+    std::shared_ptr<Speculation> speculation;
+    /// Completes once the speculative version was compiled. Destroying it waits for a compilation running on its own thread.
+    std::future<void> speculation_compilation;
+
+    /// Present once compiled if memoization is enabled and the function compiled successfully.
+    std::unique_ptr<MemoizationCache> memoization;
 
     public:
-    explicit PljitFunction(std::string&& source_code);
+    explicit PljitFunction(
+        std::string&& source_code,
+        CompileOptions options = {},
+        ThreadPool* compile_pool = nullptr,
+        CompileCache* compile_cache = nullptr,
+        const CodeCache* code_cache = nullptr,
+        std::vector<std::optional<long long>> parameter_bindings = {}
+    );
 
     // We can't safely copy or move without encountering any potential synchronization issues.
     PljitFunction(const PljitFunction& other) = delete;
@@ -41,13 +140,30 @@ class PljitFunction {
     /**
      * A call to this function will evaluate the function.
      * The function is compiled before execution if it wasn't compiled yet.
-     * @param arguments The vector of arguments passed to the compiled function.
+     * @param arguments The arguments passed to the compiled function.
      * @return Returns the value of the function evaluation. The optional might be empty if
      * either a compilation error or a runtime error occurred.
      * You can use the `compilation_error()` getter to get access to the compilation error.
-     * Runtime errors are printed to standard out.
+     * Runtime errors are reported to the `RuntimeErrorHandler` of the `CompileOptions`.
      */
-    std::optional<long long> evaluate(const std::vector<long long>& arguments);
+    std::optional<long long> evaluate(std::span<const long long> arguments);
+    /**
+     * Evaluates the function, compiling it first if it wasn't compiled yet.
+     * Runtime errors are returned and never reported to the `RuntimeErrorHandler`.
+     * @param arguments The arguments passed to the compiled function.
+     * @return Returns the `EvaluationResult` holding either the return value or the error.
+     */
+    EvaluationResult call(std::span<const long long> arguments);
+    /**
+     * Evaluates the function for every row of the given argument columns.
+     * See `bytecode::BytecodeFunction::evaluateBatch`. Functions using the AST_INTERPRETER `ExecutionMode`
+     * are evaluated row by row. Returns `RuntimeErrorCode::COMPILATION_ERROR` if the function failed to compile.
+     */
+    RuntimeErrorCode evaluateBatch(
+        std::span<const std::span<const long long>> columns,
+        std::span<long long> output,
+        std::span<std::uint64_t> error_bitmap
+    );
 
     /**
      * A call to this method will ensure that the function is compiled.
@@ -58,6 +174,63 @@ class PljitFunction {
      * @return Returns the compilation error, if one occurred.
      */
     std::optional<code::SourceCodeError> compilation_error() const;
+
+    /**
+     * @return Returns the options the function was registered with.
+     */
+    const CompileOptions& compile_options() const;
+
+    /**
+     * @return Returns the thread pool used for asynchronous compilation. Might be null.
+     */
+    ThreadPool* thread_pool() const;
+
+    /**
+     * @return Returns the statistics of the optimization passes. Empty if not yet compiled.
+     */
+    std::vector<ast::optimize::PassStatistics> optimization_statistics() const;
+
+    /**
+     * @return Returns the `CompiledFunction` of the current tier, null if not yet compiled.
+     */
+    std::shared_ptr<const CompiledFunction> compiled_function() const;
+
+    /**
+     * @return Returns the statistics of the tiered execution of this function.
+     */
+    TierStatistics tier_statistics() const;
+
+    /**
+     * @return Returns the statistics of the value profiling and speculation of this function.
+     */
+    SpeculationStatistics speculation_statistics() const;
+
+    /**
+     * @return Returns the statistics of the result cache of this function.
+     */
+    MemoizationStatistics memoization_statistics() const;
+
+    /**
+     * @return Returns the parameters bound to a constant value, indexed by their position in the source code.
+     */
+    const std::vector<std::optional<long long>>& bound_parameters() const;
+
+    private:
+    /// Evaluates the current tier or the speculative version. The function must be compiled.
+    EvaluationResult execute(std::span<const long long> arguments);
+
+    /// Counts calls in the baseline tier and performs the tier transitions.
+    void countBaselineCalls(std::uint64_t calls);
+    void startPromotion();
+    void completePromotion();
+
+    /// Profiles or guards a call, returns the version evaluating it.
+    const CompiledFunction* speculate(std::span<const long long> arguments, const CompiledFunction* generic);
+    void profile(std::span<const long long> arguments);
+    /// The number of profiled calls electing the candidates.
+    std::uint64_t votingCalls() const;
+    void startSpeculation();
+    void completeSpeculation();
 };
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -0,0 +1,31 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./SpecializationCache.hpp"
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+std::size_t SpecializationCache::KeyHash::operator()(const Key& key) const {
+    std::size_t hash = std::hash<function_id>{}(key.id);
+    hash ^= static_cast<std::size_t>(key.version) * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    for (auto& binding: key.bindings) {
+        std::size_t value = binding ? std::hash<long long>{}(*binding) + 1 : 0;
+        hash ^= value * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+//---------------------------------------------------------------------------
+SpecializationCache::SpecializationCache(std::size_t capacity) : capacity(capacity) {
+    assert(capacity > 0 && "Can't construct a SpecializationCache without capacity!");
+}
+
+std::size_t SpecializationCache::size() {
+    std::lock_guard lock{ mutex };
+    return entries.size();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
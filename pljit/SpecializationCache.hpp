@@ -0,0 +1,112 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_SPECIALIZATIONCACHE_HPP
+#define PLJIT_SPECIALIZATIONCACHE_HPP
+
+#include "./FunctionRegistry.hpp"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * The specializations created through `Pljit::specialize`, keyed by the specialized function, its version
+ * and the bound arguments. Holds at most `capacity` specializations, the least recently used one is evicted first.
+ * Thread-safe.
+ *
+ * Specializations of a replaced or unregistered function are never hit again and age out of the cache.
+ */
+class SpecializationCache {
+    struct Key {
+        function_id id;
+        std::uint64_t version;
+        std::vector<std::optional<long long>> bindings;
+
+        bool operator==(const Key& other) const = default;
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+        Key key;
+        FunctionReference specialization;
+    };
+
+    std::size_t capacity;
+
+    std::mutex mutex;
+    /// Ordered from the most to the least recently used specialization.
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    public:
+    /**
+     * @param capacity The maximum number of cached specializations. Must not be zero.
+     */
+    explicit SpecializationCache(std::size_t capacity);
+
+    /**
+     * Returns the specialization of the given function version for the given bindings, creating it if it isn't cached
+     * or was unregistered.
+     * @param create Called with the lock held to register the specialization, returns its reference.
+     * @param evicted Receives the references to the specializations evicted to stay within the capacity.
+     * The caller must unregister them.
+     */
+    template <typename F>
+    FunctionReference lookup(
+        function_id id,
+        std::uint64_t version,
+        std::vector<std::optional<long long>> bindings,
+        F&& create,
+        std::vector<FunctionReference>& evicted
+    );
+
+    /**
+     * @return Returns the number of cached specializations.
+     */
+    std::size_t size();
+};
+
+template <typename F>
+FunctionReference SpecializationCache::lookup(
+    function_id id,
+    std::uint64_t version,
+    std::vector<std::optional<long long>> bindings,
+    F&& create,
+    std::vector<FunctionReference>& evicted) {
+    Key key{ id, version, std::move(bindings) };
+
+    std::lock_guard lock{ mutex };
+    if (auto existing = index.find(key); existing != index.end()) {
+        Entry& entry = *existing->second;
+        if (!FunctionRegistry::current(entry.specialization)) {
+            // the specialization was unregistered explicitly, its slot might already be reused
+            entry.specialization = create();
+        }
+        entries.splice(entries.begin(), entries, existing->second);
+        return entry.specialization;
+    }
+
+    FunctionReference specialization = create();
+    entries.push_front(Entry{ key, specialization });
+    index.emplace(std::move(key), entries.begin());
+
+    while (entries.size() > capacity) {
+        evicted.push_back(entries.back().specialization);
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    return specialization;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_SPECIALIZATIONCACHE_HPP
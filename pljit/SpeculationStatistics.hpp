@@ -0,0 +1,62 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_SPECULATIONSTATISTICS_HPP
+#define PLJIT_SPECULATIONSTATISTICS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Progress of the value speculation of a function, see `CompileOptions::value_profile_calls`.
+ * Calls are only observed in the states from PROFILING to GUARDED.
+ */
+enum class SpeculationState : std::uint8_t {
+    /// Value profiling is disabled, the function has no parameters or failed to compile.
+    DISABLED,
+    /// The arguments of the calls are sampled.
+    PROFILING,
+    /// The speculative version is compiled in the background.
+    COMPILING,
+    /// Calls whose arguments pass the guard evaluate the speculative version.
+    GUARDED,
+    /// No parameter received a stable value while profiling, calls evaluate the generic version.
+    UNSTABLE,
+    /// The guard missed too often (or the speculative version failed to compile), the speculative version was dropped
+    /// and calls evaluate the generic version.
+    DROPPED,
+};
+//---------------------------------------------------------------------------
+/**
+ * Snapshot of the value speculation of a single function.
+ */
+struct SpeculationStatistics {
+    SpeculationState state = SpeculationState::DISABLED;
+    /// The number of calls whose arguments were sampled.
+    std::uint64_t profiled_calls = 0;
+    /// The speculated value of every parameter, empty for parameters the guard doesn't check.
+    /// Empty till profiling completed.
+    std::vector<std::optional<long long>> guarded_values;
+    /// The number of calls which passed the guard.
+    std::uint64_t guard_hits = 0;
+    /// The number of calls which failed the guard and evaluated the generic version.
+    std::uint64_t guard_misses = 0;
+
+    /**
+     * @return Returns the share of guarded calls which passed the guard. Zero if no call was guarded.
+     */
+    double hit_rate() const {
+        std::uint64_t guarded = guard_hits + guard_misses;
+        return guarded == 0 ? 0.0 : static_cast<double>(guard_hits) / static_cast<double>(guarded);
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_SPECULATIONSTATISTICS_HPP
@@ -25,12 +25,12 @@ std::optional<SymbolTable::Symbol> SymbolTable::retrieveSymbol(symbol_id symbolI
     return { symbols[index] };
 }
 
-std::optional<SymbolTable::Symbol> SymbolTable::retrieveSymbol(std::string_view identifier_name) {
-    if (!symbolLookup.contains(identifier_name)) {
+std::optional<SymbolTable::Symbol> SymbolTable::retrieveSymbol(const parse::Identifier& identifier) {
+    if (identifier.id() >= symbolLookup.size() || symbolLookup[identifier.id()] == 0) {
         return {};
     }
 
-    return { retrieveSymbol(symbolLookup[identifier_name]) };
+    return { retrieveSymbol(symbolLookup[identifier.id()]) };
 }
 
 SymbolTable::Symbol& SymbolTable::operator[](symbol_id symbolId) {
@@ -40,7 +40,7 @@ SymbolTable::Symbol& SymbolTable::operator[](symbol_id symbolId) {
 }
 
 Result<symbol_id> SymbolTable::declareIdentifier(const parse::Identifier& identifier, SymbolType symbolType) {
-    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier.value());
+    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier);
     if (existingSymbol) {
         return identifier.reference()
             .makeError(code::ErrorType::ERROR, "Redefinition of identifier!")
@@ -55,13 +55,16 @@ Result<symbol_id> SymbolTable::declareIdentifier(const parse::Identifier& identi
     bool isInitialized = symbolType == SymbolType::CONST || symbolType == SymbolType::PARAM;
     symbols.emplace_back(identifier.reference(), id, isConstant, isInitialized);
 
-    symbolLookup.emplace(identifier.value(), id);
+    if (identifier.id() >= symbolLookup.size()) {
+        symbolLookup.resize(identifier.id() + 1);
+    }
+    symbolLookup[identifier.id()] = id;
 
     return id;
 }
 
 Result<symbol_id> SymbolTable::useIdentifier(const parse::Identifier& identifier) {
-    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier.value());
+    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier);
     if (!existingSymbol) {
         return identifier.reference()
             .makeError(code::ErrorType::ERROR, "Using undeclared identifier!");
@@ -76,7 +79,7 @@ Result<symbol_id> SymbolTable::useIdentifier(const parse::Identifier& identifier
 }
 
 Result<symbol_id> SymbolTable::useAsAssignmentTarget(const parse::Identifier& identifier) {
-    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier.value());
+    std::optional<Symbol> existingSymbol = retrieveSymbol(identifier);
     if (!existingSymbol) {
         return identifier.reference()
             .makeError(code::ErrorType::ERROR, "Using undeclared identifier!");
@@ -9,7 +9,6 @@
 #include "./code/SourceCode.hpp"
 #include "./parse/ParseTree.hpp"
 #include "./util/Result.hpp"
-#include <unordered_map>
 #include <vector>
 
 //---------------------------------------------------------------------------
@@ -48,7 +47,7 @@ class SymbolTable {
 
     private:
     std::vector<Symbol> symbols; // symbols indexed by their id
-    std::unordered_map<std::string_view, symbol_id> symbolLookup; // symbol ids, indexed by their name!
+    std::vector<symbol_id> symbolLookup; // symbol ids, indexed by the interned `identifier_id` of their name. Zero if undeclared.
 
     public:
     SymbolTable();
@@ -56,7 +55,7 @@ class SymbolTable {
     std::size_t size() const;
 
     std::optional<Symbol> retrieveSymbol(symbol_id symbolId);
-    std::optional<Symbol> retrieveSymbol(std::string_view identifier_name);
+    std::optional<Symbol> retrieveSymbol(const parse::Identifier& identifier);
     Symbol& operator[](symbol_id symbolId);
 
     Result<symbol_id> declareIdentifier(const parse::Identifier& identifier, SymbolType symbolType);
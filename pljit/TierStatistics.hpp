@@ -0,0 +1,43 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_TIERSTATISTICS_HPP
+#define PLJIT_TIERSTATISTICS_HPP
+
+#include <chrono>
+#include <cstdint>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * The tiers of a function using tiered execution, see `CompileOptions::tier_up_threshold`.
+ */
+enum class ExecutionTier : std::uint8_t {
+    /// Compiled with the cheap `CompileOptions::baseline_execution_mode` and `CompileOptions::baseline_optimization_level`.
+    BASELINE,
+    /// Compiled with the `CompileOptions::execution_mode` and `CompileOptions::optimization_level`.
+    OPTIMIZED,
+};
+//---------------------------------------------------------------------------
+/**
+ * Snapshot of the tiered execution of a single function.
+ */
+struct TierStatistics {
+    /// The tier evaluations are currently executed in. Always OPTIMIZED if tiered execution is disabled.
+    ExecutionTier tier = ExecutionTier::OPTIMIZED;
+    /// The number of calls after which the function is promoted. Zero if tiered execution is disabled.
+    std::uint64_t tier_up_threshold = 0;
+    /// The number of calls evaluated in the baseline tier. Batch evaluations count every row.
+    std::uint64_t baseline_calls = 0;
+    /// Whether the optimized tier is currently compiled in the background.
+    bool promotion_pending = false;
+    /// The time spent compiling the optimized tier. Zero till the function was promoted.
+    std::chrono::nanoseconds promotion_time{ 0 };
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_TIERSTATISTICS_HPP
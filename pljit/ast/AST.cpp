@@ -3,43 +3,34 @@
 //
 
 #include "./AST.hpp"
+#include <limits>
 #include <utility>
 
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
-Literal::Literal(long long literal_value) : literal_value(literal_value) {}
+Node::Node(Type type) : type(type) {}
 
-Node::Type Literal::getType() const {
-    return Node::Type::LITERAL;
+Node::Type Node::getType() const {
+    return type;
 }
+//---------------------------------------------------------------------------
+Literal::Literal(long long literal_value) : Node(Type::LITERAL), literal_value(literal_value) {}
 
 void Literal::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 
-std::optional<long long> Literal::evaluate(EvaluationContext&) const {
-    return literal_value;
-}
-
 long long Literal::value() const {
     return literal_value;
 }
 //---------------------------------------------------------------------------
-Variable::Variable(symbol_id symbolId, std::string_view name) : symbolId(symbolId), name(name) {}
-
-Node::Type Variable::getType() const {
-    return Node::Type::VARIABLE;
-}
+Variable::Variable(symbol_id symbolId, std::string_view name) : Node(Type::VARIABLE), symbolId(symbolId), name(name) {}
 
 void Variable::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 
-std::optional<long long> Variable::evaluate(EvaluationContext& context) const {
-    return context[symbolId];
-}
-
 symbol_id Variable::getSymbolId() const {
     return symbolId;
 }
@@ -48,255 +39,240 @@ const std::string_view& Variable::getName() const {
     return name;
 }
 //---------------------------------------------------------------------------
-UnaryExpression::UnaryExpression(std::unique_ptr<Expression> child) : child(std::move(child)) {}
+// keep expression nodes compact, so that four of them share a cache line
+static_assert(sizeof(Expression) == 16);
 
-const Expression& UnaryExpression::getChild() const {
-    return *child;
-}
+Expression::Expression(Type type, std::uint32_t side_table_index) : Node(type), side_table_index(side_table_index), literal_value(0) {}
 
-std::unique_ptr<Expression>& UnaryExpression::getChildPtr() {
-    return child;
+bool Expression::isUnaryExpression() const {
+    return getType() == Type::UNARY_PLUS || getType() == Type::UNARY_MINUS;
 }
-//---------------------------------------------------------------------------
-BinaryExpression::BinaryExpression(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild)
-    : leftChild(std::move(leftChild)), rightChild(std::move(rightChild)) {}
 
-const Expression& BinaryExpression::getLeft() const {
-    return *leftChild;
+bool Expression::isBinaryExpression() const {
+    return getType() >= Type::ADD && getType() <= Type::DIVIDE;
 }
 
-const Expression& BinaryExpression::getRight() const {
-    return *rightChild;
+long long Expression::value() const {
+    assert(getType() == Type::LITERAL && "Expression isn't a literal!");
+    return literal_value;
 }
 
-std::unique_ptr<Expression>& BinaryExpression::getLeftPtr() {
-    return leftChild;
+symbol_id Expression::getSymbolId() const {
+    assert(getType() == Type::VARIABLE && "Expression isn't a variable!");
+    return symbolId;
 }
 
-std::unique_ptr<Expression>& BinaryExpression::getRightPtr() {
-    return rightChild;
+node_index Expression::getChild() const {
+    assert(isUnaryExpression() && "Expression isn't a unary expression!");
+    return children.lhs;
 }
-//---------------------------------------------------------------------------
-UnaryPlus::UnaryPlus(std::unique_ptr<Expression> child) : UnaryExpression(std::move(child)) {}
 
-Node::Type UnaryPlus::getType() const {
-    return Node::Type::UNARY_PLUS;
+node_index Expression::getLeft() const {
+    assert(isBinaryExpression() && "Expression isn't a binary expression!");
+    return children.lhs;
 }
 
-void UnaryPlus::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+node_index Expression::getRight() const {
+    assert(isBinaryExpression() && "Expression isn't a binary expression!");
+    return children.rhs;
 }
 
-std::optional<long long> UnaryPlus::evaluate(EvaluationContext& context) const {
-    return child->evaluate(context);
+void Expression::accept(ASTVisitor& visitor, const ExpressionArena& expressions) const {
+    visitor.visit(*this, expressions);
 }
 //---------------------------------------------------------------------------
-UnaryMinus::UnaryMinus(std::unique_ptr<Expression> child) : UnaryExpression(std::move(child)) {}
-
-Node::Type UnaryMinus::getType() const {
-    return Node::Type::UNARY_MINUS;
-}
+ExpressionArena::ExpressionArena() = default;
 
-void UnaryMinus::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
-}
-
-std::optional<long long> UnaryMinus::evaluate(EvaluationContext& context) const {
-    std::optional<long long> value = child->evaluate(context);
-    if (!value) {
-        return value;
-    }
-    
-    return -(*value);
+node_index ExpressionArena::createLiteral(long long value) {
+    Expression expression{ Node::Type::LITERAL, 0 };
+    expression.literal_value = value;
+    return append(expression);
 }
-//---------------------------------------------------------------------------
-Add::Add(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild)
-    : BinaryExpression(std::move(leftChild), std::move(rightChild)) {}
 
-Node::Type Add::getType() const {
-    return Node::Type::ADD;
+node_index ExpressionArena::createVariable(symbol_id symbolId, std::string_view name) {
+    Expression expression{ Node::Type::VARIABLE, static_cast<std::uint32_t>(variable_names.size()) };
+    expression.symbolId = symbolId;
+    variable_names.push_back(name);
+    return append(expression);
 }
 
-void Add::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+node_index ExpressionArena::createUnary(Node::Type type, node_index child) {
+    Expression expression{ type, 0 };
+    expression.children = { child, child };
+    assert(expression.isUnaryExpression() && "Expected an unary expression type!");
+    return append(expression);
 }
 
-std::optional<long long> Add::evaluate(EvaluationContext& context) const {
-    std::optional<long long> lhs = leftChild->evaluate(context);
-    if (!lhs) {
-        return lhs;
-    }
+node_index ExpressionArena::createBinary(Node::Type type, node_index lhs, node_index rhs, code::SourceCodeReference reference) {
+    Expression expression{ type, 0 };
+    expression.children = { lhs, rhs };
+    assert(expression.isBinaryExpression() && "Expected a binary expression type!");
 
-    std::optional<long long> rhs = rightChild->evaluate(context);
-    if (!rhs) {
-        return rhs;
+    if (type == Node::Type::DIVIDE) {
+        expression.side_table_index = static_cast<std::uint32_t>(division_references.size());
+        division_references.push_back(reference);
     }
-
-
-    return *lhs + *rhs;
+    return append(expression);
 }
-//---------------------------------------------------------------------------
-Subtract::Subtract(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild)
-    : BinaryExpression(std::move(leftChild), std::move(rightChild)) {}
 
-Node::Type Subtract::getType() const {
-    return Node::Type::SUBTRACT;
+node_index ExpressionArena::duplicate(node_index index) {
+    assert(index < nodes.size() && "Encountered illegal node index!");
+    return append(nodes[index]);
 }
 
-void Subtract::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+void ExpressionArena::replaceWithLiteral(node_index index, long long value) {
+    assert(index < nodes.size() && "Encountered illegal node index!");
+    Expression expression{ Node::Type::LITERAL, 0 };
+    expression.literal_value = value;
+    nodes[index] = expression;
 }
 
-std::optional<long long> Subtract::evaluate(EvaluationContext& context) const {
-    std::optional<long long> lhs = leftChild->evaluate(context);
-    if (!lhs) {
-        return lhs;
-    }
-
-    std::optional<long long> rhs = rightChild->evaluate(context);
-    if (!rhs) {
-        return rhs;
-    }
-
-
-    return *lhs - *rhs;
+void ExpressionArena::replaceWithDescendant(node_index index, node_index descendant) {
+    assert(descendant < index && index < nodes.size() && "Encountered illegal node index!");
+    // the copy keeps the side table index, which stays valid as the side tables are never shrunk
+    nodes[index] = nodes[descendant];
 }
-//---------------------------------------------------------------------------
-Multiply::Multiply(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild)
-    : BinaryExpression(std::move(leftChild), std::move(rightChild)) {}
 
-Node::Type Multiply::getType() const {
-    return Node::Type::MULTIPLY;
+void ExpressionArena::replaceWithVariable(node_index index, const Variable& variable) {
+    assert(index < nodes.size() && "Encountered illegal node index!");
+    Expression expression{ Node::Type::VARIABLE, static_cast<std::uint32_t>(variable_names.size()) };
+    expression.symbolId = variable.getSymbolId();
+    variable_names.push_back(variable.getName());
+    nodes[index] = expression;
 }
 
-void Multiply::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+const Expression& ExpressionArena::operator[](node_index index) const {
+    assert(index < nodes.size() && "Encountered illegal node index!");
+    return nodes[index];
 }
 
-std::optional<long long> Multiply::evaluate(EvaluationContext& context) const {
-    std::optional<long long> lhs = leftChild->evaluate(context);
-    if (!lhs) {
-        return lhs;
-    }
-
-    std::optional<long long> rhs = rightChild->evaluate(context);
-    if (!rhs) {
-        return rhs;
-    }
-
-
-    return *lhs * *rhs;
+std::string_view ExpressionArena::getName(const Expression& expression) const {
+    assert(expression.getType() == Node::Type::VARIABLE && "Expression isn't a variable!");
+    return variable_names[expression.side_table_index];
 }
-//---------------------------------------------------------------------------
-Divide::Divide(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild)
-    : BinaryExpression(std::move(leftChild), std::move(rightChild)) {}
 
-Node::Type Divide::getType() const {
-    return Node::Type::DIVIDE;
+const code::SourceCodeReference& ExpressionArena::getReference(const Expression& expression) const {
+    assert(expression.getType() == Node::Type::DIVIDE && "Expression isn't a division!");
+    return division_references[expression.side_table_index];
 }
 
-void Divide::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+std::size_t ExpressionArena::size() const {
+    return nodes.size();
 }
 
-std::optional<long long> Divide::evaluate(EvaluationContext& context) const {
-    std::optional<long long> lhs = leftChild->evaluate(context);
+std::optional<long long> ExpressionArena::evaluate(node_index index, EvaluationContext& context) const {
+    const Expression& expression = nodes[index];
+
+    switch (expression.getType()) {
+        case Node::Type::LITERAL:
+            return expression.literal_value;
+        case Node::Type::VARIABLE:
+            return context[expression.symbolId];
+        case Node::Type::UNARY_PLUS:
+            return evaluate(expression.children.lhs, context);
+        case Node::Type::UNARY_MINUS: {
+            std::optional<long long> value = evaluate(expression.children.lhs, context);
+            if (!value) {
+                return value;
+            }
+
+            return -(*value);
+        }
+        default:
+            break;
+    }
+
+    std::optional<long long> lhs = evaluate(expression.children.lhs, context);
     if (!lhs) {
         return lhs;
     }
 
-    std::optional<long long> rhs = rightChild->evaluate(context);
+    std::optional<long long> rhs = evaluate(expression.children.rhs, context);
     if (!rhs) {
         return rhs;
     }
 
-    if (*rhs == 0) {
-        // we were informed that we don't need to provide line numbers here!
-        context.setRuntimeError("Division by zero!");
-        return {};
+    switch (expression.getType()) {
+        case Node::Type::ADD:
+            return *lhs + *rhs;
+        case Node::Type::SUBTRACT:
+            return *lhs - *rhs;
+        case Node::Type::MULTIPLY:
+            return *lhs * *rhs;
+        case Node::Type::DIVIDE:
+            if (*rhs == 0) {
+                context.setRuntimeError(RuntimeErrorCode::DIVISION_BY_ZERO, division_references[expression.side_table_index]);
+                return {};
+            }
+
+            return *lhs / *rhs;
+        default:
+            assert(false && "Encountered unknown expression type!");
+            return {};
     }
-
-    return *lhs / *rhs;
 }
-//---------------------------------------------------------------------------
-Statement::Statement(std::unique_ptr<Expression> expression) : expression(std::move(expression)) {}
 
-const Expression& Statement::getExpression() const {
-    return *expression;
-}
-
-std::unique_ptr<Expression>& Statement::getExpressionPtr() {
-    return expression;
+node_index ExpressionArena::append(Expression expression) {
+    assert(nodes.size() < std::numeric_limits<node_index>::max() && "Exceeded the maximum number of expressions!");
+    nodes.push_back(expression);
+    return static_cast<node_index>(nodes.size() - 1);
 }
 //---------------------------------------------------------------------------
-AssignmentStatement::AssignmentStatement(std::unique_ptr<Expression> expression, Variable variable)
-    : Statement(std::move(expression)), variable(std::move(variable)) {}
-
-Node::Type AssignmentStatement::getType() const {
-    return Node::Type::ASSIGNMENT_STATEMENT;
-}
+Statement::Statement() : Statement(0) {}
 
-void AssignmentStatement::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
-}
+Statement::Statement(node_index expression)
+    : Node(Type::RETURN_STATEMENT), expression(expression), variable(0, {}) {}
 
-void AssignmentStatement::evaluate(EvaluationContext& context) const {
-    std::optional<long long> value = expression->evaluate(context);
-    if (!value) {
-        return;
-    }
+Statement::Statement(node_index expression, Variable variable)
+    : Node(Type::ASSIGNMENT_STATEMENT), expression(expression), variable(variable) {}
 
-    context[variable.getSymbolId()] = *value;
+node_index Statement::getExpression() const {
+    return expression;
 }
 
-const Variable& AssignmentStatement::getVariable() const {
+const Variable& Statement::getVariable() const {
+    assert(getType() == Type::ASSIGNMENT_STATEMENT && "Only assignments have a target variable!");
     return variable;
 }
-//---------------------------------------------------------------------------
-ReturnStatement::ReturnStatement(std::unique_ptr<Expression> expression) : Statement(std::move(expression)) {}
-
-Node::Type ReturnStatement::getType() const {
-    return Node::Type::RETURN_STATEMENT;
-}
 
-void ReturnStatement::accept(ASTVisitor& visitor) const {
-    visitor.visit(*this);
+void Statement::accept(ASTVisitor& visitor, const ExpressionArena& expressions) const {
+    visitor.visit(*this, expressions);
 }
 
-void ReturnStatement::evaluate(EvaluationContext& context) const {
-    std::optional<long long> value = expression->evaluate(context);
+void Statement::evaluate(const ExpressionArena& expressions, EvaluationContext& context) const {
+    std::optional<long long> value = expressions.evaluate(expression, context);
     if (!value) {
         return;
     }
 
-    context.return_value() = *value;
+    if (getType() == Type::ASSIGNMENT_STATEMENT) {
+        context[variable.getSymbolId()] = *value;
+    } else {
+        context.return_value() = *value;
+    }
 }
 //---------------------------------------------------------------------------
-Declaration::Declaration() : declaredIdentifiers() {}
-Declaration::Declaration(std::vector<Variable> declaredIdentifiers) : declaredIdentifiers(std::move(declaredIdentifiers)) {}
+Declaration::Declaration(Type type) : Node(type), declaredIdentifiers() {}
+Declaration::Declaration(Type type, std::vector<Variable> declaredIdentifiers) : Node(type), declaredIdentifiers(std::move(declaredIdentifiers)) {}
 
 const std::vector<Variable>& Declaration::getDeclaredIdentifiers() const {
     return declaredIdentifiers;
 }
 //---------------------------------------------------------------------------
-ParamDeclaration::ParamDeclaration() = default;
+ParamDeclaration::ParamDeclaration() : Declaration(Type::PARAM_DECLARATION) {}
 ParamDeclaration::ParamDeclaration(std::vector<Variable> declaredIdentifiers)
-    : Declaration(std::move(declaredIdentifiers)) {}
-
-Node::Type ParamDeclaration::getType() const {
-    return Node::Type::PARAM_DECLARATION;
-}
+    : Declaration(Type::PARAM_DECLARATION, std::move(declaredIdentifiers)) {}
 
 void ParamDeclaration::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 
-void ParamDeclaration::evaluate(EvaluationContext& context, std::vector<long long> arguments) const {
+void ParamDeclaration::evaluate(EvaluationContext& context, std::span<const long long> arguments) const {
     if (arguments.size() > declaredIdentifiers.size()) {
-        context.setRuntimeError("Received to many arguments!");
+        context.setRuntimeError(RuntimeErrorCode::TOO_MANY_ARGUMENTS);
         return;
     } else if (arguments.size() < declaredIdentifiers.size()) {
-        context.setRuntimeError("Received to few arguments!");
+        context.setRuntimeError(RuntimeErrorCode::TOO_FEW_ARGUMENTS);
         return;
     }
 
@@ -306,32 +282,27 @@ void ParamDeclaration::evaluate(EvaluationContext& context, std::vector<long lon
     }
 }
 //---------------------------------------------------------------------------
-VarDeclaration::VarDeclaration() = default;
-VarDeclaration::VarDeclaration(std::vector<Variable> declaredIdentifiers) : Declaration(std::move(declaredIdentifiers)) {}
-
-Node::Type VarDeclaration::getType() const {
-    return Node::Type::VAR_DECLARATION;
-}
+VarDeclaration::VarDeclaration() : Declaration(Type::VAR_DECLARATION) {}
+VarDeclaration::VarDeclaration(std::vector<Variable> declaredIdentifiers) : Declaration(Type::VAR_DECLARATION, std::move(declaredIdentifiers)) {}
 
 void VarDeclaration::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 //---------------------------------------------------------------------------
-ConstDeclaration::ConstDeclaration() = default;
+ConstDeclaration::ConstDeclaration() : Declaration(Type::CONST_DECLARATION) {}
 ConstDeclaration::ConstDeclaration(std::vector<Variable> declaredIdentifiers, std::vector<Literal> literalValues)
-    : Declaration(std::move(declaredIdentifiers)), literalValues(std::move(literalValues)) {}
-
-Node::Type ConstDeclaration::getType() const {
-    return Node::Type::CONST_DECLARATION;
-}
+    : Declaration(Type::CONST_DECLARATION, std::move(declaredIdentifiers)), literalValues(std::move(literalValues)) {}
 
 void ConstDeclaration::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 
 void ConstDeclaration::evaluate(EvaluationContext& context) const {
-    for (auto& [variable, literal]: getConstDeclarations()) {
-        context[variable.getSymbolId()] = literal.value();
+    assert(literalValues.size() == declaredIdentifiers.size() && "Reached inconsistent state for ConstDeclaration!");
+
+    // not using `getConstDeclarations()` here, as evaluation must not allocate.
+    for (std::size_t index = 0; index < declaredIdentifiers.size(); ++index) {
+        context[declaredIdentifiers[index].getSymbolId()] = literalValues[index].value();
     }
 }
 
@@ -358,36 +329,44 @@ std::vector<std::tuple<const Variable&, const Literal&>> ConstDeclaration::getCo
     return vector;
 }
 //---------------------------------------------------------------------------
-Function::Function() : total_symbols(0) {}
+Function::Function() : Node(Type::FUNCTION), total_symbols(0) {}
 Function::Function(
     std::optional<ParamDeclaration> paramDeclaration,
     std::optional<VarDeclaration> varDeclaration,
     std::optional<ConstDeclaration> constDeclaration,
-    std::vector<std::unique_ptr<Statement>> statements,
+    std::vector<Statement> statements,
+    ExpressionArena expressions,
     size_t totalSymbols)
-    : paramDeclaration(std::move(paramDeclaration)), varDeclaration(std::move(varDeclaration)), constDeclaration(std::move(constDeclaration)),
-      statements(std::move(statements)),
+    : Node(Type::FUNCTION),
+      paramDeclaration(std::move(paramDeclaration)), varDeclaration(std::move(varDeclaration)), constDeclaration(std::move(constDeclaration)),
+      statements(std::move(statements)), expressions(std::move(expressions)),
       total_symbols(totalSymbols) {}
 
-Node::Type Function::getType() const {
-    return Node::Type::FUNCTION;
-}
-
 void Function::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
 }
 
-EvaluationContext Function::evaluate(const std::vector<long long>& arguments) const {
-    EvaluationContext context{ total_symbols };
+EvaluationContext Function::evaluate(std::span<const long long> arguments) const {
+    EvaluationContext context;
+    evaluate(arguments, context);
+    return context;
+}
+
+EvaluationContext Function::evaluate(std::initializer_list<long long> arguments) const {
+    return evaluate(std::span<const long long>{ arguments.begin(), arguments.size() });
+}
+
+void Function::evaluate(std::span<const long long> arguments, EvaluationContext& context) const {
+    context.reset(total_symbols);
 
     if (paramDeclaration) {
         paramDeclaration->evaluate(context, arguments);
     } else if (!arguments.empty()) {
-        context.setRuntimeError("Provided arguments to function with missing PARAM declaration!");
+        context.setRuntimeError(RuntimeErrorCode::UNEXPECTED_ARGUMENTS);
     }
 
     if (context.runtime_error()) {
-        return context;
+        return;
     }
 
     if (constDeclaration) {
@@ -395,12 +374,12 @@ EvaluationContext Function::evaluate(const std::vector<long long>& arguments) co
     }
 
     for (auto& statement: statements) {
-        statement->evaluate(context);
+        statement.evaluate(expressions, context);
 
         // With the assumption that the dead code elimination optimization was run, we could omit this check.
         // However, we don't want to build upon this assumption.
         if (context.return_value() || context.runtime_error()) {
-            return context;
+            return;
         }
     }
 
@@ -408,6 +387,84 @@ EvaluationContext Function::evaluate(const std::vector<long long>& arguments) co
     assert(false && "Fatal error occurred. Illegal AST. No return statement was provided!");
 }
 
+void Function::bindParameters(std::span<const std::optional<long long>> bindings) {
+    assert(paramDeclaration ? bindings.size() <= paramDeclaration->getDeclaredIdentifiers().size() : bindings.empty());
+    if (!paramDeclaration) {
+        return;
+    }
+
+    std::vector<Variable> parameters;
+    std::vector<Variable> constants;
+    std::vector<Literal> values;
+    if (constDeclaration) {
+        for (auto& [variable, literal]: constDeclaration->getConstDeclarations()) {
+            constants.push_back(variable);
+            values.push_back(literal);
+        }
+    }
+
+    std::vector<bool> assigned(total_symbols);
+    for (auto& statement: statements) {
+        if (statement.getType() == Node::Type::ASSIGNMENT_STATEMENT) {
+            assigned[statement.getVariable().getSymbolId() - 1] = true;
+        }
+    }
+
+    std::vector<Variable> variables;
+    if (varDeclaration) {
+        variables = varDeclaration->getDeclaredIdentifiers();
+    }
+    std::vector<Statement> initializations;
+
+    const std::vector<Variable>& declared = paramDeclaration->getDeclaredIdentifiers();
+    for (std::size_t index = 0; index < declared.size(); ++index) {
+        if (index >= bindings.size() || !bindings[index]) {
+            parameters.push_back(declared[index]);
+        } else if (assigned[declared[index].getSymbolId() - 1]) {
+            // the backends assume constants are never written, so it becomes a variable initialized by the first statements
+            variables.push_back(declared[index]);
+            initializations.emplace_back(expressions.createLiteral(*bindings[index]), declared[index]);
+        } else {
+            // constants are initialized like parameters, before the first statement
+            constants.push_back(declared[index]);
+            values.emplace_back(*bindings[index]);
+        }
+    }
+
+    if (parameters.empty()) {
+        paramDeclaration.reset();
+    } else {
+        paramDeclaration.emplace(std::move(parameters));
+    }
+    if (!constants.empty()) {
+        constDeclaration.emplace(std::move(constants), std::move(values));
+    }
+    if (!initializations.empty()) {
+        varDeclaration.emplace(std::move(variables));
+        statements.insert(statements.begin(), initializations.begin(), initializations.end());
+    }
+}
+
+void Function::assumeParameters(std::span<const std::optional<long long>> assumptions) {
+    assert(paramDeclaration ? assumptions.size() <= paramDeclaration->getDeclaredIdentifiers().size() : assumptions.empty());
+    assumed_parameters.assign(assumptions.begin(), assumptions.end());
+}
+
+Variable Function::declareTemporary() {
+    // identifiers can't contain a `$`
+    std::string& name = temporary_names.emplace_back(1, '$');
+    name += std::to_string(temporary_names.size() - 1);
+    Variable variable{ ++total_symbols, name };
+
+    std::vector<Variable> variables;
+    if (varDeclaration) {
+        variables = varDeclaration->getDeclaredIdentifiers();
+    }
+    variables.push_back(variable);
+    varDeclaration.emplace(std::move(variables));
+    return variable;
+}
+
 const std::optional<ParamDeclaration>& Function::getParamDeclaration() const {
     return paramDeclaration;
 }
@@ -420,14 +477,26 @@ const std::optional<ConstDeclaration>& Function::getConstDeclaration() const {
     return constDeclaration;
 }
 
-const std::vector<std::unique_ptr<Statement>>& Function::getStatements() const {
+const std::vector<Statement>& Function::getStatements() const {
     return statements;
 }
 
-std::vector<std::unique_ptr<Statement>>& Function::getStatements() {
+std::vector<Statement>& Function::getStatements() {
     return statements;
 }
 
+const ExpressionArena& Function::getExpressions() const {
+    return expressions;
+}
+
+ExpressionArena& Function::getExpressions() {
+    return expressions;
+}
+
+const std::vector<std::optional<long long>>& Function::getAssumedParameters() const {
+    return assumed_parameters;
+}
+
 std::size_t Function::symbol_count() const {
     return total_symbols;
 }
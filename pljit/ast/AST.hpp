@@ -8,16 +8,23 @@
 #include "./ASTVisitor.hpp"
 #include "../SymbolTable.hpp"
 #include "../EvaluationContext.hpp"
-#include <memory>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
 #include <optional>
+#include <span>
+#include <string>
 #include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
+/// Index of an `Expression` inside the `ExpressionArena` of its `Function`.
+using node_index = std::uint32_t;
+//---------------------------------------------------------------------------
 class Node {
     public:
-    enum class Type {
+    enum class Type : std::uint8_t {
         // EXPRESSIONS
         LITERAL,
         VARIABLE,
@@ -44,177 +51,178 @@ class Node {
         FUNCTION,
     };
 
-    Node() = default;
-    virtual ~Node() = default;
-
-    /**
-     * @return Returns the type of AST Node.
-     */
-    virtual Type getType() const = 0;
-    virtual void accept(ASTVisitor& visitor) const = 0;
-};
+    private:
+    /// The type tag, stored instead of resolving the type through a virtual call.
+    Type type;
 
+    protected:
+    explicit Node(Type type);
 
-class Expression: public Node {
     public:
     /**
-     * Evaluates the Expression.
-     * @param context The EvaluationContext used for the evaluation.
-     * @return Returns the value of the expression. Returns an empty optional if a runtime error occurred.
+     * @return Returns the type of AST Node.
      */
-    virtual std::optional<long long> evaluate(EvaluationContext& context) const = 0;
+    Type getType() const;
 };
 
-class Literal: public Expression {
+class Literal: public Node {
     long long literal_value;
     public:
     explicit Literal(long long literal_value);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
+    void accept(ASTVisitor& visitor) const;
 
     long long value() const;
 };
 
-class Variable: public Expression {
+class Variable: public Node {
     symbol_id symbolId;
     std::string_view name;
 
     public:
     explicit Variable(symbol_id symbolId, std::string_view name);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
+    void accept(ASTVisitor& visitor) const;
 
     symbol_id getSymbolId() const;
     const std::string_view& getName() const;
 };
 
-class UnaryExpression: public Expression {
-    protected:
-    std::unique_ptr<Expression> child;
+/**
+ * A single expression node. Expressions aren't allocated individually but stored in the `ExpressionArena`
+ * of their `Function` and refer to their children by `node_index`.
+ * The type is one of LITERAL, VARIABLE, UNARY_PLUS, UNARY_MINUS, ADD, SUBTRACT, MULTIPLY or DIVIDE.
+ */
+class Expression: public Node {
+    friend class ExpressionArena;
 
-    public:
-    explicit UnaryExpression(std::unique_ptr<Expression> child);
+    struct Children {
+        node_index lhs;
+        node_index rhs;
+    };
 
-    const Expression& getChild() const;
-    std::unique_ptr<Expression>& getChildPtr();
-};
+    /// VARIABLE: index into the variable names, DIVIDE: index into the division references of the arena.
+    std::uint32_t side_table_index;
+    union {
+        long long literal_value;
+        symbol_id symbolId;
+        /// The only child of unary expressions is stored in `lhs`.
+        Children children;
+    };
 
-class BinaryExpression: public Expression {
-    protected:
-    std::unique_ptr<Expression> leftChild;
-    std::unique_ptr<Expression> rightChild;
+    Expression(Type type, std::uint32_t side_table_index);
 
     public:
-    BinaryExpression(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild);
+    bool isUnaryExpression() const;
+    bool isBinaryExpression() const;
 
-    const Expression& getLeft() const;
-    const Expression& getRight() const;
-
-    std::unique_ptr<Expression>& getLeftPtr();
-    std::unique_ptr<Expression>& getRightPtr();
-};
+    /// The value of a LITERAL.
+    long long value() const;
+    /// The symbol of a VARIABLE.
+    symbol_id getSymbolId() const;
 
-class UnaryPlus: public UnaryExpression {
-    public:
-    explicit UnaryPlus(std::unique_ptr<Expression> child);
+    /// The child of a UNARY_PLUS or UNARY_MINUS.
+    node_index getChild() const;
+    /// The left child of a binary expression.
+    node_index getLeft() const;
+    /// The right child of a binary expression.
+    node_index getRight() const;
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
+    void accept(ASTVisitor& visitor, const ExpressionArena& expressions) const;
 };
 
-class UnaryMinus: public UnaryExpression {
-    public:
-    explicit UnaryMinus(std::unique_ptr<Expression> child);
-
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
-};
+/**
+ * Flat storage of all expressions of a `Function`.
+ * Children are always created before their parent, so an expression tree occupies a contiguous
+ * range of the arena, ending with its root.
+ * Nodes are never freed individually. Expressions detached by an optimization stay in the arena
+ * till the whole `Function` is destroyed.
+ */
+class ExpressionArena {
+    std::vector<Expression> nodes;
+    std::vector<std::string_view> variable_names;
+    /// The division expressions, used to report division by zero errors.
+    std::vector<code::SourceCodeReference> division_references;
 
-class Add: public BinaryExpression {
     public:
-    Add(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild);
-
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
-};
+    ExpressionArena();
 
-class Subtract: public BinaryExpression {
-    public:
-    Subtract(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild);
+    node_index createLiteral(long long value);
+    node_index createVariable(symbol_id symbolId, std::string_view name);
+    node_index createUnary(Node::Type type, node_index child);
+    node_index createBinary(Node::Type type, node_index lhs, node_index rhs, code::SourceCodeReference reference = {});
+    /**
+     * Appends a copy of the given expression, which shares the children of the original.
+     * The original must be replaced or detached afterwards, so that every expression keeps a single parent.
+     */
+    node_index duplicate(node_index index);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
-};
+    /**
+     * Replaces the given expression with a LITERAL in place. Its previous children are detached.
+     */
+    void replaceWithLiteral(node_index index, long long value);
+    /**
+     * Replaces the given expression with a copy of one of its descendants in place. Every other child is detached.
+     */
+    void replaceWithDescendant(node_index index, node_index descendant);
+    /**
+     * Replaces the given expression with a VARIABLE in place. Its previous children are detached.
+     */
+    void replaceWithVariable(node_index index, const Variable& variable);
 
-class Multiply: public BinaryExpression {
-    public:
-    Multiply(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild);
+    const Expression& operator[](node_index index) const;
+    /// The name of a VARIABLE expression.
+    std::string_view getName(const Expression& expression) const;
+    /// The source code of a DIVIDE expression.
+    const code::SourceCodeReference& getReference(const Expression& expression) const;
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
-};
+    /**
+     * @return Returns the number of nodes stored in the arena, including detached ones.
+     */
+    std::size_t size() const;
 
-class Divide: public BinaryExpression {
-    public:
-    Divide(std::unique_ptr<Expression> leftChild, std::unique_ptr<Expression> rightChild);
+    /**
+     * Evaluates the Expression.
+     * @param index The expression to evaluate.
+     * @param context The EvaluationContext used for the evaluation.
+     * @return Returns the value of the expression. Returns an empty optional if a runtime error occurred.
+     */
+    std::optional<long long> evaluate(node_index index, EvaluationContext& context) const;
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    std::optional<long long> evaluate(EvaluationContext& context) const override;
+    private:
+    node_index append(Expression expression);
 };
 
+/**
+ * An ASSIGNMENT_STATEMENT or RETURN_STATEMENT.
+ */
 class Statement: public Node {
-    protected:
-    std::unique_ptr<Expression> expression;
-
-    public:
-    explicit Statement(std::unique_ptr<Expression> expression);
-
-    const Expression& getExpression() const;
-    std::unique_ptr<Expression>& getExpressionPtr();
-
-
-    virtual void evaluate(EvaluationContext& context) const = 0;
-};
-
-class AssignmentStatement: public Statement {
+    node_index expression;
+    /// The assigned Variable of an ASSIGNMENT_STATEMENT.
     Variable variable;
 
     public:
-    AssignmentStatement(std::unique_ptr<Expression> expression, Variable variable);
-
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    void evaluate(EvaluationContext& context) const override;
+    Statement();
+    /// Creates a RETURN_STATEMENT.
+    explicit Statement(node_index expression);
+    /// Creates an ASSIGNMENT_STATEMENT.
+    Statement(node_index expression, Variable variable);
 
+    node_index getExpression() const;
     const Variable& getVariable() const;
-};
 
-class ReturnStatement: public Statement {
-    public:
-    explicit ReturnStatement(std::unique_ptr<Expression> expression);
-
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    void evaluate(EvaluationContext& context) const override;
+    void accept(ASTVisitor& visitor, const ExpressionArena& expressions) const;
+    void evaluate(const ExpressionArena& expressions, EvaluationContext& context) const;
 };
 
 class Declaration: public Node {
     protected:
     std::vector<Variable> declaredIdentifiers;
-    public:
-    Declaration();
-    explicit Declaration(std::vector<Variable> declaredIdentifiers);
 
+    explicit Declaration(Type type);
+    Declaration(Type type, std::vector<Variable> declaredIdentifiers);
+
+    public:
     const std::vector<Variable>& getDeclaredIdentifiers() const;
 };
 
@@ -223,9 +231,8 @@ class ParamDeclaration: public Declaration {
     ParamDeclaration();
     explicit ParamDeclaration(std::vector<Variable> declaredIdentifiers);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    void evaluate(EvaluationContext& context, std::vector<long long> arguments) const;
+    void accept(ASTVisitor& visitor) const;
+    void evaluate(EvaluationContext& context, std::span<const long long> arguments) const;
 };
 
 class VarDeclaration: public Declaration {
@@ -233,8 +240,7 @@ class VarDeclaration: public Declaration {
     VarDeclaration();
     explicit VarDeclaration(std::vector<Variable> declaredIdentifiers);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
+    void accept(ASTVisitor& visitor) const;
 };
 
 class ConstDeclaration: public Declaration {
@@ -243,8 +249,7 @@ class ConstDeclaration: public Declaration {
     ConstDeclaration();
     ConstDeclaration(std::vector<Variable> declaredIdentifiers, std::vector<Literal> literalValues);
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
+    void accept(ASTVisitor& visitor) const;
     void evaluate(EvaluationContext& context) const;
 
     std::vector<std::tuple<const Variable&, const Literal&>> getConstDeclarations() const;
@@ -255,7 +260,11 @@ class Function: public Node {
     std::optional<VarDeclaration> varDeclaration;
     std::optional<ConstDeclaration> constDeclaration;
 
-    std::vector<std::unique_ptr<Statement>> statements;
+    std::vector<Statement> statements;
+    ExpressionArena expressions;
+    std::vector<std::optional<long long>> assumed_parameters;
+    /// Names of the variables introduced through `declareTemporary`. Their addresses stay stable, even if moved.
+    std::deque<std::string> temporary_names;
 
     std::size_t total_symbols;
 
@@ -264,7 +273,8 @@ class Function: public Node {
     Function(std::optional<ParamDeclaration> paramDeclaration,
              std::optional<VarDeclaration> varDeclaration,
              std::optional<ConstDeclaration> constDeclaration,
-             std::vector<std::unique_ptr<Statement>> statements,
+             std::vector<Statement> statements,
+             ExpressionArena expressions,
              size_t totalSymbols
      );
 
@@ -273,15 +283,51 @@ class Function: public Node {
     // Move Assignment
     Function& operator=(Function&& other) noexcept = default;
 
-    Type getType() const override;
-    void accept(ASTVisitor& visitor) const override;
-    EvaluationContext evaluate(const std::vector<long long>& arguments) const;
+    void accept(ASTVisitor& visitor) const;
+    /**
+     * Evaluates the function.
+     * @param arguments The arguments passed to the function.
+     * @return Returns the `EvaluationContext` holding either the return value or a runtime error.
+     */
+    EvaluationContext evaluate(std::span<const long long> arguments) const;
+    EvaluationContext evaluate(std::initializer_list<long long> arguments) const;
+    /**
+     * Evaluates the function using a caller supplied context, which is reset beforehand.
+     * Reusing the same context for repeated evaluations avoids any heap allocations.
+     */
+    void evaluate(std::span<const long long> arguments, EvaluationContext& context) const;
+
+    /**
+     * Turns parameters into constants of the function, so the optimization passes fold them away.
+     * The remaining parameters keep their order. The function has no PARAM declaration if every parameter was bound.
+     * Bound parameters which are assigned by the function become variables assigned their value by the first statements instead.
+     * @param bindings The value of every parameter in declaration order, empty for parameters which stay parameters.
+     * Must not hold more entries than the function declares parameters, parameters past its end stay unbound.
+     */
+    void bindParameters(std::span<const std::optional<long long>> bindings);
+    /**
+     * Lets the optimization passes assume the given parameter values. Unlike `bindParameters`, the parameters stay
+     * part of the signature: the function must only be evaluated with matching arguments, e.g. by guarding the call.
+     * @param assumptions The value of every parameter in declaration order, empty for parameters without assumption.
+     */
+    void assumeParameters(std::span<const std::optional<long long>> assumptions);
+    /**
+     * Declares a variable introduced by an optimization pass, e.g. to hold a shared subexpression.
+     * It is appended to the VAR declaration and receives the next free `symbol_id`, growing `symbol_count()`.
+     * Its name can't collide with an identifier of the source code.
+     * @return Returns the declared variable.
+     */
+    Variable declareTemporary();
 
     const std::optional<ParamDeclaration>& getParamDeclaration() const;
     const std::optional<VarDeclaration>& getVarDeclaration() const;
     const std::optional<ConstDeclaration>& getConstDeclaration() const;
-    const std::vector<std::unique_ptr<Statement>>& getStatements() const;
-    std::vector<std::unique_ptr<Statement>>& getStatements();
+    const std::vector<Statement>& getStatements() const;
+    std::vector<Statement>& getStatements();
+    const ExpressionArena& getExpressions() const;
+    ExpressionArena& getExpressions();
+    /// The values of the parameters assumed through `assumeParameters`, indexed by their declaration order.
+    const std::vector<std::optional<long long>>& getAssumedParameters() const;
 
     std::size_t symbol_count() const;
 };
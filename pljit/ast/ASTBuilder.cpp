@@ -7,19 +7,20 @@
 #include "pljit/parse/ParseTree.hpp"
 #include "pljit/code/SourceCode.hpp"
 #include "pljit/lang.hpp"
+#include <utility>
 
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
-ASTBuilder::ASTBuilder() : symbolTable() {}
+ASTBuilder::ASTBuilder() : symbolTable(), expressions() {}
 
 Result<Function> ASTBuilder::analyzeFunction(const parse::FunctionDefinition& node) {
-    Result<std::unique_ptr<Statement>> result;
+    Result<Statement> result;
 
     std::optional<ParamDeclaration> paramDeclaration;
     std::optional<VarDeclaration> varDeclaration;
     std::optional<ConstDeclaration> constDeclaration;
-    std::vector<std::unique_ptr<Statement>> statements;
+    std::vector<Statement> statements;
 
     if (node.getParameterDeclarations()) {
         auto declResult = analyzeParamDeclaration(*node.getParameterDeclarations());
@@ -71,12 +72,13 @@ Result<Function> ASTBuilder::analyzeFunction(const parse::FunctionDefinition& no
         std::move(varDeclaration),
         std::move(constDeclaration),
         std::move(statements),
+        std::exchange(expressions, {}),
         symbolTable.size()
     };
 
     bool found_return = false;
     for (auto& statement: function.getStatements()) {
-        if (statement->getType() == Node::Type::RETURN_STATEMENT) {
+        if (statement.getType() == Node::Type::RETURN_STATEMENT) {
             found_return = true;
             break;
         }
@@ -173,8 +175,8 @@ Result<ConstDeclaration> ASTBuilder::analyzeConstDeclaration(const parse::Consta
     return ConstDeclaration{ variables, literals };
 }
 
-Result<std::unique_ptr<Statement>> ASTBuilder::analyzeStatement(const parse::Statement& node) {
-    Result<std::unique_ptr<Expression>> result;
+Result<Statement> ASTBuilder::analyzeStatement(const parse::Statement& node) {
+    Result<node_index> result;
 
     switch (node.getType()) {
         case parse::Statement::Type::ASSIGNMENT: {
@@ -190,11 +192,10 @@ Result<std::unique_ptr<Statement>> ASTBuilder::analyzeStatement(const parse::Sta
                 return target.error();
             }
 
-            std::unique_ptr<Statement> statement = std::make_unique<AssignmentStatement>(
+            return Statement{
                 result.release(),
                 Variable{ target.release(), assignment.getIdentifier().value() }
-            );
-            return statement;
+            };
         }
         case parse::Statement::Type::RETURN: {
             auto [returnKeyword, additiveExpression] = node.asReturnExpression();
@@ -204,8 +205,7 @@ Result<std::unique_ptr<Statement>> ASTBuilder::analyzeStatement(const parse::Sta
                 return result.error();
             }
 
-            std::unique_ptr<Statement> statement = std::make_unique<ReturnStatement>(result.release());
-            return statement;
+            return Statement{ result.release() };
         }
         case parse::Statement::Type::NONE:
             return node.reference()
@@ -214,8 +214,8 @@ Result<std::unique_ptr<Statement>> ASTBuilder::analyzeStatement(const parse::Sta
 
     return {};
 }
-Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::AdditiveExpression& node) {
-    Result<std::unique_ptr<Expression>> result;
+Result<node_index> ASTBuilder::analyzeExpression(const parse::AdditiveExpression& node) {
+    Result<node_index> result;
 
     result = analyzeExpression(node.getExpression());
     if (!node.getOperand()) {
@@ -226,7 +226,7 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::A
         return result.error();
     }
 
-    std::unique_ptr<Expression> multiplicativeExpression = result.release();
+    node_index multiplicativeExpression = result.release();
     auto [operatorTerminal, additiveExpression] = *node.getOperand();
 
     result = analyzeExpression(additiveExpression);
@@ -235,18 +235,16 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::A
     }
 
     if (operatorTerminal.value() == Operator::PLUS) {
-        std::unique_ptr<Expression> expression = std::make_unique<Add>(std::move(multiplicativeExpression), result.release());
-        return expression;
+        return expressions.createBinary(Node::Type::ADD, multiplicativeExpression, result.release());
     } else if (operatorTerminal.value() == Operator::MINUS) {
-        std::unique_ptr<Expression> expression = std::make_unique<Subtract>(std::move(multiplicativeExpression), result.release());
-        return expression;
+        return expressions.createBinary(Node::Type::SUBTRACT, multiplicativeExpression, result.release());
     } else {
         return node.reference()
             .makeError(code::ErrorType::ERROR, "Encountered illegal parse tree state! Expected PLUS or MINUS!");
     }
 }
-Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::MultiplicativeExpression& node) {
-    Result<std::unique_ptr<Expression>> result;
+Result<node_index> ASTBuilder::analyzeExpression(const parse::MultiplicativeExpression& node) {
+    Result<node_index> result;
 
     result = analyzeExpression(node.getExpression());
     if (!node.getOperand()) {
@@ -257,7 +255,7 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::M
         return result.error();
     }
 
-    std::unique_ptr<Expression> unaryExpression = result.release();
+    node_index unaryExpression = result.release();
     auto [operatorTerminal, multiplicativeExpression] = *node.getOperand();
 
     result = analyzeExpression(multiplicativeExpression);
@@ -266,18 +264,16 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::M
     }
 
     if (operatorTerminal.value() == Operator::MULTIPLICATION) {
-        std::unique_ptr<Expression> expression = std::make_unique<Multiply>(std::move(unaryExpression), result.release());
-        return expression;
+        return expressions.createBinary(Node::Type::MULTIPLY, unaryExpression, result.release());
     } else if (operatorTerminal.value() == Operator::DIVISION) {
-        std::unique_ptr<Expression> expression = std::make_unique<Divide>(std::move(unaryExpression), result.release());
-        return expression;
+        return expressions.createBinary(Node::Type::DIVIDE, unaryExpression, result.release(), node.reference());
     } else {
         return node.reference()
             .makeError(code::ErrorType::ERROR, "Encountered illegal parse tree state! Expected MULTIPLICATION or DIVISION!");
     }
 }
-Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::UnaryExpression& node) {
-    Result<std::unique_ptr<Expression>> result;
+Result<node_index> ASTBuilder::analyzeExpression(const parse::UnaryExpression& node) {
+    Result<node_index> result;
 
     result = analyzeExpression(node.getPrimaryExpression());
     if (!node.getUnaryOperator()) {
@@ -291,19 +287,15 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::U
     auto& operatorTerminal = *node.getUnaryOperator();
 
     if (operatorTerminal.value() == Operator::PLUS) {
-        std::unique_ptr<Expression> expression = std::make_unique<UnaryPlus>(result.release());
-        return expression;
+        return expressions.createUnary(Node::Type::UNARY_PLUS, result.release());
     } else if (operatorTerminal.value() == Operator::MINUS) {
-        std::unique_ptr<Expression> expression = std::make_unique<UnaryMinus>(result.release());
-        return expression;
+        return expressions.createUnary(Node::Type::UNARY_MINUS, result.release());
     } else {
         return node.reference()
             .makeError(code::ErrorType::ERROR, "Encountered illegal parse tree state! Expected PLUS or MINUS!");
     }
 }
-Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::PrimaryExpression& node) {
-    std::unique_ptr<Expression> expression;
-
+Result<node_index> ASTBuilder::analyzeExpression(const parse::PrimaryExpression& node) {
     switch (node.getType()) {
         case parse::PrimaryExpression::Type::IDENTIFIER: {
             Result<symbol_id> result = symbolTable.useIdentifier(node.asIdentifier());
@@ -311,12 +303,10 @@ Result<std::unique_ptr<Expression>> ASTBuilder::analyzeExpression(const parse::P
                 return result.error();
             }
 
-            expression = std::make_unique<Variable>(result.release(), node.asIdentifier().value());
-            return expression;
+            return expressions.createVariable(result.release(), node.asIdentifier().value());
         }
         case parse::PrimaryExpression::Type::LITERAL:
-            expression = std::make_unique<Literal>(node.asLiteral().value());
-            return expression;
+            return expressions.createLiteral(node.asLiteral().value());
         case parse::PrimaryExpression::Type::ADDITIVE_EXPRESSION: {
             auto [openParenthesis, additiveExpression, closeParenthesis] = node.asBracketedExpression();
             return analyzeExpression(additiveExpression);
@@ -7,21 +7,17 @@
 #include "../parse/ParseTree.hpp"
 #include "../util/Result.hpp"
 #include "../SymbolTable.hpp"
-#include <memory>
+#include "./AST.hpp"
 
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
-class Declaration;
-class ParamDeclaration;
-class VarDeclaration;
-class ConstDeclaration;
-class Expression;
-class Statement;
-class Function;
-//---------------------------------------------------------------------------
 class ASTBuilder {
+    friend class ASTParser; // shares the symbol table and arena while building the AST without a parse tree.
+
     SymbolTable symbolTable;
+    /// Collects the expressions of the analyzed function, moved into the `Function` once analysis finished.
+    ExpressionArena expressions;
 
     public:
     ASTBuilder();
@@ -32,12 +28,12 @@ class ASTBuilder {
     Result<VarDeclaration> analyzeVarDeclaration(const parse::VariableDeclarations& node);
     Result<ConstDeclaration> analyzeConstDeclaration(const parse::ConstantDeclarations& node);
 
-    Result<std::unique_ptr<Statement>> analyzeStatement(const parse::Statement& node);
+    Result<Statement> analyzeStatement(const parse::Statement& node);
 
-    Result<std::unique_ptr<Expression>> analyzeExpression(const parse::AdditiveExpression& node);
-    Result<std::unique_ptr<Expression>> analyzeExpression(const parse::MultiplicativeExpression& node);
-    Result<std::unique_ptr<Expression>> analyzeExpression(const parse::UnaryExpression& node);
-    Result<std::unique_ptr<Expression>> analyzeExpression(const parse::PrimaryExpression& node);
+    Result<node_index> analyzeExpression(const parse::AdditiveExpression& node);
+    Result<node_index> analyzeExpression(const parse::MultiplicativeExpression& node);
+    Result<node_index> analyzeExpression(const parse::UnaryExpression& node);
+    Result<node_index> analyzeExpression(const parse::PrimaryExpression& node);
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::ast
@@ -31,7 +31,7 @@ void DOTVisitor::visit(const Function& node) {
 
     for (auto& statement: node.getStatements()) {
         printEdge(root);
-        statement->accept(*this);
+        statement.accept(*this, node.getExpressions());
     }
 }
 
@@ -70,86 +70,60 @@ void DOTVisitor::visit(const ParamDeclaration& node) {
     }
 }
 
-void DOTVisitor::visit(const ReturnStatement& node) {
+void DOTVisitor::visit(const Statement& node, const ExpressionArena& expressions) {
     unsigned root = ++node_num;
 
-    printNode("ReturnStatement");
+    if (node.getType() == Node::Type::ASSIGNMENT_STATEMENT) {
+        printNode("AssignmentStatement");
 
-    printEdge(root);
-    node.getExpression().accept(*this);
-}
-
-void DOTVisitor::visit(const AssignmentStatement& node) {
-    unsigned root = ++node_num;
-
-    printNode("AssignmentStatement");
-
-    printEdge(root);
-    node.getVariable().accept(*this);
-    printEdge(root);
-    node.getExpression().accept(*this);
-}
-
-void DOTVisitor::visit(const Divide& node) {
-    unsigned root = ++node_num;
-
-    printNode("Divide");
-
-    printEdge(root);
-    node.getLeft().accept(*this);
-    printEdge(root);
-    node.getRight().accept(*this);
-}
-
-void DOTVisitor::visit(const Multiply& node) {
-    unsigned root = ++node_num;
-
-    printNode("Multiply");
-
-    printEdge(root);
-    node.getLeft().accept(*this);
-    printEdge(root);
-    node.getRight().accept(*this);
-}
-
-void DOTVisitor::visit(const Subtract& node) {
-    unsigned root = ++node_num;
-
-    printNode("Subtract");
-
-    printEdge(root);
-    node.getLeft().accept(*this);
-    printEdge(root);
-    node.getRight().accept(*this);
-}
-
-void DOTVisitor::visit(const Add& node) {
-    unsigned root = ++node_num;
-
-    printNode("Add");
+        printEdge(root);
+        node.getVariable().accept(*this);
+    } else {
+        printNode("ReturnStatement");
+    }
 
     printEdge(root);
-    node.getLeft().accept(*this);
-    printEdge(root);
-    node.getRight().accept(*this);
+    expressions[node.getExpression()].accept(*this, expressions);
 }
 
-void DOTVisitor::visit(const UnaryMinus& node) {
+void DOTVisitor::visit(const Expression& node, const ExpressionArena& expressions) {
     unsigned root = ++node_num;
 
-    printNode("UnaryMinus");
+    switch (node.getType()) {
+        case Node::Type::LITERAL:
+            printTerminalNode(node.value());
+            return;
+        case Node::Type::VARIABLE:
+            printTerminalNode(expressions.getName(node));
+            return;
+        case Node::Type::UNARY_PLUS:
+        case Node::Type::UNARY_MINUS:
+            printNode(node.getType() == Node::Type::UNARY_PLUS ? "UnaryPlus" : "UnaryMinus");
+
+            printEdge(root);
+            expressions[node.getChild()].accept(*this, expressions);
+            return;
+        case Node::Type::ADD:
+            printNode("Add");
+            break;
+        case Node::Type::SUBTRACT:
+            printNode("Subtract");
+            break;
+        case Node::Type::MULTIPLY:
+            printNode("Multiply");
+            break;
+        case Node::Type::DIVIDE:
+            printNode("Divide");
+            break;
+        default:
+            assert(false && "Encountered unknown expression type!");
+            return;
+    }
 
     printEdge(root);
-    node.getChild().accept(*this);
-}
-
-void DOTVisitor::visit(const UnaryPlus& node) {
-    unsigned root = ++node_num;
-
-    printNode("UnaryPlus");
-
+    expressions[node.getLeft()].accept(*this, expressions);
     printEdge(root);
-    node.getChild().accept(*this);
+    expressions[node.getRight()].accept(*this, expressions);
 }
 
 void DOTVisitor::visit(const Variable& node) {
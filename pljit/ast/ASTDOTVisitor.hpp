@@ -22,14 +22,8 @@ class DOTVisitor: public ASTVisitor, protected GenericDOTVisitor {
     void visit(const ConstDeclaration& node) override;
     void visit(const VarDeclaration& node) override;
     void visit(const ParamDeclaration& node) override;
-    void visit(const ReturnStatement& node) override;
-    void visit(const AssignmentStatement& node) override;
-    void visit(const Divide& node) override;
-    void visit(const Multiply& node) override;
-    void visit(const Subtract& node) override;
-    void visit(const Add& node) override;
-    void visit(const UnaryMinus& node) override;
-    void visit(const UnaryPlus& node) override;
+    void visit(const Statement& node, const ExpressionArena& expressions) override;
+    void visit(const Expression& node, const ExpressionArena& expressions) override;
     void visit(const Variable& node) override;
     void visit(const Literal& node) override;
 };
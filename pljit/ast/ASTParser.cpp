@@ -0,0 +1,324 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./ASTParser.hpp"
+#include "../lang.hpp"
+#include <utility>
+
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+ASTParser::ASTParser(lex::Lexer& lexer) : parser(lexer), lexer(&lexer), builder(), semantic_error() {}
+
+template <typename T, typename F>
+T ASTParser::analyze(F&& step) {
+    if (semantic_error) {
+        return T{};
+    }
+
+    Result<T> result = step();
+    if (!result) {
+        semantic_error = result.error();
+        return T{};
+    }
+
+    return result.release();
+}
+
+Result<Function> ASTParser::parseFunction() {
+    std::optional<parse::ParameterDeclarations> parameterDeclarations;
+    std::optional<parse::VariableDeclarations> variableDeclarations;
+    std::optional<parse::ConstantDeclarations> constantDeclarations;
+
+    if (auto error = parser.parseDeclarations(parameterDeclarations, variableDeclarations, constantDeclarations)) {
+        return *error;
+    }
+
+    std::optional<ParamDeclaration> paramDeclaration;
+    std::optional<VarDeclaration> varDeclaration;
+    std::optional<ConstDeclaration> constDeclaration;
+
+    if (parameterDeclarations) {
+        paramDeclaration = analyze<ParamDeclaration>([&] { return builder.analyzeParamDeclaration(*parameterDeclarations); });
+    }
+    if (variableDeclarations) {
+        varDeclaration = analyze<VarDeclaration>([&] { return builder.analyzeVarDeclaration(*variableDeclarations); });
+    }
+    if (constantDeclarations) {
+        constDeclaration = analyze<ConstDeclaration>([&] { return builder.analyzeConstDeclaration(*constantDeclarations); });
+    }
+
+    Result<parse::GenericTerminal> begin = parser.parseGenericTerminal(lex::Token::Type::KEYWORD, Keyword::BEGIN, "Expected `BEGIN` keyword!");
+    if (!begin) {
+        return begin.error();
+    }
+
+    std::vector<Statement> statements;
+
+    Result<Statement> statement = parseStatement();
+    if (!statement) {
+        return statement.error();
+    }
+    statements.push_back(statement.release());
+
+    lex::Token token;
+    while (true) {
+        token = lexer->peek();
+        if (token.isEmpty()) {
+            return lexer->error();
+        }
+
+        if (token.is(lex::Token::Type::KEYWORD, Keyword::END)) {
+            break;
+        } else if (!token.is(lex::Token::Type::SEPARATOR, Separator::SEMICOLON)) {
+            return token.makeError(code::ErrorType::ERROR, "Expected `;` to terminate statement!");
+        }
+
+        lexer->advance();
+
+        statement = parseStatement();
+        if (!statement) {
+            return statement.error();
+        }
+        statements.push_back(statement.release());
+    }
+
+    Result<parse::GenericTerminal> end = parser.parseGenericTerminal(lex::Token::Type::KEYWORD, Keyword::END, "Expected `END` keyword!");
+    if (!end) {
+        return end.error();
+    }
+
+    Result<parse::GenericTerminal> terminator = parser.parseProgramTerminator();
+    if (!terminator) {
+        return terminator.error();
+    }
+
+    if (semantic_error) {
+        return *semantic_error;
+    }
+
+    Function function{
+        std::move(paramDeclaration),
+        std::move(varDeclaration),
+        std::move(constDeclaration),
+        std::move(statements),
+        std::exchange(builder.expressions, {}),
+        builder.symbolTable.size()
+    };
+
+    bool found_return = false;
+    for (auto& functionStatement: function.getStatements()) {
+        if (functionStatement.getType() == Node::Type::RETURN_STATEMENT) {
+            found_return = true;
+            break;
+        }
+    }
+
+    if (!found_return) {
+        return end->reference()
+            .makeError(code::ErrorType::ERROR, "Reached end of function without a RETURN statement!");
+    }
+
+    return function;
+}
+
+Result<Statement> ASTParser::parseStatement() {
+    lex::Token token;
+
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
+    }
+
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::RETURN)) {
+        lexer->advance();
+
+        Result<ParsedExpression> expression = parseAdditiveExpression();
+        if (!expression) {
+            return expression.error();
+        }
+
+        return Statement{ expression->node };
+    } else if (token.getType() == lex::Token::Type::IDENTIFIER) {
+        Result<parse::Identifier> identifier = parser.parseIdentifier();
+        if (!identifier) {
+            return identifier.error();
+        }
+
+        Result<parse::GenericTerminal> op = parser.parseGenericTerminal(lex::Token::Type::OPERATOR, Operator::ASSIGNMENT, "Expected `:=` operator!");
+        if (!op) {
+            return op.error();
+        }
+
+        Result<ParsedExpression> expression = parseAdditiveExpression();
+        if (!expression) {
+            return expression.error();
+        }
+
+        // the target is resolved after the expression, a variable can't be read in its own initialization.
+        symbol_id target = analyze<symbol_id>([&] { return builder.symbolTable.useAsAssignmentTarget(*identifier); });
+        return Statement{ expression->node, Variable{ target, identifier->value() } };
+    } else {
+        return token.makeError(code::ErrorType::ERROR, "Expected begin of statement. Assignment or RETURN expression!");
+    }
+}
+
+Result<ASTParser::ParsedExpression> ASTParser::parseAdditiveExpression() {
+    Result<ParsedExpression> lhs = parseMultiplicativeExpression();
+    if (!lhs) {
+        return lhs.error();
+    }
+
+    if (lexer->endOfStream()) {
+        // edge case when not parsing whole programs!
+        return lhs;
+    }
+
+    lex::Token token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
+    }
+
+    Node::Type type;
+    if (token.is(lex::Token::Type::OPERATOR, Operator::PLUS)) {
+        type = Node::Type::ADD;
+    } else if (token.is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
+        type = Node::Type::SUBTRACT;
+    } else {
+        return lhs;
+    }
+
+    lexer->advance();
+
+    Result<ParsedExpression> rhs = parseAdditiveExpression();
+    if (!rhs) {
+        return rhs.error();
+    }
+
+    return ParsedExpression{
+        builder.expressions.createBinary(type, lhs->node, rhs->node),
+        { lhs->reference, rhs->reference }
+    };
+}
+
+Result<ASTParser::ParsedExpression> ASTParser::parseMultiplicativeExpression() {
+    Result<ParsedExpression> lhs = parseUnaryExpression();
+    if (!lhs) {
+        return lhs.error();
+    }
+
+    if (lexer->endOfStream()) {
+        // edge case when not parsing whole programs!
+        return lhs;
+    }
+
+    lex::Token token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
+    }
+
+    Node::Type type;
+    if (token.is(lex::Token::Type::OPERATOR, Operator::MULTIPLICATION)) {
+        type = Node::Type::MULTIPLY;
+    } else if (token.is(lex::Token::Type::OPERATOR, Operator::DIVISION)) {
+        type = Node::Type::DIVIDE;
+    } else {
+        return lhs;
+    }
+
+    lexer->advance();
+
+    Result<ParsedExpression> rhs = parseMultiplicativeExpression();
+    if (!rhs) {
+        return rhs.error();
+    }
+
+    code::SourceCodeReference reference{ lhs->reference, rhs->reference };
+    return ParsedExpression{
+        builder.expressions.createBinary(type, lhs->node, rhs->node, reference),
+        reference
+    };
+}
+
+Result<ASTParser::ParsedExpression> ASTParser::parseUnaryExpression() {
+    lex::Token token;
+
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
+    }
+
+    std::optional<Node::Type> type;
+
+    if (token.is(lex::Token::Type::OPERATOR, Operator::PLUS)) {
+        type = Node::Type::UNARY_PLUS;
+    } else if (token.is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
+        type = Node::Type::UNARY_MINUS;
+    } else if (token.getType() == lex::Token::Type::OPERATOR) {
+        return token.makeError(code::ErrorType::ERROR, "Unexpected unary operator!");
+    }
+
+    if (type) {
+        lexer->advance();
+    }
+
+    Result<ParsedExpression> expression = parsePrimaryExpression();
+    if (!expression || !type) {
+        return expression;
+    }
+
+    return ParsedExpression{
+        builder.expressions.createUnary(*type, expression->node),
+        { token.reference(), expression->reference }
+    };
+}
+
+Result<ASTParser::ParsedExpression> ASTParser::parsePrimaryExpression() {
+    lex::Token token;
+
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
+    }
+
+    if (token.getType() == lex::Token::Type::IDENTIFIER) {
+        Result<parse::Identifier> identifier = parser.parseIdentifier();
+        if (!identifier) {
+            return identifier.error();
+        }
+
+        symbol_id symbol = analyze<symbol_id>([&] { return builder.symbolTable.useIdentifier(*identifier); });
+        return ParsedExpression{ builder.expressions.createVariable(symbol, identifier->value()), identifier->reference() };
+    } else if (token.getType() == lex::Token::Type::LITERAL) {
+        Result<parse::Literal> literal = parser.parseLiteral();
+        if (!literal) {
+            return literal.error();
+        }
+
+        return ParsedExpression{ builder.expressions.createLiteral(literal->value()), literal->reference() };
+    } else if (token.is(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_OPEN)) {
+        Result<parse::GenericTerminal> open = parser.parseGenericTerminal(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_OPEN, "Expected `(` parenthesis!");
+        if (!open) {
+            return open.error();
+        }
+
+        Result<ParsedExpression> expression = parseAdditiveExpression();
+        if (!expression) {
+            return expression.error();
+        }
+
+        Result<parse::GenericTerminal> close = parser.parseGenericTerminal(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_CLOSE, "Expected matching `)` parenthesis!");
+        if (!close) {
+            return code::SourceCodeError{ close.error() }
+                .attachCause(open->reference().makeError(code::ErrorType::NOTE, "opening bracket here"));
+        }
+
+        return ParsedExpression{ expression->node, { open->reference(), close->reference() } };
+    } else {
+        return token.makeError(code::ErrorType::ERROR, "Expected a primary expression!");
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
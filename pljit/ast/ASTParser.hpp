@@ -0,0 +1,64 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_ASTPARSER_HPP
+#define PLJIT_ASTPARSER_HPP
+
+#include "./ASTBuilder.hpp"
+#include "../lex/Lexer.hpp"
+#include "../parse/Parser.hpp"
+#include <optional>
+
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+/**
+ * Builds the AST of a function straight from the token stream of a `Lexer`, without materializing
+ * the parse tree of statements and expressions. Identifiers are resolved against the `SymbolTable`
+ * while parsing.
+ *
+ * Errors are identical to the ones of `parse::Parser` followed by `ASTBuilder`: the first semantic
+ * error is held back till the whole function was parsed, so that syntax errors take precedence.
+ * The parse tree is only required for the DOT visualization.
+ */
+class ASTParser {
+    /// The `parse::Parser` used for declarations and terminal symbols. Both share the same lexer.
+    parse::Parser parser;
+    lex::Lexer* lexer;
+    ASTBuilder builder;
+
+    /// The first semantic error. No further semantic analysis happens once it is set.
+    std::optional<code::SourceCodeError> semantic_error;
+
+    /// An expression together with the source code it was parsed from.
+    struct ParsedExpression {
+        node_index node = 0;
+        code::SourceCodeReference reference = {};
+    };
+
+    public:
+    explicit ASTParser(lex::Lexer& lexer);
+
+    Result<Function> parseFunction();
+
+    private:
+    Result<Statement> parseStatement();
+
+    Result<ParsedExpression> parseAdditiveExpression();
+    Result<ParsedExpression> parseMultiplicativeExpression();
+    Result<ParsedExpression> parseUnaryExpression();
+    Result<ParsedExpression> parsePrimaryExpression();
+
+    /**
+     * Runs a semantic analysis step, unless a previous step already failed.
+     * @return Returns the result of the step, or the default value if it failed or was skipped.
+     */
+    template <typename T, typename F>
+    T analyze(F&& step);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_ASTPARSER_HPP
@@ -10,14 +10,9 @@ namespace pljit::ast {
 //---------------------------------------------------------------------------
 class Literal;
 class Variable;
-class UnaryPlus;
-class UnaryMinus;
-class Add;
-class Subtract;
-class Multiply;
-class Divide;
-class AssignmentStatement;
-class ReturnStatement;
+class Expression;
+class ExpressionArena;
+class Statement;
 class ParamDeclaration;
 class VarDeclaration;
 class ConstDeclaration;
@@ -32,14 +27,9 @@ class ASTVisitor {
     virtual void visit(const ConstDeclaration& node) = 0;
     virtual void visit(const VarDeclaration& node) = 0;
     virtual void visit(const ParamDeclaration& node) = 0;
-    virtual void visit(const ReturnStatement& node) = 0;
-    virtual void visit(const AssignmentStatement& node) = 0;
-    virtual void visit(const Divide& node) = 0;
-    virtual void visit(const Multiply& node) = 0;
-    virtual void visit(const Subtract& node) = 0;
-    virtual void visit(const Add& node) = 0;
-    virtual void visit(const UnaryMinus& node) = 0;
-    virtual void visit(const UnaryPlus& node) = 0;
+    /// Statements and expressions are visited together with the arena holding their child expressions.
+    virtual void visit(const Statement& node, const ExpressionArena& expressions) = 0;
+    virtual void visit(const Expression& node, const ExpressionArena& expressions) = 0;
     virtual void visit(const Variable& node) = 0;
     virtual void visit(const Literal& node) = 0;
 };
@@ -0,0 +1,335 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./BatchKernels.hpp"
+#include <cassert>
+#include <cstdint>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+ConstantDivisor::ConstantDivisor(long long divisor, long long magic, int shift) : divisor(divisor), magic(magic), shift(shift) {}
+
+std::optional<ConstantDivisor> ConstantDivisor::create(long long divisor) {
+    if (divisor == 0) {
+        return {};
+    } else if (divisor == 1 || divisor == -1) {
+        return ConstantDivisor{ divisor, 0, 0 };
+    }
+
+    // Hacker's Delight, figure 10-1, adapted to 64 bit.
+    constexpr std::uint64_t two63 = std::uint64_t{ 1 } << 63;
+
+    auto d = static_cast<std::uint64_t>(divisor);
+    std::uint64_t ad = divisor < 0 ? ~d + 1 : d;
+    std::uint64_t t = two63 + (d >> 63);
+    std::uint64_t anc = t - 1 - t % ad; // absolute value of nc
+    int p = 63;
+    std::uint64_t q1 = two63 / anc; // q1 = 2^p / |nc|
+    std::uint64_t r1 = two63 - q1 * anc; // r1 = rem(2^p, |nc|)
+    std::uint64_t q2 = two63 / ad; // q2 = 2^p / |d|
+    std::uint64_t r2 = two63 - q2 * ad; // r2 = rem(2^p, |d|)
+    std::uint64_t delta;
+
+    do {
+        ++p;
+        q1 = 2 * q1;
+        r1 = 2 * r1;
+        if (r1 >= anc) {
+            ++q1;
+            r1 -= anc;
+        }
+        q2 = 2 * q2;
+        r2 = 2 * r2;
+        if (r2 >= ad) {
+            ++q2;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    std::uint64_t magic = q2 + 1;
+    if (divisor < 0) {
+        magic = ~magic + 1;
+    }
+
+    return ConstantDivisor{ divisor, static_cast<long long>(magic), p - 64 };
+}
+
+long long ConstantDivisor::getDivisor() const {
+    return divisor;
+}
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// SCALAR
+//---------------------------------------------------------------------------
+void negateScalar(long long* target, const long long* value, std::size_t count) {
+    for (std::size_t row = 0; row < count; ++row) {
+        target[row] = -value[row];
+    }
+}
+
+void addScalar(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    for (std::size_t row = 0; row < count; ++row) {
+        target[row] = lhs[row] + rhs[row];
+    }
+}
+
+void subtractScalar(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    for (std::size_t row = 0; row < count; ++row) {
+        target[row] = lhs[row] - rhs[row];
+    }
+}
+
+void multiplyScalar(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    for (std::size_t row = 0; row < count; ++row) {
+        target[row] = lhs[row] * rhs[row];
+    }
+}
+
+void divideScalar(long long* target, const long long* lhs, const long long* rhs, unsigned char* failed, std::size_t count) {
+    for (std::size_t row = 0; row < count; ++row) {
+        bool zero = rhs[row] == 0;
+        failed[row] |= static_cast<unsigned char>(zero);
+        target[row] = lhs[row] / (zero ? 1 : rhs[row]);
+    }
+}
+
+void divideConstantScalar(long long* target, const long long* lhs, const ConstantDivisor& divisor, std::size_t count) {
+    // there is no SIMD instruction for the high half of a 64 bit multiplication, thus all kernel sets share this kernel.
+    ConstantDivisor local = divisor;
+    for (std::size_t row = 0; row < count; ++row) {
+        target[row] = local.divide(lhs[row]);
+    }
+}
+
+constexpr BatchKernels SCALAR_KERNELS{
+    KernelSet::SCALAR,
+    negateScalar,
+    addScalar,
+    subtractScalar,
+    multiplyScalar,
+    divideScalar,
+    divideConstantScalar,
+};
+//---------------------------------------------------------------------------
+#if defined(__x86_64__)
+//---------------------------------------------------------------------------
+// AVX2
+//---------------------------------------------------------------------------
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+__attribute__((target("avx2"))) void negateAVX2(long long* target, const long long* value, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value + row));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + row), _mm256_sub_epi64(_mm256_setzero_si256(), v));
+    }
+    negateScalar(target + row, value + row, count - row);
+}
+
+__attribute__((target("avx2"))) void addAVX2(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + row));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + row));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + row), _mm256_add_epi64(l, r));
+    }
+    addScalar(target + row, lhs + row, rhs + row, count - row);
+}
+
+__attribute__((target("avx2"))) void subtractAVX2(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + row));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + row));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + row), _mm256_sub_epi64(l, r));
+    }
+    subtractScalar(target + row, lhs + row, rhs + row, count - row);
+}
+
+__attribute__((target("avx2"))) void multiplyAVX2(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    // AVX2 lacks a 64 bit multiplication. With l = lh * 2^32 + ll and r = rh * 2^32 + rl,
+    // the lower 64 bit of l * r are ll * rl + ((lh * rl + ll * rh) << 32).
+    std::size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + row));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + row));
+
+        __m256i low = _mm256_mul_epu32(l, r);
+        __m256i cross = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(l, 32), r),
+            _mm256_mul_epu32(l, _mm256_srli_epi64(r, 32)));
+        __m256i product = _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + row), product);
+    }
+    multiplyScalar(target + row, lhs + row, rhs + row, count - row);
+}
+
+__attribute__((target("avx2"))) void divideAVX2(long long* target, const long long* lhs, const long long* rhs, unsigned char* failed, std::size_t count) {
+    // there is no SIMD integer division, only the zero check is vectorized.
+    std::size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + row));
+        auto zero_mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(r, _mm256_setzero_si256()))));
+
+        if (zero_mask == 0) {
+            for (std::size_t lane = row; lane < row + 4; ++lane) {
+                target[lane] = lhs[lane] / rhs[lane];
+            }
+        } else {
+            divideScalar(target + row, lhs + row, rhs + row, failed + row, 4);
+        }
+    }
+    divideScalar(target + row, lhs + row, rhs + row, failed + row, count - row);
+}
+
+constexpr BatchKernels AVX2_KERNELS{
+    KernelSet::AVX2,
+    negateAVX2,
+    addAVX2,
+    subtractAVX2,
+    multiplyAVX2,
+    divideAVX2,
+    divideConstantScalar,
+};
+//---------------------------------------------------------------------------
+// AVX-512
+//---------------------------------------------------------------------------
+__attribute__((target("avx512f"))) void negateAVX512(long long* target, const long long* value, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m512i v = _mm512_loadu_si512(value + row);
+        _mm512_storeu_si512(target + row, _mm512_sub_epi64(_mm512_setzero_si512(), v));
+    }
+    if (row < count) {
+        auto mask = static_cast<__mmask8>((1u << (count - row)) - 1);
+        __m512i v = _mm512_maskz_loadu_epi64(mask, value + row);
+        _mm512_mask_storeu_epi64(target + row, mask, _mm512_sub_epi64(_mm512_setzero_si512(), v));
+    }
+}
+
+__attribute__((target("avx512f"))) void addAVX512(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m512i l = _mm512_loadu_si512(lhs + row);
+        __m512i r = _mm512_loadu_si512(rhs + row);
+        _mm512_storeu_si512(target + row, _mm512_add_epi64(l, r));
+    }
+    if (row < count) {
+        auto mask = static_cast<__mmask8>((1u << (count - row)) - 1);
+        __m512i l = _mm512_maskz_loadu_epi64(mask, lhs + row);
+        __m512i r = _mm512_maskz_loadu_epi64(mask, rhs + row);
+        _mm512_mask_storeu_epi64(target + row, mask, _mm512_add_epi64(l, r));
+    }
+}
+
+__attribute__((target("avx512f"))) void subtractAVX512(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m512i l = _mm512_loadu_si512(lhs + row);
+        __m512i r = _mm512_loadu_si512(rhs + row);
+        _mm512_storeu_si512(target + row, _mm512_sub_epi64(l, r));
+    }
+    if (row < count) {
+        auto mask = static_cast<__mmask8>((1u << (count - row)) - 1);
+        __m512i l = _mm512_maskz_loadu_epi64(mask, lhs + row);
+        __m512i r = _mm512_maskz_loadu_epi64(mask, rhs + row);
+        _mm512_mask_storeu_epi64(target + row, mask, _mm512_sub_epi64(l, r));
+    }
+}
+
+__attribute__((target("avx512f,avx512dq"))) void multiplyAVX512(long long* target, const long long* lhs, const long long* rhs, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m512i l = _mm512_loadu_si512(lhs + row);
+        __m512i r = _mm512_loadu_si512(rhs + row);
+        _mm512_storeu_si512(target + row, _mm512_mullo_epi64(l, r));
+    }
+    if (row < count) {
+        auto mask = static_cast<__mmask8>((1u << (count - row)) - 1);
+        __m512i l = _mm512_maskz_loadu_epi64(mask, lhs + row);
+        __m512i r = _mm512_maskz_loadu_epi64(mask, rhs + row);
+        _mm512_mask_storeu_epi64(target + row, mask, _mm512_mullo_epi64(l, r));
+    }
+}
+
+__attribute__((target("avx512f"))) void divideAVX512(long long* target, const long long* lhs, const long long* rhs, unsigned char* failed, std::size_t count) {
+    std::size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m512i r = _mm512_loadu_si512(rhs + row);
+        __mmask8 zero_mask = _mm512_cmpeq_epi64_mask(r, _mm512_setzero_si512());
+
+        if (zero_mask == 0) {
+            for (std::size_t lane = row; lane < row + 8; ++lane) {
+                target[lane] = lhs[lane] / rhs[lane];
+            }
+        } else {
+            divideScalar(target + row, lhs + row, rhs + row, failed + row, 8);
+        }
+    }
+    divideScalar(target + row, lhs + row, rhs + row, failed + row, count - row);
+}
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+constexpr BatchKernels AVX512_KERNELS{
+    KernelSet::AVX512,
+    negateAVX512,
+    addAVX512,
+    subtractAVX512,
+    multiplyAVX512,
+    divideAVX512,
+    divideConstantScalar,
+};
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+bool BatchKernels::isSupported(KernelSet kernel_set) {
+    switch (kernel_set) {
+        case KernelSet::SCALAR:
+            return true;
+#if defined(__x86_64__)
+        case KernelSet::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case KernelSet::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+#else
+        case KernelSet::AVX2:
+        case KernelSet::AVX512:
+            return false;
+#endif
+    }
+    return false;
+}
+
+const BatchKernels& BatchKernels::get(KernelSet kernel_set) {
+    assert(isSupported(kernel_set) && "Requested an unsupported KernelSet!");
+
+    switch (kernel_set) {
+#if defined(__x86_64__)
+        case KernelSet::AVX2:
+            return AVX2_KERNELS;
+        case KernelSet::AVX512:
+            return AVX512_KERNELS;
+#endif
+        default:
+            return SCALAR_KERNELS;
+    }
+}
+
+const BatchKernels& BatchKernels::best() {
+    static const BatchKernels& kernels = isSupported(KernelSet::AVX512) ? get(KernelSet::AVX512)
+        : isSupported(KernelSet::AVX2)                                  ? get(KernelSet::AVX2)
+                                                                        : get(KernelSet::SCALAR);
+    return kernels;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_BATCHKERNELS_HPP
+#define PLJIT_BATCHKERNELS_HPP
+
+#include <cstddef>
+#include <optional>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+/**
+ * A division by a constant, replaced by a multiplication with a precomputed magic number
+ * followed by a shift (see Hacker's Delight, 2nd edition, chapter 10-5).
+ */
+class ConstantDivisor {
+    __extension__ typedef __int128 int128;
+
+    long long divisor;
+    long long magic;
+    int shift;
+
+    ConstantDivisor(long long divisor, long long magic, int shift);
+
+    public:
+    /**
+     * Computes the magic number for the given divisor.
+     * @return Returns the `ConstantDivisor`, empty if the divisor is zero.
+     */
+    static std::optional<ConstantDivisor> create(long long divisor);
+
+    long long getDivisor() const;
+
+    /**
+     * @return Returns `dividend / divisor`, rounded towards zero like the built-in division.
+     */
+    long long divide(long long dividend) const {
+        if (divisor == 1) {
+            return dividend;
+        } else if (divisor == -1) {
+            return -dividend;
+        }
+
+        auto quotient = static_cast<long long>((static_cast<int128>(magic) * dividend) >> 64);
+        if (divisor > 0 && magic < 0) {
+            quotient += dividend;
+        } else if (divisor < 0 && magic > 0) {
+            quotient -= dividend;
+        }
+        quotient >>= shift;
+        // round towards zero for negative quotients
+        return quotient + static_cast<long long>(static_cast<unsigned long long>(quotient) >> 63);
+    }
+};
+//---------------------------------------------------------------------------
+/**
+ * The instruction sets the `BatchKernels` are available for.
+ */
+enum class KernelSet {
+    /// Portable C++ loops, left to the auto-vectorizer of the compiler.
+    SCALAR,
+    /// Hand-written AVX2 kernels (4 lanes).
+    AVX2,
+    /// Hand-written AVX-512 kernels (8 lanes), requires AVX-512F and AVX-512DQ.
+    AVX512,
+};
+//---------------------------------------------------------------------------
+/**
+ * Kernels applying a single bytecode operation to `count` rows of register columns.
+ * The target column may be the same column as an operand, but must not partially overlap.
+ */
+struct BatchKernels {
+    using UnaryKernel = void (*)(long long* target, const long long* value, std::size_t count);
+    using BinaryKernel = void (*)(long long* target, const long long* lhs, const long long* rhs, std::size_t count);
+    /// Sets `failed[i]` for rows dividing by zero, which continue with a divisor of one.
+    using DivideKernel = void (*)(long long* target, const long long* lhs, const long long* rhs, unsigned char* failed, std::size_t count);
+    using DivideConstantKernel = void (*)(long long* target, const long long* lhs, const ConstantDivisor& divisor, std::size_t count);
+
+    KernelSet kernel_set;
+    UnaryKernel negate;
+    BinaryKernel add;
+    BinaryKernel subtract;
+    BinaryKernel multiply;
+    DivideKernel divide;
+    DivideConstantKernel divideConstant;
+
+    /**
+     * @return Returns true if the CPU supports the given `KernelSet`.
+     */
+    static bool isSupported(KernelSet kernel_set);
+    /**
+     * @return Returns the kernels of the given `KernelSet`. The `KernelSet` must be supported.
+     */
+    static const BatchKernels& get(KernelSet kernel_set);
+    /**
+     * @return Returns the kernels of the widest `KernelSet` supported by the CPU, detected once by CPUID.
+     */
+    static const BatchKernels& best();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_BATCHKERNELS_HPP
@@ -0,0 +1,242 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./Bytecode.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+BytecodeFunction::BytecodeFunction(
+    std::vector<Instruction> instructions,
+    std::vector<long long> initial_registers,
+    std::vector<register_id> parameter_registers,
+    bool has_param_declaration,
+    std::vector<code::SourceCodeReference> division_references)
+    : instructions(std::move(instructions)), initial_registers(std::move(initial_registers)),
+      parameter_registers(std::move(parameter_registers)), has_param_declaration(has_param_declaration),
+      division_references(std::move(division_references)) {
+    assert(!this->instructions.empty() && this->instructions.back().opCode == OpCode::RETURN && "Bytecode must end with a RETURN instruction!");
+
+    // Registers which are neither written nor parameters keep their value of the initial register image.
+    std::vector<bool> constant_registers(register_count(), true);
+    for (register_id reg: this->parameter_registers) {
+        constant_registers[reg] = false;
+    }
+    for (const Instruction& instruction: this->instructions) {
+        if (instruction.opCode != OpCode::RETURN) {
+            constant_registers[instruction.target] = false;
+        }
+    }
+
+    for (const Instruction& instruction: this->instructions) {
+        if (instruction.opCode != OpCode::DIVIDE) {
+            continue;
+        }
+
+        if (constant_registers[instruction.rhs]) {
+            constant_divisors.push_back(ConstantDivisor::create(this->initial_registers[instruction.rhs]));
+        } else {
+            constant_divisors.emplace_back();
+        }
+    }
+}
+
+EvaluationContext BytecodeFunction::evaluate(std::span<const long long> arguments) const {
+    EvaluationContext context;
+    evaluate(arguments, context);
+    return context;
+}
+
+EvaluationContext BytecodeFunction::evaluate(std::initializer_list<long long> arguments) const {
+    return evaluate(std::span<const long long>{ arguments.begin(), arguments.size() });
+}
+
+void BytecodeFunction::evaluate(std::span<const long long> arguments, EvaluationContext& context) const {
+    // the variables of the context serve as the register file of the VM
+    context.reset(register_count());
+
+    if (RuntimeErrorCode error = checkArgumentCount(arguments.size()); error != RuntimeErrorCode::NONE) {
+        context.setRuntimeError(error);
+        return;
+    }
+
+    long long* reg = context.variables().data();
+    std::copy(initial_registers.begin(), initial_registers.end(), reg);
+    for (std::size_t index = 0; index < arguments.size(); ++index) {
+        reg[parameter_registers[index]] = arguments[index];
+    }
+
+    // The language has no control flow, therefore the dispatch loop simply walks the array till it hits a RETURN.
+    for (const Instruction* instruction = instructions.data();; ++instruction) {
+        switch (instruction->opCode) {
+            case OpCode::MOVE:
+                reg[instruction->target] = reg[instruction->lhs];
+                break;
+            case OpCode::NEGATE:
+                reg[instruction->target] = -reg[instruction->lhs];
+                break;
+            case OpCode::ADD:
+                reg[instruction->target] = reg[instruction->lhs] + reg[instruction->rhs];
+                break;
+            case OpCode::SUBTRACT:
+                reg[instruction->target] = reg[instruction->lhs] - reg[instruction->rhs];
+                break;
+            case OpCode::MULTIPLY:
+                reg[instruction->target] = reg[instruction->lhs] * reg[instruction->rhs];
+                break;
+            case OpCode::DIVIDE:
+                if (reg[instruction->rhs] == 0) {
+                    context.setRuntimeError(RuntimeErrorCode::DIVISION_BY_ZERO, divisionReference(instruction));
+                    return;
+                }
+                reg[instruction->target] = reg[instruction->lhs] / reg[instruction->rhs];
+                break;
+            case OpCode::RETURN:
+                context.return_value() = reg[instruction->lhs];
+                return;
+        }
+    }
+}
+
+RuntimeErrorCode BytecodeFunction::evaluateBatch(
+    std::span<const std::span<const long long>> columns,
+    std::span<long long> output,
+    std::span<std::uint64_t> error_bitmap,
+    const BatchKernels& kernels) const {
+    constexpr std::size_t CHUNK = BATCH_CHUNK_SIZE;
+    const std::size_t rows = output.size();
+
+    assert(error_bitmap.size() >= (rows + 63) / 64 && "Error bitmap is too small!");
+    if (RuntimeErrorCode error = checkArgumentCount(columns.size()); error != RuntimeErrorCode::NONE) {
+        return error;
+    }
+    for ([[maybe_unused]] auto& column: columns) {
+        assert(column.size() == rows && "Every column must provide a value for every row!");
+    }
+
+    std::fill_n(error_bitmap.begin(), (rows + 63) / 64, 0);
+
+    // Register `r` of row `i` (within the current chunk) is stored at `r * CHUNK + i`.
+    // Reused by every batch on this thread, to not allocate the register file for every call.
+    thread_local std::vector<long long> register_file;
+    register_file.resize(register_count() * CHUNK);
+    long long* file = register_file.data();
+
+    // Literal and CONST registers are never written, and variables are always written before they are read
+    // (the ASTBuilder rejects uninitialized reads). Therefore, the initial register image is broadcast once.
+    for (std::size_t reg = 0; reg < register_count(); ++reg) {
+        std::fill_n(file + reg * CHUNK, CHUNK, initial_registers[reg]);
+    }
+
+    std::array<unsigned char, CHUNK> failed; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    bool any_failed = false;
+
+    for (std::size_t offset = 0; offset < rows; offset += CHUNK) {
+        const std::size_t count = std::min(CHUNK, rows - offset);
+        failed.fill(0);
+
+        for (std::size_t index = 0; index < parameter_registers.size(); ++index) {
+            std::copy_n(columns[index].data() + offset, count, file + parameter_registers[index] * CHUNK);
+        }
+
+        std::size_t division = 0;
+        for (const Instruction& instruction: instructions) {
+            long long* target = file + instruction.target * CHUNK;
+            const long long* lhs = file + instruction.lhs * CHUNK;
+            const long long* rhs = file + instruction.rhs * CHUNK;
+
+            switch (instruction.opCode) {
+                case OpCode::MOVE:
+                    std::copy_n(lhs, count, target);
+                    break;
+                case OpCode::NEGATE:
+                    kernels.negate(target, lhs, count);
+                    break;
+                case OpCode::ADD:
+                    kernels.add(target, lhs, rhs, count);
+                    break;
+                case OpCode::SUBTRACT:
+                    kernels.subtract(target, lhs, rhs, count);
+                    break;
+                case OpCode::MULTIPLY:
+                    kernels.multiply(target, lhs, rhs, count);
+                    break;
+                case OpCode::DIVIDE:
+                    // Rows dividing by zero are marked as failed and continue with a divisor of one.
+                    // As there is no control flow, every row executes every division, thus the set of failed rows
+                    // is the same as when stopping at the first error.
+                    if (const auto& divisor = constant_divisors[division++]) {
+                        kernels.divideConstant(target, lhs, *divisor, count);
+                    } else {
+                        kernels.divide(target, lhs, rhs, failed.data(), count);
+                    }
+                    break;
+                case OpCode::RETURN:
+                    for (std::size_t row = 0; row < count; ++row) {
+                        output[offset + row] = failed[row] ? 0 : lhs[row];
+                    }
+                    break;
+            }
+        }
+
+        for (std::size_t row = 0; row < count; ++row) {
+            if (failed[row]) {
+                std::size_t position = offset + row;
+                error_bitmap[position / 64] |= std::uint64_t{ 1 } << (position % 64);
+                any_failed = true;
+            }
+        }
+    }
+
+    return any_failed ? RuntimeErrorCode::DIVISION_BY_ZERO : RuntimeErrorCode::NONE;
+}
+
+const std::vector<Instruction>& BytecodeFunction::getInstructions() const {
+    return instructions;
+}
+
+const std::vector<long long>& BytecodeFunction::getInitialRegisters() const {
+    return initial_registers;
+}
+
+const std::vector<register_id>& BytecodeFunction::getParameterRegisters() const {
+    return parameter_registers;
+}
+
+bool BytecodeFunction::hasParamDeclaration() const {
+    return has_param_declaration;
+}
+
+const std::vector<code::SourceCodeReference>& BytecodeFunction::getDivisionReferences() const {
+    return division_references;
+}
+
+RuntimeErrorCode BytecodeFunction::checkArgumentCount(std::size_t argument_count) const {
+    if (!has_param_declaration) {
+        return argument_count != 0 ? RuntimeErrorCode::UNEXPECTED_ARGUMENTS : RuntimeErrorCode::NONE;
+    } else if (argument_count > parameter_registers.size()) {
+        return RuntimeErrorCode::TOO_MANY_ARGUMENTS;
+    } else if (argument_count < parameter_registers.size()) {
+        return RuntimeErrorCode::TOO_FEW_ARGUMENTS;
+    }
+    return RuntimeErrorCode::NONE;
+}
+
+code::SourceCodeReference BytecodeFunction::divisionReference(const Instruction* instruction) const {
+    // only called in the error case, thus we rather count than storing a reference in every instruction
+    auto index = static_cast<std::size_t>(std::count_if(instructions.data(), instruction, [](const Instruction& other) {
+        return other.opCode == OpCode::DIVIDE;
+    }));
+    return index < division_references.size() ? division_references[index] : code::SourceCodeReference{};
+}
+
+std::size_t BytecodeFunction::register_count() const {
+    return initial_registers.size();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
@@ -0,0 +1,139 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_BYTECODE_HPP
+#define PLJIT_BYTECODE_HPP
+
+#include "./BatchKernels.hpp"
+#include "../EvaluationContext.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+/// A type alias used to refer to a register of the bytecode VM.
+using register_id = std::uint32_t;
+//---------------------------------------------------------------------------
+enum class OpCode : std::uint8_t {
+    /// target := lhs
+    MOVE,
+    /// target := -lhs
+    NEGATE,
+    /// target := lhs + rhs
+    ADD,
+    /// target := lhs - rhs
+    SUBTRACT,
+    /// target := lhs * rhs
+    MULTIPLY,
+    /// target := lhs / rhs. Raises a runtime error if rhs is zero.
+    DIVIDE,
+    /// Returns the value of lhs.
+    RETURN,
+};
+//---------------------------------------------------------------------------
+/**
+ * A single three-address instruction operating on registers of the VM.
+ * Unused operands are set to zero.
+ */
+struct Instruction {
+    OpCode opCode;
+    register_id target;
+    register_id lhs;
+    register_id rhs;
+};
+//---------------------------------------------------------------------------
+/**
+ * A function lowered into a contiguous bytecode array.
+ *
+ * The register file is laid out as follows: the first `symbol_count` registers hold the
+ * variables of the function (the register of a symbol is `symbol_id - 1`), followed by
+ * registers holding the literal values of the function, followed by temporaries.
+ * Literal registers are populated once at compile time within the initial register image.
+ */
+class BytecodeFunction {
+    public:
+    /// The number of rows processed at once by `evaluateBatch`.
+    static constexpr std::size_t BATCH_CHUNK_SIZE = 256;
+
+    private:
+    /// The straight-line instruction array. The last instruction is always a RETURN.
+    std::vector<Instruction> instructions;
+    /// The register image every evaluation starts with (literal registers are pre-populated).
+    std::vector<long long> initial_registers;
+    /// The registers the arguments are stored to, in declaration order.
+    std::vector<register_id> parameter_registers;
+    /// Whether the function has a PARAM declaration at all.
+    bool has_param_declaration;
+    /// The source code of every DIVIDE instruction, in instruction order. Used to report division by zero errors.
+    std::vector<code::SourceCodeReference> division_references;
+    /// The precomputed divisor of every DIVIDE instruction, in instruction order. Empty if the divisor isn't a non-zero constant.
+    std::vector<std::optional<ConstantDivisor>> constant_divisors;
+
+    public:
+    BytecodeFunction(
+        std::vector<Instruction> instructions,
+        std::vector<long long> initial_registers,
+        std::vector<register_id> parameter_registers,
+        bool has_param_declaration,
+        std::vector<code::SourceCodeReference> division_references = {}
+    );
+
+    /**
+     * Executes the bytecode.
+     * @param arguments The arguments passed to the function.
+     * @return Returns the `EvaluationContext` holding either the return value or a runtime error.
+     */
+    EvaluationContext evaluate(std::span<const long long> arguments) const;
+    EvaluationContext evaluate(std::initializer_list<long long> arguments) const;
+    /**
+     * Executes the bytecode using the variables of a caller supplied context as register file.
+     * The context is reset beforehand. Reusing the same context avoids any heap allocations.
+     */
+    void evaluate(std::span<const long long> arguments, EvaluationContext& context) const;
+
+    /**
+     * Evaluates the function for every row of the given argument columns.
+     * The bytecode is executed vector-at-a-time: every instruction is applied to a chunk of
+     * `BATCH_CHUNK_SIZE` rows at once using the given `BatchKernels`. Divisions by a constant register
+     * are replaced by a multiplication with the precomputed `ConstantDivisor`.
+     * @param columns One column per parameter, all of the same length as `output`.
+     * @param output Receives the return value of every row. Zero for failed rows.
+     * @param error_bitmap Bit `i % 64` of word `i / 64` is set if row `i` divided by zero. Requires `(rows + 63) / 64` words.
+     * @return Returns `RuntimeErrorCode::NONE` if all rows succeeded, `RuntimeErrorCode::DIVISION_BY_ZERO` if any row failed
+     * or the argument count error if the number of columns doesn't match the PARAM declaration (no row is evaluated then).
+     * @param kernels The kernels used to execute the instructions, by default the widest ones supported by the CPU.
+     */
+    RuntimeErrorCode evaluateBatch(
+        std::span<const std::span<const long long>> columns,
+        std::span<long long> output,
+        std::span<std::uint64_t> error_bitmap,
+        const BatchKernels& kernels = BatchKernels::best()
+    ) const;
+
+    const std::vector<Instruction>& getInstructions() const;
+    const std::vector<long long>& getInitialRegisters() const;
+    const std::vector<register_id>& getParameterRegisters() const;
+    bool hasParamDeclaration() const;
+    const std::vector<code::SourceCodeReference>& getDivisionReferences() const;
+
+    std::size_t register_count() const;
+
+    private:
+    /**
+     * @return Returns the error raised for the given number of arguments, `RuntimeErrorCode::NONE` if it is valid.
+     */
+    RuntimeErrorCode checkArgumentCount(std::size_t argument_count) const;
+    /**
+     * @return Returns the `SourceCodeReference` of the given DIVIDE instruction.
+     */
+    code::SourceCodeReference divisionReference(const Instruction* instruction) const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_BYTECODE_HPP
@@ -0,0 +1,172 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./BytecodeCompiler.hpp"
+#include "../ast/AST.hpp"
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+BytecodeCompiler::BytecodeCompiler() : symbol_count(0), expressions(nullptr), next_temporary(0), temporary_count(0) {}
+
+BytecodeFunction BytecodeCompiler::compile(const ast::Function& function) {
+    symbol_count = function.symbol_count();
+    expressions = &function.getExpressions();
+    instructions.clear();
+    division_references.clear();
+    literals.clear();
+    literal_registers.clear();
+    next_temporary = 0;
+    temporary_count = 0;
+
+    for (auto& statement: function.getStatements()) {
+        lowerStatement(statement);
+
+        if (statement.getType() == ast::Node::Type::RETURN_STATEMENT) {
+            // everything after the first RETURN is unreachable
+            break;
+        }
+    }
+
+    assert(!instructions.empty() && instructions.back().opCode == OpCode::RETURN && "Fatal error occurred. Illegal AST. No return statement was provided!");
+
+    for (auto& instruction: instructions) {
+        instruction.target = relocate(instruction.target);
+        instruction.lhs = relocate(instruction.lhs);
+        instruction.rhs = relocate(instruction.rhs);
+    }
+
+    std::vector<long long> initial_registers(symbol_count + literals.size() + temporary_count);
+    for (std::size_t index = 0; index < literals.size(); ++index) {
+        initial_registers[symbol_count + index] = literals[index];
+    }
+
+    if (function.getConstDeclaration()) {
+        for (auto& [variable, literal]: function.getConstDeclaration()->getConstDeclarations()) {
+            initial_registers[variable.getSymbolId() - 1] = literal.value();
+        }
+    }
+
+    std::vector<register_id> parameter_registers;
+    if (function.getParamDeclaration()) {
+        for (auto& variable: function.getParamDeclaration()->getDeclaredIdentifiers()) {
+            parameter_registers.push_back(static_cast<register_id>(variable.getSymbolId() - 1));
+        }
+    }
+
+    return BytecodeFunction{
+        std::move(instructions),
+        std::move(initial_registers),
+        std::move(parameter_registers),
+        function.getParamDeclaration().has_value(),
+        std::move(division_references)
+    };
+}
+
+void BytecodeCompiler::lowerStatement(const ast::Statement& statement) {
+    // temporaries don't outlive a statement
+    next_temporary = 0;
+
+    if (statement.getType() == ast::Node::Type::ASSIGNMENT_STATEMENT) {
+        auto target = static_cast<register_id>(statement.getVariable().getSymbolId() - 1);
+
+        register_id result = lowerExpression(statement.getExpression(), target);
+        if (result != target) {
+            emit(OpCode::MOVE, target, result, 0);
+        }
+    } else {
+        assert(statement.getType() == ast::Node::Type::RETURN_STATEMENT && "Encountered unknown statement type!");
+
+        register_id result = lowerExpression(statement.getExpression(), {});
+        emit(OpCode::RETURN, 0, result, 0);
+    }
+}
+
+register_id BytecodeCompiler::lowerExpression(ast::node_index index, std::optional<register_id> target) {
+    const ast::Expression& expression = (*expressions)[index];
+    auto type = expression.getType();
+
+    if (type == ast::Node::Type::LITERAL) {
+        return literalRegister(expression.value());
+    } else if (type == ast::Node::Type::VARIABLE) {
+        return static_cast<register_id>(expression.getSymbolId() - 1);
+    } else if (type == ast::Node::Type::UNARY_PLUS) {
+        return lowerExpression(expression.getChild(), target);
+    } else if (type == ast::Node::Type::UNARY_MINUS) {
+        register_id saved_temporary = next_temporary;
+        register_id child = lowerExpression(expression.getChild(), {});
+        next_temporary = saved_temporary;
+
+        register_id result = target ? *target : allocateTemporary();
+        emit(OpCode::NEGATE, result, child, 0);
+        return result;
+    }
+
+    OpCode opCode;
+    switch (type) {
+        case ast::Node::Type::ADD:
+            opCode = OpCode::ADD;
+            break;
+        case ast::Node::Type::SUBTRACT:
+            opCode = OpCode::SUBTRACT;
+            break;
+        case ast::Node::Type::MULTIPLY:
+            opCode = OpCode::MULTIPLY;
+            break;
+        case ast::Node::Type::DIVIDE:
+            opCode = OpCode::DIVIDE;
+            break;
+        default:
+            assert(false && "Encountered unknown expression type!");
+            return 0;
+    }
+
+    // Operands are read before the result is written, therefore the result may reuse the temporaries of the operands.
+    register_id saved_temporary = next_temporary;
+    register_id lhs = lowerExpression(expression.getLeft(), {});
+    register_id rhs = lowerExpression(expression.getRight(), {});
+    next_temporary = saved_temporary;
+
+    register_id result = target ? *target : allocateTemporary();
+    emit(opCode, result, lhs, rhs);
+    if (opCode == OpCode::DIVIDE) {
+        division_references.push_back(expressions->getReference(expression));
+    }
+    return result;
+}
+
+register_id BytecodeCompiler::literalRegister(long long value) {
+    auto iterator = literal_registers.find(value);
+    if (iterator != literal_registers.end()) {
+        return iterator->second;
+    }
+
+    auto reg = static_cast<register_id>(symbol_count + literals.size());
+    literals.push_back(value);
+    literal_registers.emplace(value, reg);
+    return reg;
+}
+
+register_id BytecodeCompiler::allocateTemporary() {
+    register_id temporary = next_temporary++;
+    if (next_temporary > temporary_count) {
+        temporary_count = next_temporary;
+    }
+    return TEMPORARY_FLAG | temporary;
+}
+
+void BytecodeCompiler::emit(OpCode opCode, register_id target, register_id lhs, register_id rhs) {
+    instructions.push_back(Instruction{ opCode, target, lhs, rhs });
+}
+
+register_id BytecodeCompiler::relocate(register_id reg) const {
+    if (reg & TEMPORARY_FLAG) {
+        return static_cast<register_id>(symbol_count + literals.size()) + (reg & ~TEMPORARY_FLAG);
+    }
+    return reg;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
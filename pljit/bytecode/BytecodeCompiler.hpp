@@ -0,0 +1,72 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_BYTECODECOMPILER_HPP
+#define PLJIT_BYTECODECOMPILER_HPP
+
+#include "./Bytecode.hpp"
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+class Function;
+class Statement;
+class ExpressionArena;
+using node_index = std::uint32_t;
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+/**
+ * Lowers an `ast::Function` into a `BytecodeFunction`.
+ */
+class BytecodeCompiler {
+    /// Temporaries are numbered in their own space while lowering and relocated behind the literal registers at the end.
+    static constexpr register_id TEMPORARY_FLAG = register_id{ 1 } << 31;
+
+    std::size_t symbol_count;
+    /// The expressions of the function currently compiled.
+    const ast::ExpressionArena* expressions;
+    std::vector<Instruction> instructions;
+    /// The source code of every emitted DIVIDE instruction.
+    std::vector<code::SourceCodeReference> division_references;
+
+    /// The literal values in order of their first occurrence.
+    std::vector<long long> literals;
+    /// Maps a literal value to its register.
+    std::unordered_map<long long, register_id> literal_registers;
+
+    register_id next_temporary;
+    register_id temporary_count;
+
+    public:
+    BytecodeCompiler();
+
+    BytecodeFunction compile(const ast::Function& function);
+
+    private:
+    void lowerStatement(const ast::Statement& statement);
+    /**
+     * Emits the instructions to compute the given expression.
+     * @param expression The expression to lower.
+     * @param target If present, the result is computed into this register.
+     * @return Returns the register holding the result of the expression.
+     */
+    register_id lowerExpression(ast::node_index expression, std::optional<register_id> target);
+
+    register_id literalRegister(long long value);
+    register_id allocateTemporary();
+    void emit(OpCode opCode, register_id target, register_id lhs, register_id rhs);
+    register_id relocate(register_id reg) const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_BYTECODECOMPILER_HPP
@@ -0,0 +1,201 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./BytecodeSerializer.hpp"
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+class Writer {
+    std::vector<std::uint8_t>& data;
+
+    public:
+    explicit Writer(std::vector<std::uint8_t>& data) : data(data) {}
+
+    void write(std::uint64_t value, unsigned bytes) {
+        for (unsigned index = 0; index < bytes; ++index) {
+            data.push_back(static_cast<std::uint8_t>(value >> (8 * index)));
+        }
+    }
+    void write32(std::uint32_t value) {
+        write(value, 4);
+    }
+    void write64(std::uint64_t value) {
+        write(value, 8);
+    }
+};
+
+class Reader {
+    std::span<const std::uint8_t> data;
+    std::size_t offset = 0;
+    bool failed = false;
+
+    public:
+    explicit Reader(std::span<const std::uint8_t> data) : data(data) {}
+
+    std::uint64_t read(unsigned bytes) {
+        if (failed || data.size() - offset < bytes) {
+            failed = true;
+            return 0;
+        }
+
+        std::uint64_t value = 0;
+        for (unsigned index = 0; index < bytes; ++index) {
+            value |= std::uint64_t{ data[offset + index] } << (8 * index);
+        }
+        offset += bytes;
+        return value;
+    }
+    std::uint32_t read32() {
+        return static_cast<std::uint32_t>(read(4));
+    }
+    std::uint64_t read64() {
+        return read(8);
+    }
+
+    /**
+     * @return Returns true if the given number of elements of the given size can still be read.
+     */
+    bool hasRemaining(std::uint64_t count, std::size_t element_size) const {
+        return !failed && count <= (data.size() - offset) / element_size;
+    }
+    /**
+     * @return Returns true if all data was read without reading past the end.
+     */
+    bool isComplete() const {
+        return !failed && offset == data.size();
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+std::vector<std::uint8_t> BytecodeSerializer::serialize(const BytecodeFunction& function, const code::SourceCodeManagement& source_code) {
+    const auto& instructions = function.getInstructions();
+    const auto& registers = function.getInitialRegisters();
+    const auto& parameters = function.getParameterRegisters();
+    const auto& divisions = function.getDivisionReferences();
+
+    std::vector<std::uint8_t> data;
+    data.reserve(20 + instructions.size() * 16 + registers.size() * 8 + parameters.size() * 4 + divisions.size() * 8);
+    Writer writer{ data };
+
+    writer.write32(static_cast<std::uint32_t>(instructions.size()));
+    writer.write32(static_cast<std::uint32_t>(registers.size()));
+    writer.write32(static_cast<std::uint32_t>(parameters.size()));
+    writer.write32(static_cast<std::uint32_t>(divisions.size()));
+    writer.write32(function.hasParamDeclaration() ? 1 : 0);
+
+    for (const Instruction& instruction: instructions) {
+        writer.write32(static_cast<std::uint32_t>(instruction.opCode));
+        writer.write32(instruction.target);
+        writer.write32(instruction.lhs);
+        writer.write32(instruction.rhs);
+    }
+    for (long long value: registers) {
+        writer.write64(static_cast<std::uint64_t>(value));
+    }
+    for (register_id reg: parameters) {
+        writer.write32(reg);
+    }
+    for (const code::SourceCodeReference& reference: divisions) {
+        if (reference.isEmpty()) {
+            writer.write32(0);
+            writer.write32(0);
+        } else {
+            writer.write32(static_cast<std::uint32_t>(reference->data() - source_code.content().data()));
+            writer.write32(static_cast<std::uint32_t>(reference->size()));
+        }
+    }
+
+    return data;
+}
+
+std::optional<BytecodeFunction> BytecodeSerializer::deserialize(std::span<const std::uint8_t> data, const code::SourceCodeManagement& source_code) {
+    Reader reader{ data };
+
+    std::uint32_t instruction_count = reader.read32();
+    std::uint32_t register_count = reader.read32();
+    std::uint32_t parameter_count = reader.read32();
+    std::uint32_t division_count = reader.read32();
+    std::uint32_t has_param_declaration = reader.read32();
+
+    if (instruction_count == 0 || has_param_declaration > 1 || !reader.hasRemaining(instruction_count, 16)) {
+        return {};
+    }
+
+    std::vector<Instruction> instructions;
+    instructions.reserve(instruction_count);
+    for (std::uint32_t index = 0; index < instruction_count; ++index) {
+        std::uint32_t op_code = reader.read32();
+        Instruction instruction{ static_cast<OpCode>(op_code), reader.read32(), reader.read32(), reader.read32() };
+
+        if (op_code > static_cast<std::uint32_t>(OpCode::RETURN)
+            || instruction.target >= register_count || instruction.lhs >= register_count || instruction.rhs >= register_count) {
+            return {};
+        }
+        instructions.push_back(instruction);
+    }
+    if (instructions.back().opCode != OpCode::RETURN) {
+        return {};
+    }
+    auto divide_count = static_cast<std::size_t>(std::count_if(instructions.begin(), instructions.end(), [](const Instruction& instruction) {
+        return instruction.opCode == OpCode::DIVIDE;
+    }));
+    if (divide_count != division_count) {
+        return {};
+    }
+
+    if (!reader.hasRemaining(register_count, 8)) {
+        return {};
+    }
+    std::vector<long long> registers;
+    registers.reserve(register_count);
+    for (std::uint32_t index = 0; index < register_count; ++index) {
+        registers.push_back(static_cast<long long>(reader.read64()));
+    }
+
+    if (!reader.hasRemaining(parameter_count, 4)) {
+        return {};
+    }
+    std::vector<register_id> parameters;
+    parameters.reserve(parameter_count);
+    for (std::uint32_t index = 0; index < parameter_count; ++index) {
+        register_id reg = reader.read32();
+        if (reg >= register_count) {
+            return {};
+        }
+        parameters.push_back(reg);
+    }
+
+    if (!reader.hasRemaining(division_count, 8)) {
+        return {};
+    }
+    std::vector<code::SourceCodeReference> divisions;
+    divisions.reserve(division_count);
+    for (std::uint32_t index = 0; index < division_count; ++index) {
+        std::size_t offset = reader.read32();
+        std::size_t length = reader.read32();
+
+        if (length == 0) {
+            divisions.emplace_back();
+            continue;
+        }
+        if (offset > source_code.content().size() || length > source_code.content().size() - offset) {
+            return {};
+        }
+        divisions.push_back(source_code.reference(offset, length));
+    }
+
+    if (!reader.isComplete()) {
+        return {};
+    }
+
+    return BytecodeFunction{ std::move(instructions), std::move(registers), std::move(parameters), has_param_declaration == 1, std::move(divisions) };
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_BYTECODESERIALIZER_HPP
+#define PLJIT_BYTECODESERIALIZER_HPP
+
+#include "./Bytecode.hpp"
+#include "../code/SourceCodeManagement.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::bytecode {
+//---------------------------------------------------------------------------
+/**
+ * Converts a `BytecodeFunction` from and to a compact binary representation.
+ *
+ * The format consists of little-endian fixed-width integers: the counts of instructions, registers,
+ * parameters and divisions, followed by the instructions, the initial register image, the parameter registers
+ * and the source code ranges (offset and length) of every division. Source code references are stored
+ * as ranges, thus the function must be deserialized against the same source code it was compiled from.
+ */
+class BytecodeSerializer {
+    public:
+    /// Version of the binary format. Must be increased whenever the format changes.
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * Serializes the given function.
+     * @param function The function to serialize.
+     * @param source_code The source code the function was compiled from.
+     * @return Returns the binary representation.
+     */
+    static std::vector<std::uint8_t> serialize(const BytecodeFunction& function, const code::SourceCodeManagement& source_code);
+
+    /**
+     * Deserializes a function. The data is validated, such that corrupt data can't result in out-of-bounds accesses.
+     * @param data The binary representation.
+     * @param source_code The source code the function was compiled from.
+     * @return Returns the `BytecodeFunction`, empty if the data is malformed.
+     */
+    static std::optional<BytecodeFunction> deserialize(std::span<const std::uint8_t> data, const code::SourceCodeManagement& source_code);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bytecode
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_BYTECODESERIALIZER_HPP
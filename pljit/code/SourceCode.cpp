@@ -53,6 +53,10 @@ SourceCodeReference::SourceCodeReference(const SourceCodeReference& start, const
     assert(start->begin() < end->begin() && "Confused order constructing SourceCodeReference!");
 }
 
+bool SourceCodeReference::isEmpty() const {
+    return management == nullptr;
+}
+
 std::string_view SourceCodeReference::operator*() const {
     assert(management != nullptr && "Can't access content of an empty SourceCodeReference!");
     return string_content;
@@ -87,40 +91,59 @@ bool SourceCodeReference::operator==(const SourceCodeReference& rhs) const {
 }
 //---------------------------------------------------------------------------
 SourceCodeError::SourceCodeError(ErrorType errorType, std::string_view errorMessage, SourceCodeReference sourceCodeReference)
-    : errorType(errorType), errorMessage(errorMessage), codeReference(sourceCodeReference), codePosition(sourceCodeReference.position()) {}
+    : diagnostic{ errorType, errorMessage, sourceCodeReference }, causes(), source() {}
 
 ErrorType SourceCodeError::type() const {
-    return errorType;
+    return diagnostic.type;
 }
 
 std::string_view SourceCodeError::message() const {
-    return errorMessage;
+    return diagnostic.message;
 }
 
 const SourceCodeReference& SourceCodeError::reference() const {
-    return codeReference;
+    return diagnostic.reference;
 }
 
 CodePosition SourceCodeError::position() const {
-    return codePosition;
+    return diagnostic.reference.position();
 }
 
-const std::list<SourceCodeError>& SourceCodeError::attachedCauses() const {
+std::span<const Diagnostic> SourceCodeError::attachedCauses() const {
     return causes;
 }
 
 SourceCodeError& SourceCodeError::attachCause(SourceCodeError&& error_cause) {
-    causes.emplace_back(error_cause);
+    causes.reserve(causes.size() + 1 + error_cause.causes.size());
+    causes.push_back(error_cause.diagnostic);
+    causes.insert(causes.end(), error_cause.causes.begin(), error_cause.causes.end());
+    return *this;
+}
+
+SourceCodeError& SourceCodeError::retainSource(std::shared_ptr<const SourceCodeManagement> source_code) {
+    assert((diagnostic.reference.isEmpty() || diagnostic.reference.management == source_code.get()) && "Retained the wrong source code!");
+    source = std::move(source_code);
     return *this;
 }
 
 void SourceCodeError::printCompilerError() const {
+    print(diagnostic);
+
+    // PRINT CAUSES
+    for (auto& cause: causes) {
+        print(cause);
+    }
+}
+
+void SourceCodeError::print(const Diagnostic& diagnostic) {
+    const SourceCodeReference& codeReference = diagnostic.reference;
+    CodePosition codePosition = codeReference.position();
     unsigned line = codePosition.line();
     unsigned column = codePosition.column();
 
     // PRINT ERROR LINE
     std::cout << line << ':' << column << ": ";
-    std::cout << errorTypeStringRepresentation(errorType) << ": " << errorMessage << std::endl;
+    std::cout << errorTypeStringRepresentation(diagnostic.type) << ": " << diagnostic.message << std::endl;
 
     // PRINT CODE LINE
     std::string_view::iterator message_iterator_begin = codeReference->begin() - (column - 1);
@@ -145,11 +168,6 @@ void SourceCodeError::printCompilerError() const {
         std::cout << "~";
     }
     std::cout << std::endl;
-
-    // PRINT CAUSES
-    for (auto& cause: causes) {
-        cause.printCompilerError();
-    }
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::code
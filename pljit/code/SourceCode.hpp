@@ -5,8 +5,10 @@
 #ifndef PLJIT_SOURCECODE_HPP
 #define PLJIT_SOURCECODE_HPP
 
+#include <memory>
+#include <span>
 #include <string_view>
-#include <list>
+#include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit::code {
@@ -49,6 +51,7 @@ class CodePosition {
  */
 class SourceCodeReference {
     friend class SourceIterator; // allows access to private constructors!
+    friend class SourceCodeManagement; // allows access to private constructors!
     friend class SourceCodeError; // allow access to `management` for error printing!
 
     /// The parent `SourceCodeManagement`
@@ -68,6 +71,8 @@ class SourceCodeReference {
      */
     SourceCodeReference(const SourceCodeReference& start, const SourceCodeReference& end);
 
+    /// Returns true if the reference isn't associated with any `SourceCodeManagement`.
+    bool isEmpty() const;
     /// Access the underlying string_view.
     std::string_view operator*() const;
     /// Access the underlying string_view.
@@ -94,20 +99,32 @@ class SourceCodeReference {
     bool operator==(const SourceCodeReference& rhs) const;
 };
 //---------------------------------------------------------------------------
-class SourceCodeError {
+/**
+ * A single message of a `SourceCodeError`, pointing to some source code.
+ */
+struct Diagnostic {
     /// The `ErrorType` used for formatting.
-    ErrorType errorType;
-    /// The string_view pointing to the error message.
-    std::string_view errorMessage;
-    /// The source code reference that is the root cause of the error.
-    SourceCodeReference codeReference;
-    /// Position of where the error occurred.
-    CodePosition codePosition;
-
-    /// Optionally, causes or notes attached to the error.
-    std::list<SourceCodeError> causes;
-    public:
+    ErrorType type;
+    /// The string_view pointing to the message.
+    std::string_view message;
+    /// The source code reference the message refers to.
+    SourceCodeReference reference;
+};
+//---------------------------------------------------------------------------
+/**
+ * An error pointing to the source code. The references of its diagnostics don't own the source code,
+ * unless it was retained through `retainSource`.
+ */
+class SourceCodeError {
+    /// The error itself.
+    Diagnostic diagnostic;
+    /// The attached causes or notes, including the causes attached to them, flattened in the order they are printed.
+    /// Most errors have no causes, in which case nothing is allocated.
+    std::vector<Diagnostic> causes;
+    /// Keeps the referenced source code alive, if retained.
+    std::shared_ptr<const SourceCodeManagement> source;
 
+    public:
     SourceCodeError(ErrorType errorType, std::string_view errorMessage, SourceCodeReference sourceCodeReference);
 
     /**
@@ -123,13 +140,13 @@ class SourceCodeError {
      */
     const SourceCodeReference& reference() const;
     /**
-     * @return The `CodePosition` where the error occurred.
+     * @return The `CodePosition` where the error occurred. It's only calculated on request.
      */
     CodePosition position() const;
     /**
-     * @return The SourceCodeError causes attached to this error object.
+     * @return The causes attached to this error object, flattened in the order they are printed.
      */
-    const std::list<SourceCodeError>& attachedCauses() const;
+    std::span<const Diagnostic> attachedCauses() const;
 
     /**
      * Attach an cause to this `SourceCodeError`. Attached
@@ -138,10 +155,20 @@ class SourceCodeError {
      */
     SourceCodeError& attachCause(SourceCodeError&& error_cause);
 
+    /**
+     * Keeps the source code the diagnostics refer to alive as long as this error or any copy of it exists.
+     * @param source_code - The `SourceCodeManagement` of the references, possibly sharing the ownership of its owner.
+     * @return Returns `this` instance of the SourceCodeError, used for chaining.
+     */
+    SourceCodeError& retainSource(std::shared_ptr<const SourceCodeManagement> source_code);
+
     /**
      * Print the fully formatted error message to standard out.
      */
     void printCompilerError() const;
+
+    private:
+    static void print(const Diagnostic& diagnostic);
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::code
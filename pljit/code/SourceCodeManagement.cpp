@@ -3,7 +3,9 @@
 //
 
 #include "./SourceCodeManagement.hpp"
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 //---------------------------------------------------------------------------
 namespace pljit::code {
@@ -56,7 +58,13 @@ SourceCodeReference SourceIterator::codeReference() const {
 //---------------------------------------------------------------------------
 SourceCodeManagement::SourceCodeManagement(std::string&& source_code)
     : source_code(source_code),
-      source_code_view(this->source_code){
+      source_code_view(this->source_code),
+      line_offsets{ 0 } {
+    assert(source_code_view.size() < std::numeric_limits<std::uint32_t>::max() && "Source code exceeds the supported size!");
+
+    for (std::size_t offset = source_code_view.find('\n'); offset != std::string_view::npos; offset = source_code_view.find('\n', offset + 1)) {
+        line_offsets.push_back(static_cast<std::uint32_t>(offset + 1));
+    }
 }
 
 SourceIterator SourceCodeManagement::begin() const {
@@ -67,31 +75,30 @@ SourceIterator SourceCodeManagement::end() const {
     return { this, source_code_view.end() };
 }
 
+SourceIterator SourceCodeManagement::iterator(std::size_t offset) const {
+    assert(offset <= source_code_view.size() && "Illegal offset!");
+    return { this, source_code_view.begin() + static_cast<std::string_view::difference_type>(offset) };
+}
+
 std::string_view SourceCodeManagement::content() const {
     return source_code_view;
 }
 
-CodePosition SourceCodeManagement::getPosition(const SourceCodeReference& reference) const {
-    unsigned column = 0;
-    unsigned line = 1;
-
-    std::string_view::iterator iterator = reference->begin();
-    assert(iterator >= source_code_view.begin() && iterator <= source_code_view.end() && "Illegal range!");
-
-    while(--iterator >= source_code_view.begin()) {
-        if (*iterator == '\n') {
-            break;
-        }
-
-        ++column;
-    }
+SourceCodeReference SourceCodeManagement::reference(std::size_t offset, std::size_t length) const {
+    assert(offset <= source_code_view.size() && length <= source_code_view.size() - offset && "Illegal range!");
+    return { this, source_code_view.substr(offset, length) };
+}
 
-    for (; iterator >= source_code_view.begin(); --iterator) {
-        if (*iterator == '\n') {
-            ++line;
-        }
-    }
-    return { line, column + 1 };
+CodePosition SourceCodeManagement::getPosition(const SourceCodeReference& reference) const {
+    assert(reference->data() >= source_code_view.data() && reference->data() <= source_code_view.data() + source_code_view.size() && "Illegal range!");
+    auto offset = static_cast<std::uint32_t>(reference->data() - source_code_view.data());
+
+    // the line which starts last before (or at) the offset.
+    auto line = std::upper_bound(line_offsets.begin(), line_offsets.end(), offset) - 1;
+    return {
+        static_cast<unsigned>(line - line_offsets.begin()) + 1,
+        static_cast<unsigned>(offset - *line) + 1
+    };
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::code
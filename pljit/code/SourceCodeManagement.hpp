@@ -6,8 +6,10 @@
 #define PLJIT_SOURCECODEMANAGEMENT_H
 
 #include "./SourceCode.hpp"
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit::code {
@@ -55,6 +57,8 @@ class SourceIterator {
 class SourceCodeManagement {
     std::string source_code;
     std::string_view source_code_view;
+    /// The offset of the first character of every line, built once on construction. The first line starts at 0.
+    std::vector<std::uint32_t> line_offsets;
 
     public:
     explicit SourceCodeManagement(std::string&& source_code);
@@ -72,9 +76,23 @@ class SourceCodeManagement {
     std::string_view content() const;
     SourceIterator begin() const;
     SourceIterator end() const;
+    /**
+     * @param offset The index of a character of the source code. Might be the size of the source code.
+     * @return Returns a `SourceIterator` pointing to the character at the given offset.
+     */
+    SourceIterator iterator(std::size_t offset) const;
+
+    /**
+     * Create a `SourceCodeReference` for a range of the source code.
+     * @param offset The index of the first character of the reference.
+     * @param length The number of characters. The range must lie within the source code.
+     * @return Returns the `SourceCodeReference` for the given range.
+     */
+    SourceCodeReference reference(std::size_t offset, std::size_t length) const;
 
     /**
      * Calculate the Position of a given `SourceCodeReference`.
+     * Runs a binary search over the line offsets, so it's independent of the position within the source code.
      * @param reference - The `SourceCodeReference to calculate the codePosition for.
      * @return Returns the `CodePosition` of the first character in the SourceCodeReference!
      */
@@ -5,6 +5,9 @@
 #ifndef PLJIT_LANG_HPP
 #define PLJIT_LANG_HPP
 
+#include <array>
+#include <string_view>
+
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
@@ -15,6 +18,8 @@ struct Keyword {
     static constexpr std::string_view BEGIN = "BEGIN";
     static constexpr std::string_view END = "END";
     static constexpr std::string_view RETURN = "RETURN";
+
+    static constexpr std::array<std::string_view, 6> ALL{ PARAM, VAR, CONST, BEGIN, END, RETURN };
 };
 
 struct Operator {
@@ -0,0 +1,78 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./IdentifierTable.hpp"
+#include <cassert>
+#include <utility>
+
+//---------------------------------------------------------------------------
+namespace pljit::lex {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+std::uint32_t hashName(std::string_view name) {
+    // FNV-1a, identifiers are short so there is no need for anything wider.
+    std::uint32_t hash = 2166136261u;
+    for (char character: name) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+IdentifierTable::IdentifierTable() : slots(16), names() {}
+
+identifier_id IdentifierTable::intern(std::string_view name) {
+    std::uint32_t hash = hashName(name);
+    std::size_t mask = slots.size() - 1;
+
+    for (std::size_t index = hash & mask;; index = (index + 1) & mask) {
+        Slot& slot = slots[index];
+        if (slot.id == 0) {
+            if ((names.size() + 1) * 2 > slots.size()) {
+                grow();
+                return intern(name);
+            }
+
+            names.push_back(name);
+            slot = { hash, static_cast<std::uint32_t>(names.size()) };
+            return slot.id - 1;
+        }
+
+        if (slot.hash == hash && names[slot.id - 1] == name) {
+            return slot.id - 1;
+        }
+    }
+}
+
+std::string_view IdentifierTable::name(identifier_id id) const {
+    assert(id < names.size() && "Encountered unknown identifier id!");
+    return names[id];
+}
+
+std::size_t IdentifierTable::size() const {
+    return names.size();
+}
+
+void IdentifierTable::grow() {
+    std::vector<Slot> previous = std::exchange(slots, std::vector<Slot>(slots.size() * 2));
+    std::size_t mask = slots.size() - 1;
+
+    for (const Slot& slot: previous) {
+        if (slot.id == 0) {
+            continue;
+        }
+
+        std::size_t index = slot.hash & mask;
+        while (slots[index].id != 0) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::lex
+//---------------------------------------------------------------------------
@@ -0,0 +1,60 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_IDENTIFIERTABLE_HPP
+#define PLJIT_IDENTIFIERTABLE_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::lex {
+//---------------------------------------------------------------------------
+/// Dense id of an interned identifier name, starting at 0 in the order of first occurrence.
+using identifier_id = std::uint32_t;
+//---------------------------------------------------------------------------
+/**
+ * Interns the identifier names of a source code, so that every distinct name is hashed exactly once
+ * and later stages can look up identifiers by their dense `identifier_id`.
+ * Names are views into the source code and stay valid as long as the source code.
+ */
+class IdentifierTable {
+    struct Slot {
+        std::uint32_t hash = 0;
+        /// The `identifier_id` plus one, zero marks an empty slot.
+        std::uint32_t id = 0;
+    };
+
+    /// Open addressing hash table with linear probing, its size is always a power of two.
+    std::vector<Slot> slots;
+    std::vector<std::string_view> names;
+
+    public:
+    IdentifierTable();
+
+    /**
+     * @param name The identifier name.
+     * @return Returns the `identifier_id` of the name. Interns the name if it wasn't seen before.
+     */
+    identifier_id intern(std::string_view name);
+
+    /**
+     * @return Returns the name of a previously interned identifier.
+     */
+    std::string_view name(identifier_id id) const;
+
+    /**
+     * @return Returns the number of distinct identifiers.
+     */
+    std::size_t size() const;
+
+    private:
+    void grow();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::lex
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_IDENTIFIERTABLE_HPP
@@ -4,8 +4,13 @@
 
 #include "./Lexer.hpp"
 #include "../lang.hpp"
+#include <array>
+#include <bit>
 #include <cassert>
-#include <cctype>
+#include <limits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 //---------------------------------------------------------------------------
 namespace pljit {
@@ -16,54 +21,154 @@ namespace lex {
 //---------------------------------------------------------------------------
 namespace {
 //---------------------------------------------------------------------------
-bool isWhitespace(char character) {
-    return character == ' ' || character == '\n' || character == '\t';
-}
+/// The class of a single source code character.
+enum class CharacterClass : std::uint8_t {
+    /// A character which can't appear in a program.
+    INVALID,
+    WHITESPACE,
+    LETTER,
+    DIGIT,
+    SEPARATOR,
+    PARENTHESIS,
+    /// A single character operator.
+    OPERATOR,
+    /// The `:`, which is only valid as part of the `:=` operator.
+    COLON,
+};
+
+constexpr std::array<CharacterClass, 256> CHARACTER_CLASSES = [] {
+    std::array<CharacterClass, 256> classes{};
+    for (auto& characterClass: classes) {
+        characterClass = CharacterClass::INVALID;
+    }
 
-bool isSeparator(char character) {
-    return character == ',' || character == ';' || character == '.';
-}
+    for (unsigned char character: std::string_view{ " \n\t" }) {
+        classes[character] = CharacterClass::WHITESPACE;
+    }
+    for (unsigned char character = 'a'; character <= 'z'; ++character) {
+        classes[character] = CharacterClass::LETTER;
+        classes[character - 'a' + 'A'] = CharacterClass::LETTER;
+    }
+    for (unsigned char character = '0'; character <= '9'; ++character) {
+        classes[character] = CharacterClass::DIGIT;
+    }
+    for (unsigned char character: std::string_view{ ",;." }) {
+        classes[character] = CharacterClass::SEPARATOR;
+    }
+    for (unsigned char character: std::string_view{ "()" }) {
+        classes[character] = CharacterClass::PARENTHESIS;
+    }
+    for (unsigned char character: std::string_view{ "+-*/=" }) {
+        classes[character] = CharacterClass::OPERATOR;
+    }
+    classes[static_cast<unsigned char>(':')] = CharacterClass::COLON;
 
-bool isAlphanumeric(char character) {
-    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z');
-}
+    return classes;
+}();
 
-bool isIntegerLiteral(char character) {
-    return std::isdigit(character);
+CharacterClass classOf(char character) {
+    return CHARACTER_CLASSES[static_cast<unsigned char>(character)];
 }
 
-bool isParenthesis(char character) {
-    return character == '(' || character == ')';
-}
+constexpr std::size_t KEYWORD_TABLE_SIZE = 16;
 
-bool isOperator(char character) {
-    return character == '+' || character == '-' || character == '*' || character == '/' || character == '=' || character == ':';
+constexpr std::size_t keywordHash(std::string_view view, std::size_t multiplier) {
+    return (view.size() + static_cast<unsigned char>(view.front()) * multiplier + static_cast<unsigned char>(view.back())) & (KEYWORD_TABLE_SIZE - 1);
 }
 
+/// The smallest multiplier for which `keywordHash` maps all `Keyword::ALL` to distinct slots, zero if there is none.
+constexpr std::size_t KEYWORD_HASH_MULTIPLIER = [] {
+    for (std::size_t multiplier = 1; multiplier < 256; ++multiplier) {
+        std::array<bool, KEYWORD_TABLE_SIZE> used{};
+        bool perfect = true;
+        for (std::string_view keyword: Keyword::ALL) {
+            std::size_t slot = keywordHash(keyword, multiplier);
+            perfect = perfect && !used[slot];
+            used[slot] = true;
+        }
+        if (perfect) {
+            return multiplier;
+        }
+    }
+    return std::size_t{ 0 };
+}();
+static_assert(KEYWORD_HASH_MULTIPLIER != 0, "Couldn't find a perfect hash for the keywords!");
+
+/// The keywords placed at their perfect hash slot. Unused slots hold an empty view.
+constexpr std::array<std::string_view, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = [] {
+    std::array<std::string_view, KEYWORD_TABLE_SIZE> table{};
+    for (std::string_view keyword: Keyword::ALL) {
+        table[keywordHash(keyword, KEYWORD_HASH_MULTIPLIER)] = keyword;
+    }
+    return table;
+}();
+
 bool isKeyword(std::string_view view) {
-    return view == Keyword::PARAM || view == Keyword::VAR || view == Keyword::CONST || view == Keyword::BEGIN || view == Keyword::END || view == Keyword::RETURN;
+    // identifiers are never empty, so an unused slot never matches.
+    return KEYWORD_TABLE[keywordHash(view, KEYWORD_HASH_MULTIPLIER)] == view;
 }
 
-Token::Type typeOfCharacter(char character) {
-    if (isAlphanumeric(character)) {
-        // Type::KEYWORD is handled in `Token::finalize`.
-        return Token::Type::IDENTIFIER;
-    } else if (isOperator(character)) {
-        return Token::Type::OPERATOR;
-    } else if (isSeparator(character)) {
-        return Token::Type::SEPARATOR;
-    } else if (isIntegerLiteral(character)) {
-        return Token::Type::LITERAL;
-    } else if (isParenthesis(character)) {
-        return Token::Type::PARENTHESIS;
-    } else {
-        return Token::Type::EMPTY;
+#if defined(__x86_64__)
+/**
+ * Matches 16 characters against a run of the given `CharacterClass`.
+ * @return Returns a bit mask with a bit set for every character which is part of the run.
+ */
+unsigned matchRun(__m128i characters, CharacterClass characterClass) {
+    __m128i matches;
+    switch (characterClass) {
+        case CharacterClass::WHITESPACE:
+            matches = _mm_or_si128(
+                _mm_cmpeq_epi8(characters, _mm_set1_epi8(' ')),
+                _mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(characters, _mm_set1_epi8('\t'))));
+            break;
+        case CharacterClass::LETTER: {
+            // lower case all letters, then check `character - 'a' < 26` using an unsigned comparison
+            __m128i offset = _mm_sub_epi8(_mm_or_si128(characters, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            matches = _mm_cmplt_epi8(_mm_xor_si128(offset, _mm_set1_epi8(-128)), _mm_set1_epi8(-128 + 26));
+            break;
+        }
+        case CharacterClass::DIGIT: {
+            __m128i offset = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+            matches = _mm_cmplt_epi8(_mm_xor_si128(offset, _mm_set1_epi8(-128)), _mm_set1_epi8(-128 + 10));
+            break;
+        }
+        default:
+            assert(false && "Only whitespace, letters and digits form runs!");
+            return 0;
     }
+    return static_cast<unsigned>(_mm_movemask_epi8(matches));
+}
+#endif
+
+/**
+ * Skips all characters of the given `CharacterClass`, starting at `position`.
+ * @return Returns the position of the first character not belonging to the run, or the size of the source.
+ */
+std::size_t skipRun(std::string_view source, std::size_t position, CharacterClass characterClass) {
+#if defined(__x86_64__)
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    for (; position + 16 <= source.size(); position += 16) {
+        __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + position));
+        unsigned mismatches = ~matchRun(characters, characterClass) & 0xFFFFu;
+        if (mismatches != 0) {
+            return position + static_cast<std::size_t>(std::countr_zero(mismatches));
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+#endif
+
+    while (position < source.size() && classOf(source[position]) == characterClass) {
+        ++position;
+    }
+    return position;
 }
 //---------------------------------------------------------------------------
 } // namespace
 //---------------------------------------------------------------------------
-Token::Token() : type(Type::EMPTY), source_code() {}
+Token::Token() : type(Type::EMPTY), source_code(), identifier(0) {}
+
+Token::Token(Type type, SourceCodeReference source_code, identifier_id identifier)
+    : type(type), source_code(source_code), identifier(identifier) {}
 
 bool Token::isEmpty() const {
     return type == Type::EMPTY;
@@ -77,6 +182,11 @@ Token::Type Token::getType() const {
     return type;
 }
 
+identifier_id Token::getIdentifier() const {
+    assert(type == Type::IDENTIFIER && "Only identifiers are interned!");
+    return identifier;
+}
+
 SourceCodeReference Token::reference() const {
     assert(type != Type::EMPTY && "Can't access the source code reference of an empty token!");
     return source_code;
@@ -90,174 +200,170 @@ bool Token::is(Token::Type token_type, std::string_view content) const {
     return type == token_type && *source_code == content;
 }
 
-Token::ExtendResult Token::extend(SourceIterator character) {
-    Type next_type = typeOfCharacter(*character);
-    if (next_type == Type::EMPTY) {
-        // encountered unknown character type!
-        return ExtendResult::ERRONEOUS_CHARACTER;
-    }
+bool Token::operator==(const Token& rhs) const {
+    return type == rhs.type &&
+        source_code == rhs.source_code;
+}
+//---------------------------------------------------------------------------
+Lexer::Lexer(const SourceCodeManagement& management)
+    : management(&management), tokens(), identifiers(), lexical_error(), cursor(0) {
+    tokenize();
+}
 
-    if (type == Type::EMPTY) {
-        type = typeOfCharacter(*character);
-        source_code = character.codeReference();
-        return ExtendResult::EXTENDED;
-    }
+void Lexer::tokenize() {
+    std::string_view source = management->content();
+    assert(source.size() < std::numeric_limits<std::uint32_t>::max() && "Source code exceeds the supported size!");
 
-    if (next_type != type) {
-        if (type == Type::OPERATOR && *source_code == ":") {
-            return ExtendResult::INCOMPLETE_TOKEN;
-        }
+    // most tokens are followed by a whitespace, so this is a good estimate without reserving too much.
+    tokens.reserve(source.size() / 4 + 1);
 
-        return ExtendResult::END_OF_TOKEN;
-    }
+    std::size_t position = 0;
+    while (true) {
+        position = skipRun(source, position, CharacterClass::WHITESPACE);
+        if (position == source.size()) {
+            tokens.push_back({ static_cast<std::uint32_t>(position), 0, Token::Type::EMPTY });
+            return;
+        }
 
-    // if we reach here, at least one character was added to the token.
-    // we need to ensure that we signal END_OF_TOKEN of single character token types
-    if (type == Type::SEPARATOR || type == Type::PARENTHESIS) {
-        return ExtendResult::END_OF_TOKEN;
-    } else if (type == Type::OPERATOR) {
-        // operator is special, as we have the `:=` operator of length 2.
-        if (source_code->size() >= 2) {
-            return ExtendResult::END_OF_TOKEN;
+        std::size_t start = position;
+        Token::Type type = Token::Type::EMPTY;
+        identifier_id identifier = 0;
+
+        switch (classOf(source[position])) {
+            case CharacterClass::WHITESPACE:
+                assert(false && "Whitespace was skipped above!");
+                break;
+            case CharacterClass::INVALID:
+                lexical_error = management->reference(position, 1)
+                                    .makeError(ErrorType::ERROR, "Unexpected character!");
+                break;
+            case CharacterClass::LETTER: {
+                position = skipRun(source, position + 1, CharacterClass::LETTER);
+                std::string_view name = source.substr(start, position - start);
+                if (isKeyword(name)) {
+                    type = Token::Type::KEYWORD;
+                } else {
+                    type = Token::Type::IDENTIFIER;
+                    identifier = identifiers.intern(name);
+                }
+                break;
+            }
+            case CharacterClass::DIGIT:
+                position = skipRun(source, position + 1, CharacterClass::DIGIT);
+                type = Token::Type::LITERAL;
+                break;
+            case CharacterClass::SEPARATOR:
+                ++position;
+                type = Token::Type::SEPARATOR;
+                break;
+            case CharacterClass::PARENTHESIS:
+                ++position;
+                type = Token::Type::PARENTHESIS;
+                break;
+            case CharacterClass::OPERATOR:
+                ++position;
+                type = Token::Type::OPERATOR;
+                break;
+            case CharacterClass::COLON:
+                type = Token::Type::OPERATOR;
+                if (position + 1 == source.size()) {
+                    lexical_error = management->reference(position, 1)
+                                        .makeError(ErrorType::ERROR, "Unexpected end of stream on incomplete Token!");
+                } else if (source[position + 1] == '=') {
+                    position += 2;
+                } else if (CharacterClass next = classOf(source[position + 1]); next == CharacterClass::WHITESPACE || next == CharacterClass::INVALID) {
+                    // a lone `:` is emitted as is and rejected by the parser.
+                    ++position;
+                } else {
+                    lexical_error = management->reference(position + 1, 1)
+                                        .makeError(ErrorType::ERROR, "Unexpected character to complete token!");
+                    lexical_error->attachCause(management->reference(position, 1).makeError(ErrorType::NOTE, "partial token here"));
+                }
+                break;
         }
 
-        if (*source_code != ":") {
-            // we only allow to extend if current operator character is `:` and we want to extend with `=` to form `:=`.
-            // While we could build a more abstract solution, capable of handling multiple multi character operators and
-            // not dealing with magic constants, we don't (for now). We only need to handle a single character that is special in this way.
-            return ExtendResult::END_OF_TOKEN;
-        } else if (*character != '=') {
-            return ExtendResult::INCOMPLETE_TOKEN;
+        if (!lexical_error && position < source.size() && classOf(source[position]) == CharacterClass::INVALID) {
+            // a token must not be directly followed by an invalid character.
+            lexical_error = management->reference(position, 1)
+                                .makeError(ErrorType::ERROR, "Unexpected character!");
         }
-    }
 
-    source_code.extend(1);
-    return ExtendResult::EXTENDED;
-}
+        if (lexical_error) {
+            // the terminating token points to the start of the token which failed.
+            tokens.push_back({ static_cast<std::uint32_t>(start), 0, Token::Type::EMPTY });
+            return;
+        }
 
-void Token::finalize() {
-    if (type == Type::IDENTIFIER && isKeyword(*source_code)) {
-        type = Type::KEYWORD;
+        tokens.push_back({ static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(position - start), type, identifier });
     }
 }
 
-bool Token::operator==(const Token& rhs) const {
-    return type == rhs.type &&
-        source_code == rhs.source_code;
-}
-//---------------------------------------------------------------------------
-Lexer::Lexer(const SourceCodeManagement& management)
-    : management(&management), current_position(management.begin()), returnedWithError(false) {}
-
-bool Lexer::endOfStream() {
-    // might be the case that there are more than one whitespaces after the `.` terminator.
-    // We want to report endOfStream as true, even when there are only whitespaces remaining.
-    while (current_position != management->end() && isWhitespace(*current_position)) {
-        ++current_position;
-    }
-
-    return current_position == management->end();
+bool Lexer::endOfStream() const {
+    return tokens[cursor].type == Token::Type::EMPTY && !lexical_error;
 }
 
 SourceIterator Lexer::cur_position() const {
-    return current_position;
+    return management->iterator(tokens[cursor].offset);
 }
 
-Result<Token> Lexer::peek_next() {
-    if (next_result.has_value()) {
-        return *next_result;
-    }
+std::span<const PackedToken> Lexer::packed_tokens() const {
+    return tokens;
+}
 
-    next_result = next();
-    // we mark `returnedWithError` only when calling `consume_next` or `consume`.
-    return *next_result;
+const IdentifierTable& Lexer::identifier_table() const {
+    return identifiers;
 }
 
-Result<Token> Lexer::consume_next() {
-    if (next_result.has_value()) {
-        Result<Token> result = *next_result;
-        next_result.reset();
-        return result;
+Token Lexer::peek() const {
+    const PackedToken& token = tokens[cursor];
+    if (token.type == Token::Type::EMPTY) {
+        return {};
     }
+    return { token.type, management->reference(token.offset, token.length), token.identifier };
+}
 
-    Result<Token> result = next();
-    if (!result) {
-        returnedWithError = true;
+void Lexer::advance() {
+    if (tokens[cursor].type != Token::Type::EMPTY) {
+        ++cursor;
     }
-    return result;
 }
 
-void Lexer::consume(const Token& result) {
-    assert(next_result.has_value() && "Tried to consume Token when nothing was peeked!");
-    assert(next_result && "Tried to consume Token in erroneous state!");
-    assert(next_result->value() == result && "Tried consuming unexpected Token!");
-
-    next_result.reset();
+Token Lexer::next() {
+    Token token = peek();
+    advance();
+    return token;
 }
 
-Result<Token> Lexer::next() {
-    assert(!returnedWithError && "Can't continue lexicographical analysis after encountering an error!");
-
-    Token token; // creates an `EMPTY` token.
-
-    for (; current_position != management->end(); ++current_position) {
-        if (isWhitespace(*current_position)) {
-            if (token.isEmpty()) {
-                continue; // we skip whitespaces till we find something!
-            }
-
-            ++current_position; // consume the whitespace and return the token!
-
-            token.finalize();
-            return token;
-        }
-
-        Token::ExtendResult extend_result = token.extend(current_position);
-        switch (extend_result) {
-            case Token::ExtendResult::EXTENDED:
-                continue;
-            case Token::ExtendResult::ERRONEOUS_CHARACTER: {
-                return current_position
-                    .codeReference()
-                    .makeError(ErrorType::ERROR, "Unexpected character!");
-            }
-            case Token::ExtendResult::INCOMPLETE_TOKEN: {
-                SourceCodeError error = current_position
-                                            .codeReference()
-                                            .makeError(code::ErrorType::ERROR, "Unexpected character to complete token!");
-                if (!token.isEmpty()) {
-                    error.attachCause(token.reference().makeError(code::ErrorType::NOTE, "partial token here"));
-                }
-                return error;
-            }
-            case Token::ExtendResult::END_OF_TOKEN:
-                assert(current_position != management->begin()); // can't be by definition, at least one character was processed.
-
-                // we received a character which doesn't match the current token type
-                // we want to parse_program that character in the next query again (so we don't increment)!
-
-                token.finalize();
-                return token;
-        }
+SourceCodeError Lexer::error() const {
+    assert(tokens[cursor].type == Token::Type::EMPTY && "The error is only available at the terminating token!");
+    if (lexical_error) {
+        return *lexical_error;
     }
+    return management->end()
+        .codeReference()
+        .makeError(ErrorType::ERROR, "Unexpected end of stream!");
+}
 
-    // we reach here either if we break out of the loop or if we reach the end of the source code.
-
+Result<Token> Lexer::peek_next() const {
+    Token token = peek();
     if (token.isEmpty()) {
-        return current_position
-            .codeReference()
-            .makeError(ErrorType::ERROR, "Unexpected end of stream!");
+        return error();
     }
+    return token;
+}
 
-    if (token.isIncomplete()) {
-        return token
-            .reference()
-            .makeError(ErrorType::ERROR, "Unexpected end of stream on incomplete Token!");
+Result<Token> Lexer::consume_next() {
+    Token token = next();
+    if (token.isEmpty()) {
+        return error();
     }
-
-    token.finalize();
     return token;
 }
+
+void Lexer::consume([[maybe_unused]] const Token& result) {
+    assert(peek() == result && "Tried consuming unexpected Token!");
+    advance();
+}
 //---------------------------------------------------------------------------
 } // namespace lex
 //---------------------------------------------------------------------------
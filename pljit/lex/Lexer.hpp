@@ -5,9 +5,13 @@
 #ifndef PLJIT_LEXER_HPP
 #define PLJIT_LEXER_HPP
 
+#include "./IdentifierTable.hpp"
 #include "../code/SourceCodeManagement.hpp"
 #include "../util/Result.hpp"
+#include <cstdint>
 #include <optional>
+#include <span>
+#include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit::lex {
@@ -37,25 +41,12 @@ class Token {
         PARENTHESIS,
     };
 
-    /// Describes the result of the token `extend` operation.
-    enum class ExtendResult {
-        /// The Token was extended with the given character.
-        EXTENDED,
-        /// The Token was not extended. The character was illegal.
-        ERRONEOUS_CHARACTER,
-        /// The Token was not extended.
-        /// The given character either doesn't match the given {@class Type} or the Token is already considered complete
-        /// (e.g. for single character operators).
-        /// The Token should be considered complete and the character should be considered part of a new Token.
-        END_OF_TOKEN,
-        /// The character given to extend the Token was invalid.
-        /// Therefore, the given token was not extended and is considered incomplete.
-        INCOMPLETE_TOKEN,
-    };
-
     private:
     Type type;
     code::SourceCodeReference source_code;
+    identifier_id identifier;
+
+    Token(Type type, code::SourceCodeReference source_code, identifier_id identifier);
 
     public:
     /// Creates an empty Token. `Type` is set to `EMPTY` and the source code is not accessible.
@@ -76,6 +67,10 @@ class Token {
      * @return Returns the type of the Token!
      */
     Type getType() const;
+    /**
+     * @return Returns the interned id of an `IDENTIFIER` Token, see {@class IdentifierTable}.
+     */
+    identifier_id getIdentifier() const;
 
     /**
      * Get access to the source code of the `Token`.
@@ -101,37 +96,80 @@ class Token {
 
     bool operator==(const Token& rhs) const;
 
-    private:
-    /**
-     * Extends this Token with another character.
-     * @param character An SourceIterator pointing to a character which should be added to the Token.
-     * @return Returns the result of the extend operation.
-     */
-    ExtendResult extend(code::SourceIterator character);
-
-    /**
-     * Finalizes the Token. This must be called at the end of construction.
-     * For example, it checks if a captured IDENTIFIER is a KEYWORD and updates the token type accordingly.
-     */
-    void finalize();
-
 };
 //---------------------------------------------------------------------------
+/**
+ * A `Token` packed into 16 bytes, referring to its source code by offset and length.
+ */
+struct PackedToken {
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+    Token::Type type = Token::Type::EMPTY;
+    /// The interned id of an `IDENTIFIER`.
+    identifier_id identifier = 0;
+};
+//---------------------------------------------------------------------------
+/**
+ * Splits a source code into its tokens. The whole source is tokenized on construction
+ * into a dense array of `PackedToken`s, which is then consumed through a cursor.
+ *
+ * The array is always terminated by a `Token::Type::EMPTY` token. It either marks the end of the source code
+ * or the position of a lexical error. In both cases `error()` describes why no further token is available.
+ */
 class Lexer {
     const code::SourceCodeManagement* management;
-    code::SourceIterator current_position;
 
-    /// Temporary variable to store Result instances that were peeked but not yet consumed!
-    std::optional<Result<Token>> next_result;
-    bool returnedWithError;
+    std::vector<PackedToken> tokens;
+    /// The identifiers interned while tokenizing.
+    IdentifierTable identifiers;
+    /// Set if the terminating token marks a lexical error, rather than the end of the source code.
+    std::optional<code::SourceCodeError> lexical_error;
+
+    /// Index of the next `Token` in `tokens`.
+    std::size_t cursor;
 
     public:
     explicit Lexer(const code::SourceCodeManagement& management);
 
-    bool endOfStream();
+    /**
+     * @return Returns `true` if all tokens were consumed and the rest of the source code only contains whitespace.
+     */
+    bool endOfStream() const;
 
+    /**
+     * @return Returns the position of the first character of the next `Token`.
+     * For the terminating token, this is either the end of the source code or the start of the erroneous token.
+     */
     code::SourceIterator cur_position() const;
 
+    /**
+     * @return Returns the dense array of all tokens, including the terminating `Token::Type::EMPTY` token.
+     */
+    std::span<const PackedToken> packed_tokens() const;
+    /**
+     * @return Returns the `IdentifierTable` holding the names of all `IDENTIFIER` tokens.
+     */
+    const IdentifierTable& identifier_table() const;
+
+    /**
+     * Peeks the next `Token` without advancing the cursor.
+     * @return Returns the next `Token`. Returns an `EMPTY` Token for the terminating token, see `error()`.
+     */
+    Token peek() const;
+    /**
+     * Advances the cursor to the next `Token`. Stays on the terminating token.
+     */
+    void advance();
+    /**
+     * Returns the next `Token` and advances the cursor.
+     */
+    Token next();
+    /**
+     * @return Returns the error to report when reaching the terminating token: either the lexical error
+     * or an unexpected end of stream.
+     */
+    code::SourceCodeError error() const;
+
     /**
      * Peeks the next `Token`.
      * Peeking will parse_program the next `Token` without advancing the reader index.
@@ -139,7 +177,7 @@ class Lexer {
      * See {@link consume_next()}.
      * @return The next `Token` without consuming it.
      */
-    Result<Token> peek_next();
+    Result<Token> peek_next() const;
     /**
      * Consumes the next `Token`.
      * Consuming means, parsing the next `Token` and advancing the reader index
@@ -155,9 +193,9 @@ class Lexer {
 
     private:
     /**
-     * Internal implementation to derive the next Token.
+     * Tokenizes the whole source code into `tokens`.
      */
-    Result<Token> next();
+    void tokenize();
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::lex
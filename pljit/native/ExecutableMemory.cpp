@@ -0,0 +1,67 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./ExecutableMemory.hpp"
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+ExecutableMemory::ExecutableMemory(void* memory, std::size_t size) : memory(memory), size(size) {}
+
+std::optional<ExecutableMemory> ExecutableMemory::allocate(const std::vector<std::uint8_t>& code) {
+    auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t size = (code.size() + page_size - 1) / page_size * page_size;
+    if (size == 0) {
+        return {};
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) { // NOLINT(performance-no-int-to-ptr)
+        return {};
+    }
+
+    std::memcpy(memory, code.data(), code.size());
+
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return {};
+    }
+
+    return ExecutableMemory{ memory, size };
+}
+
+ExecutableMemory::~ExecutableMemory() {
+    if (memory != nullptr) {
+        munmap(memory, size);
+    }
+}
+
+ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept : memory(other.memory), size(other.size) {
+    other.memory = nullptr;
+    other.size = 0;
+}
+
+ExecutableMemory& ExecutableMemory::operator=(ExecutableMemory&& other) noexcept {
+    if (this != &other) {
+        if (memory != nullptr) {
+            munmap(memory, size);
+        }
+
+        memory = other.memory;
+        size = other.size;
+        other.memory = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+const void* ExecutableMemory::data() const {
+    return memory;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
@@ -0,0 +1,54 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_EXECUTABLEMEMORY_HPP
+#define PLJIT_EXECUTABLEMEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+/**
+ * Owns a mmap'd region holding machine code.
+ * The region is never writable and executable at the same time (W^X): the code is copied
+ * while the pages are mapped read/write and then the pages are remapped read/execute.
+ */
+class ExecutableMemory {
+    void* memory;
+    std::size_t size;
+
+    ExecutableMemory(void* memory, std::size_t size);
+
+    public:
+    /**
+     * Maps new pages, copies the given code into them and makes them executable.
+     * @param code The machine code.
+     * @return Returns the `ExecutableMemory` or an empty optional if the system refused to map the memory.
+     */
+    static std::optional<ExecutableMemory> allocate(const std::vector<std::uint8_t>& code);
+
+    ~ExecutableMemory();
+
+    /// Delete copy construction. The region has a single owner.
+    ExecutableMemory(const ExecutableMemory& other) = delete;
+    /// Move constructor.
+    ExecutableMemory(ExecutableMemory&& other) noexcept;
+
+    /// Delete copy assignment. The region has a single owner.
+    ExecutableMemory& operator=(const ExecutableMemory& other) = delete;
+    /// Move assignment.
+    ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+
+    /// Returns a pointer to the first byte of the code.
+    const void* data() const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_EXECUTABLEMEMORY_HPP
@@ -0,0 +1,299 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./NativeCompiler.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+using bytecode::OpCode;
+using bytecode::register_id;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Machine registers available for bytecode registers. Caller saved registers come first, as they are free to use.
+constexpr Reg ALLOCATABLE_REGISTERS[] = {
+    Reg::R8, Reg::R9, Reg::R10, Reg::R11,
+    Reg::RBX, Reg::R12, Reg::R13, Reg::R14, Reg::R15,
+};
+
+bool isCalleeSaved(Reg reg) {
+    return reg == Reg::RBX || reg == Reg::R12 || reg == Reg::R13 || reg == Reg::R14 || reg == Reg::R15;
+}
+
+bool fitsImmediate32(long long value) {
+    return value >= std::numeric_limits<std::int32_t>::min() && value <= std::numeric_limits<std::int32_t>::max();
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+NativeCompiler::NativeCompiler() = default;
+
+std::optional<NativeFunction> NativeCompiler::compile(const bytecode::BytecodeFunction& function) {
+#if defined(__x86_64__)
+    assembler = X86Assembler{};
+    auto [saved_registers, frame_size] = allocate(function);
+
+    X86Assembler::Label success = assembler.createLabel();
+    X86Assembler::Label epilogue = assembler.createLabel();
+    // every division has its own error exit, such that the failing division can be reported
+    std::vector<X86Assembler::Label> division_by_zero;
+
+    // PROLOGUE
+    for (Reg reg: saved_registers) {
+        assembler.push(reg);
+    }
+    if (frame_size > 0) {
+        assembler.sub(Reg::RSP, frame_size);
+    }
+
+    // LOAD ARGUMENTS (RDI points to the argument array)
+    auto& parameters = function.getParameterRegisters();
+    for (std::size_t index = 0; index < parameters.size(); ++index) {
+        const Location& location = locations[parameters[index]];
+        Memory argument{ Reg::RDI, static_cast<std::int32_t>(index * sizeof(long long)) };
+
+        if (location.kind == Location::Kind::REGISTER) {
+            assembler.mov(location.reg, argument);
+        } else if (location.kind == Location::Kind::STACK) {
+            assembler.mov(Reg::RAX, argument);
+            store(location, Reg::RAX);
+        }
+    }
+
+    // BODY
+    for (auto& instruction: function.getInstructions()) {
+        const Location& target = locations[instruction.target];
+        const Location& lhs = locations[instruction.lhs];
+        const Location& rhs = locations[instruction.rhs];
+
+        switch (instruction.opCode) {
+            case OpCode::MOVE: {
+                Reg work = target.kind == Location::Kind::REGISTER ? target.reg : Reg::RAX;
+                load(work, lhs);
+                store(target, work);
+                break;
+            }
+            case OpCode::NEGATE: {
+                Reg work = target.kind == Location::Kind::REGISTER ? target.reg : Reg::RAX;
+                load(work, lhs);
+                assembler.neg(work);
+                store(target, work);
+                break;
+            }
+            case OpCode::ADD:
+            case OpCode::SUBTRACT:
+            case OpCode::MULTIPLY: {
+                // compute in place if the target register isn't the right operand
+                bool in_place = target.kind == Location::Kind::REGISTER
+                    && !(rhs.kind == Location::Kind::REGISTER && rhs.reg == target.reg);
+                Reg work = in_place ? target.reg : Reg::RAX;
+                load(work, lhs);
+                arithmetic(instruction.opCode, work, rhs);
+                store(target, work);
+                break;
+            }
+            case OpCode::DIVIDE: {
+                X86Assembler::Label error_exit = division_by_zero.emplace_back(assembler.createLabel());
+                load(Reg::RAX, lhs);
+
+                Reg divisor = Reg::RCX;
+                if (rhs.kind == Location::Kind::IMMEDIATE) {
+                    if (rhs.value == 0) {
+                        assembler.jmp(error_exit);
+                    }
+                    assembler.mov(Reg::RCX, rhs.value);
+                } else {
+                    if (rhs.kind == Location::Kind::REGISTER) {
+                        divisor = rhs.reg;
+                    } else {
+                        load(Reg::RCX, rhs);
+                    }
+                    assembler.test(divisor, divisor);
+                    assembler.jz(error_exit);
+                }
+
+                assembler.cqo();
+                assembler.idiv(divisor);
+                store(target, Reg::RAX);
+                break;
+            }
+            case OpCode::RETURN:
+                load(Reg::RAX, lhs);
+                assembler.jmp(success);
+                break;
+        }
+    }
+
+    // SUCCESS (RSI points to the result)
+    assembler.bind(success);
+    assembler.mov(Memory{ Reg::RSI, 0 }, Reg::RAX);
+    assembler.mov(Reg::RAX, 0);
+
+    // EPILOGUE
+    assembler.bind(epilogue);
+    if (frame_size > 0) {
+        assembler.add(Reg::RSP, frame_size);
+    }
+    for (auto iterator = saved_registers.rbegin(); iterator != saved_registers.rend(); ++iterator) {
+        assembler.pop(*iterator);
+    }
+    assembler.ret();
+
+    // RUNTIME ERRORS (return the index of the failing division plus one)
+    for (std::size_t index = 0; index < division_by_zero.size(); ++index) {
+        assembler.bind(division_by_zero[index]);
+        assembler.mov(Reg::RAX, static_cast<long long>(index + 1));
+        assembler.jmp(epilogue);
+    }
+
+    std::optional<ExecutableMemory> memory = ExecutableMemory::allocate(assembler.finalize());
+    if (!memory) {
+        return {};
+    }
+
+    return NativeFunction{ std::move(*memory), parameters.size(), function.hasParamDeclaration(), function.getDivisionReferences() };
+#else
+    static_cast<void>(function);
+    return {};
+#endif
+}
+
+std::pair<std::vector<Reg>, std::int32_t> NativeCompiler::allocate(const bytecode::BytecodeFunction& function) {
+    std::size_t register_count = function.register_count();
+
+    std::vector<bool> written(register_count);
+    std::vector<unsigned> uses(register_count);
+
+    for (register_id reg: function.getParameterRegisters()) {
+        written[reg] = true;
+        ++uses[reg];
+    }
+
+    for (auto& instruction: function.getInstructions()) {
+        if (instruction.opCode != OpCode::RETURN) {
+            written[instruction.target] = true;
+            ++uses[instruction.target];
+        }
+        ++uses[instruction.lhs];
+        if (instruction.opCode != OpCode::MOVE && instruction.opCode != OpCode::NEGATE && instruction.opCode != OpCode::RETURN) {
+            ++uses[instruction.rhs];
+        }
+    }
+
+    locations.assign(register_count, Location{ Location::Kind::IMMEDIATE, Reg::RAX, 0, 0 });
+
+    // registers that are never written hold the literal or CONST value of the initial register image.
+    std::vector<register_id> variables;
+    for (register_id reg = 0; reg < register_count; ++reg) {
+        if (written[reg]) {
+            variables.push_back(reg);
+        } else {
+            locations[reg].value = function.getInitialRegisters()[reg];
+        }
+    }
+
+    std::stable_sort(variables.begin(), variables.end(), [&](register_id lhs, register_id rhs) {
+        return uses[lhs] > uses[rhs];
+    });
+
+    std::vector<Reg> saved_registers;
+    std::int32_t frame_size = 0;
+
+    std::size_t index = 0;
+    for (; index < variables.size() && index < std::size(ALLOCATABLE_REGISTERS); ++index) {
+        Reg reg = ALLOCATABLE_REGISTERS[index];
+        locations[variables[index]] = Location{ Location::Kind::REGISTER, reg, 0, 0 };
+
+        if (isCalleeSaved(reg)) {
+            saved_registers.push_back(reg);
+        }
+    }
+
+    for (; index < variables.size(); ++index) {
+        locations[variables[index]] = Location{ Location::Kind::STACK, Reg::RSP, frame_size, 0 };
+        frame_size += sizeof(long long);
+    }
+
+    // keep the stack 16 byte aligned
+    frame_size = (frame_size + 15) / 16 * 16;
+
+    return { saved_registers, frame_size };
+}
+
+void NativeCompiler::load(Reg target, const Location& source) {
+    switch (source.kind) {
+        case Location::Kind::REGISTER:
+            if (source.reg != target) {
+                assembler.mov(target, source.reg);
+            }
+            break;
+        case Location::Kind::STACK:
+            assembler.mov(target, Memory{ Reg::RSP, source.offset });
+            break;
+        case Location::Kind::IMMEDIATE:
+            assembler.mov(target, source.value);
+            break;
+    }
+}
+
+void NativeCompiler::store(const Location& target, Reg source) {
+    assert(target.kind != Location::Kind::IMMEDIATE && "Can't store to an immediate!");
+
+    if (target.kind == Location::Kind::REGISTER) {
+        if (target.reg != source) {
+            assembler.mov(target.reg, source);
+        }
+    } else {
+        assembler.mov(Memory{ Reg::RSP, target.offset }, source);
+    }
+}
+
+void NativeCompiler::arithmetic(bytecode::OpCode opCode, Reg target, const Location& source) {
+    if (source.kind == Location::Kind::IMMEDIATE && !fitsImmediate32(source.value)) {
+        assembler.mov(Reg::RCX, source.value);
+        arithmetic(opCode, target, Location{ Location::Kind::REGISTER, Reg::RCX, 0, 0 });
+        return;
+    }
+
+    switch (source.kind) {
+        case Location::Kind::REGISTER:
+            if (opCode == OpCode::ADD) {
+                assembler.add(target, source.reg);
+            } else if (opCode == OpCode::SUBTRACT) {
+                assembler.sub(target, source.reg);
+            } else {
+                assembler.imul(target, source.reg);
+            }
+            break;
+        case Location::Kind::STACK: {
+            Memory memory{ Reg::RSP, source.offset };
+            if (opCode == OpCode::ADD) {
+                assembler.add(target, memory);
+            } else if (opCode == OpCode::SUBTRACT) {
+                assembler.sub(target, memory);
+            } else {
+                assembler.imul(target, memory);
+            }
+            break;
+        }
+        case Location::Kind::IMMEDIATE: {
+            auto immediate = static_cast<std::int32_t>(source.value);
+            if (opCode == OpCode::ADD) {
+                assembler.add(target, immediate);
+            } else if (opCode == OpCode::SUBTRACT) {
+                assembler.sub(target, immediate);
+            } else {
+                assembler.imul(target, immediate);
+            }
+            break;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_NATIVECOMPILER_HPP
+#define PLJIT_NATIVECOMPILER_HPP
+
+#include "./NativeFunction.hpp"
+#include "./X86Assembler.hpp"
+#include "../bytecode/Bytecode.hpp"
+#include <optional>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+/**
+ * Translates a `BytecodeFunction` into x86-64 machine code.
+ *
+ * Registers of the bytecode which are never written (literals and CONST values) become immediates.
+ * The remaining registers are mapped to machine registers, ordered by their number of uses, and spill
+ * into the stack frame once the machine registers are exhausted. RAX, RCX and RDX are scratch registers.
+ * All divisions share a single error exit, each guarded by a single branch.
+ */
+class NativeCompiler {
+    struct Location {
+        enum class Kind {
+            REGISTER,
+            STACK,
+            IMMEDIATE,
+        };
+
+        Kind kind;
+        Reg reg;
+        std::int32_t offset;
+        long long value;
+    };
+
+    X86Assembler assembler;
+    std::vector<Location> locations;
+
+    public:
+    NativeCompiler();
+
+    /**
+     * Compiles the given bytecode.
+     * @return Returns the `NativeFunction` or an empty optional if native code generation isn't supported
+     * on this platform or the executable memory couldn't be allocated.
+     */
+    std::optional<NativeFunction> compile(const bytecode::BytecodeFunction& function);
+
+    private:
+    /// Assigns a `Location` to every bytecode register. Returns the used callee saved registers and the stack frame size.
+    std::pair<std::vector<Reg>, std::int32_t> allocate(const bytecode::BytecodeFunction& function);
+
+    void load(Reg target, const Location& source);
+    void store(const Location& target, Reg source);
+    void arithmetic(bytecode::OpCode opCode, Reg target, const Location& source);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_NATIVECOMPILER_HPP
@@ -0,0 +1,64 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./NativeFunction.hpp"
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+NativeFunction::NativeFunction(
+    ExecutableMemory memory,
+    std::size_t parameter_count,
+    bool has_param_declaration,
+    std::vector<code::SourceCodeReference> division_references)
+    : memory(std::move(memory)),
+      entry(reinterpret_cast<EntryPoint>(const_cast<void*>(this->memory.data()))), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+      parameter_count(parameter_count), has_param_declaration(has_param_declaration),
+      division_references(std::move(division_references)) {}
+
+EvaluationContext NativeFunction::evaluate(std::span<const long long> arguments) const {
+    EvaluationContext context;
+    evaluate(arguments, context);
+    return context;
+}
+
+EvaluationContext NativeFunction::evaluate(std::initializer_list<long long> arguments) const {
+    return evaluate(std::span<const long long>{ arguments.begin(), arguments.size() });
+}
+
+void NativeFunction::evaluate(std::span<const long long> arguments, EvaluationContext& context) const {
+    // the machine code keeps all variables in registers or on the stack
+    context.reset(0);
+
+    if (!has_param_declaration) {
+        if (!arguments.empty()) {
+            context.setRuntimeError(RuntimeErrorCode::UNEXPECTED_ARGUMENTS);
+            return;
+        }
+    } else if (arguments.size() > parameter_count) {
+        context.setRuntimeError(RuntimeErrorCode::TOO_MANY_ARGUMENTS);
+        return;
+    } else if (arguments.size() < parameter_count) {
+        context.setRuntimeError(RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+        return;
+    }
+
+    long long result = 0;
+    if (int status = entry(arguments.data(), &result); status != 0) {
+        auto index = static_cast<std::size_t>(status - 1);
+        context.setRuntimeError(
+            RuntimeErrorCode::DIVISION_BY_ZERO,
+            index < division_references.size() ? division_references[index] : code::SourceCodeReference{});
+        return;
+    }
+
+    context.return_value() = result;
+}
+
+NativeFunction::EntryPoint NativeFunction::entryPoint() const {
+    return entry;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
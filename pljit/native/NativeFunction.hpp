@@ -0,0 +1,65 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_NATIVEFUNCTION_HPP
+#define PLJIT_NATIVEFUNCTION_HPP
+
+#include "./ExecutableMemory.hpp"
+#include "../EvaluationContext.hpp"
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+/**
+ * A function compiled to native machine code.
+ */
+class NativeFunction {
+    public:
+    /**
+     * The signature of the generated code.
+     * The code reads its arguments from `arguments` and stores the return value to `result`.
+     * It returns `0` on success and `n + 1` if the n-th division of the function divided by zero.
+     */
+    using EntryPoint = int (*)(const long long* arguments, long long* result);
+
+    private:
+    ExecutableMemory memory;
+    EntryPoint entry;
+
+    std::size_t parameter_count;
+    /// Whether the function has a PARAM declaration at all.
+    bool has_param_declaration;
+    /// The source code of every division, in the order of the generated code.
+    std::vector<code::SourceCodeReference> division_references;
+
+    public:
+    NativeFunction(
+        ExecutableMemory memory,
+        std::size_t parameter_count,
+        bool has_param_declaration,
+        std::vector<code::SourceCodeReference> division_references = {}
+    );
+
+    /**
+     * Executes the machine code.
+     * @param arguments The arguments passed to the function.
+     * @return Returns the `EvaluationContext` holding either the return value or a runtime error.
+     */
+    EvaluationContext evaluate(std::span<const long long> arguments) const;
+    EvaluationContext evaluate(std::initializer_list<long long> arguments) const;
+    /**
+     * Executes the machine code, storing the result to a caller supplied context, which is reset beforehand.
+     */
+    void evaluate(std::span<const long long> arguments, EvaluationContext& context) const;
+
+    EntryPoint entryPoint() const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_NATIVEFUNCTION_HPP
@@ -0,0 +1,212 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./X86Assembler.hpp"
+#include <cassert>
+#include <limits>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+constexpr std::size_t UNBOUND = std::numeric_limits<std::size_t>::max();
+
+std::uint8_t encoding(Reg reg) {
+    return static_cast<std::uint8_t>(reg);
+}
+
+std::uint8_t lowBits(Reg reg) {
+    return encoding(reg) & 0b111;
+}
+
+std::uint8_t modRM(std::uint8_t mod, std::uint8_t reg, std::uint8_t rm) {
+    return static_cast<std::uint8_t>((mod << 6) | ((reg & 0b111) << 3) | (rm & 0b111));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+X86Assembler::X86Assembler() = default;
+
+X86Assembler::Label X86Assembler::createLabel() {
+    labels.push_back(UNBOUND);
+    return labels.size() - 1;
+}
+
+void X86Assembler::bind(Label label) {
+    assert(label < labels.size() && labels[label] == UNBOUND && "Tried to bind unknown or already bound label!");
+    labels[label] = code.size();
+}
+
+void X86Assembler::mov(Reg target, Reg source) {
+    emitRegister({ 0x8B }, target, source);
+}
+
+void X86Assembler::mov(Reg target, Memory source) {
+    emitMemory({ 0x8B }, target, source);
+}
+
+void X86Assembler::mov(Memory target, Reg source) {
+    emitMemory({ 0x89 }, source, target);
+}
+
+void X86Assembler::mov(Reg target, long long immediate) {
+    if (immediate == 0) {
+        // xor target, target
+        emitRegister({ 0x31 }, target, target);
+    } else if (immediate >= std::numeric_limits<std::int32_t>::min() && immediate <= std::numeric_limits<std::int32_t>::max()) {
+        // sign extended 32-bit immediate
+        emitRegister({ 0xC7 }, 0, target);
+        emitImmediate32(static_cast<std::int32_t>(immediate));
+    } else {
+        // movabs target, imm64
+        code.push_back(static_cast<std::uint8_t>(0x48 | ((encoding(target) >> 3) & 1)));
+        code.push_back(static_cast<std::uint8_t>(0xB8 + lowBits(target)));
+        auto value = static_cast<unsigned long long>(immediate);
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            code.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+        }
+    }
+}
+
+void X86Assembler::add(Reg target, Reg source) {
+    emitRegister({ 0x03 }, target, source);
+}
+
+void X86Assembler::add(Reg target, Memory source) {
+    emitMemory({ 0x03 }, target, source);
+}
+
+void X86Assembler::add(Reg target, std::int32_t immediate) {
+    emitRegister({ 0x81 }, 0, target);
+    emitImmediate32(immediate);
+}
+
+void X86Assembler::sub(Reg target, Reg source) {
+    emitRegister({ 0x2B }, target, source);
+}
+
+void X86Assembler::sub(Reg target, Memory source) {
+    emitMemory({ 0x2B }, target, source);
+}
+
+void X86Assembler::sub(Reg target, std::int32_t immediate) {
+    emitRegister({ 0x81 }, 5, target);
+    emitImmediate32(immediate);
+}
+
+void X86Assembler::imul(Reg target, Reg source) {
+    emitRegister({ 0x0F, 0xAF }, target, source);
+}
+
+void X86Assembler::imul(Reg target, Memory source) {
+    emitMemory({ 0x0F, 0xAF }, target, source);
+}
+
+void X86Assembler::imul(Reg target, std::int32_t immediate) {
+    emitRegister({ 0x69 }, target, target);
+    emitImmediate32(immediate);
+}
+
+void X86Assembler::neg(Reg target) {
+    emitRegister({ 0xF7 }, 3, target);
+}
+
+void X86Assembler::cqo() {
+    code.push_back(0x48);
+    code.push_back(0x99);
+}
+
+void X86Assembler::idiv(Reg divisor) {
+    emitRegister({ 0xF7 }, 7, divisor);
+}
+
+void X86Assembler::test(Reg lhs, Reg rhs) {
+    emitRegister({ 0x85 }, rhs, lhs);
+}
+
+void X86Assembler::jz(Label label) {
+    emitJump({ 0x0F, 0x84 }, label);
+}
+
+void X86Assembler::jmp(Label label) {
+    emitJump({ 0xE9 }, label);
+}
+
+void X86Assembler::push(Reg reg) {
+    if (encoding(reg) >= 8) {
+        code.push_back(0x41);
+    }
+    code.push_back(static_cast<std::uint8_t>(0x50 + lowBits(reg)));
+}
+
+void X86Assembler::pop(Reg reg) {
+    if (encoding(reg) >= 8) {
+        code.push_back(0x41);
+    }
+    code.push_back(static_cast<std::uint8_t>(0x58 + lowBits(reg)));
+}
+
+void X86Assembler::ret() {
+    code.push_back(0xC3);
+}
+
+std::vector<std::uint8_t> X86Assembler::finalize() {
+    for (auto& fixup: fixups) {
+        assert(labels[fixup.label] != UNBOUND && "Jump to unbound label!");
+
+        // displacement is relative to the end of the jump instruction, which ends with the displacement.
+        auto displacement = static_cast<std::int64_t>(labels[fixup.label]) - static_cast<std::int64_t>(fixup.position + 4);
+        auto value = static_cast<std::uint32_t>(static_cast<std::int32_t>(displacement));
+        for (unsigned byte = 0; byte < 4; ++byte) {
+            code[fixup.position + byte] = static_cast<std::uint8_t>(value >> (8 * byte));
+        }
+    }
+    fixups.clear();
+
+    return std::move(code);
+}
+
+void X86Assembler::emitRex(Reg reg, Reg rm) {
+    // REX.W, REX.R extends the ModRM reg field, REX.B extends the ModRM rm field (or SIB base).
+    code.push_back(static_cast<std::uint8_t>(0x48 | (((encoding(reg) >> 3) & 1) << 2) | ((encoding(rm) >> 3) & 1)));
+}
+
+void X86Assembler::emitRegister(std::initializer_list<std::uint8_t> opcode, Reg reg, Reg rm) {
+    emitRex(reg, rm);
+    code.insert(code.end(), opcode);
+    code.push_back(modRM(0b11, encoding(reg), encoding(rm)));
+}
+
+void X86Assembler::emitRegister(std::initializer_list<std::uint8_t> opcode, std::uint8_t extension, Reg rm) {
+    emitRegister(opcode, static_cast<Reg>(extension), rm);
+}
+
+void X86Assembler::emitMemory(std::initializer_list<std::uint8_t> opcode, Reg reg, Memory memory) {
+    emitRex(reg, memory.base);
+    code.insert(code.end(), opcode);
+    // we always use the 32-bit displacement form, which avoids the special cases of RBP and R13.
+    code.push_back(modRM(0b10, encoding(reg), encoding(memory.base)));
+    if (lowBits(memory.base) == 0b100) {
+        // RSP and R12 require a SIB byte (no index, base = rm).
+        code.push_back(0x24);
+    }
+    emitImmediate32(memory.displacement);
+}
+
+void X86Assembler::emitImmediate32(std::int32_t immediate) {
+    auto value = static_cast<std::uint32_t>(immediate);
+    for (unsigned byte = 0; byte < 4; ++byte) {
+        code.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+    }
+}
+
+void X86Assembler::emitJump(std::initializer_list<std::uint8_t> opcode, Label label) {
+    code.insert(code.end(), opcode);
+    fixups.push_back(Fixup{ code.size(), label });
+    emitImmediate32(0);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
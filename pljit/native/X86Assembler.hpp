@@ -0,0 +1,118 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_X86ASSEMBLER_HPP
+#define PLJIT_X86ASSEMBLER_HPP
+
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::native {
+//---------------------------------------------------------------------------
+/// The 64-bit general purpose registers, numbered by their hardware encoding.
+enum class Reg : std::uint8_t {
+    RAX = 0,
+    RCX = 1,
+    RDX = 2,
+    RBX = 3,
+    RSP = 4,
+    RBP = 5,
+    RSI = 6,
+    RDI = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11,
+    R12 = 12,
+    R13 = 13,
+    R14 = 14,
+    R15 = 15,
+};
+//---------------------------------------------------------------------------
+/// A memory operand of the form `[base + displacement]`.
+struct Memory {
+    Reg base;
+    std::int32_t displacement;
+};
+//---------------------------------------------------------------------------
+/**
+ * A minimal x86-64 assembler emitting the handful of 64-bit instructions required by the `NativeCompiler`.
+ * Jumps always use 32-bit relative displacements, which are resolved once the assembler is finalized.
+ */
+class X86Assembler {
+    public:
+    /// Identifies a jump target created by `createLabel()`.
+    using Label = std::size_t;
+
+    private:
+    struct Fixup {
+        /// Offset of the 32-bit displacement which needs to be patched.
+        std::size_t position;
+        Label label;
+    };
+
+    std::vector<std::uint8_t> code;
+    /// Offsets of bound labels. `UNBOUND` for labels which weren't bound yet.
+    std::vector<std::size_t> labels;
+    std::vector<Fixup> fixups;
+
+    public:
+    X86Assembler();
+
+    Label createLabel();
+    /// Binds the label to the current code position.
+    void bind(Label label);
+
+    void mov(Reg target, Reg source);
+    void mov(Reg target, Memory source);
+    void mov(Memory target, Reg source);
+    void mov(Reg target, long long immediate);
+
+    void add(Reg target, Reg source);
+    void add(Reg target, Memory source);
+    void add(Reg target, std::int32_t immediate);
+
+    void sub(Reg target, Reg source);
+    void sub(Reg target, Memory source);
+    void sub(Reg target, std::int32_t immediate);
+
+    void imul(Reg target, Reg source);
+    void imul(Reg target, Memory source);
+    void imul(Reg target, std::int32_t immediate);
+
+    void neg(Reg target);
+    /// Sign extends RAX into RDX:RAX.
+    void cqo();
+    /// Signed division of RDX:RAX by `divisor`. Quotient is stored in RAX.
+    void idiv(Reg divisor);
+    void test(Reg lhs, Reg rhs);
+
+    /// Jump if the zero flag is set.
+    void jz(Label label);
+    void jmp(Label label);
+
+    void push(Reg reg);
+    void pop(Reg reg);
+    void ret();
+
+    /**
+     * Resolves all jumps.
+     * @return Returns the encoded machine code.
+     */
+    std::vector<std::uint8_t> finalize();
+
+    private:
+    void emitRex(Reg reg, Reg rm);
+    void emitRegister(std::initializer_list<std::uint8_t> opcode, Reg reg, Reg rm);
+    void emitRegister(std::initializer_list<std::uint8_t> opcode, std::uint8_t extension, Reg rm);
+    void emitMemory(std::initializer_list<std::uint8_t> opcode, Reg reg, Memory memory);
+    void emitImmediate32(std::int32_t immediate);
+    void emitJump(std::initializer_list<std::uint8_t> opcode, Label label);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::native
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_X86ASSEMBLER_HPP
@@ -0,0 +1,269 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./CommonSubexpressionElimination.hpp"
+#include "../ast/AST.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::ast::optimize {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+using value_number = std::uint32_t;
+//---------------------------------------------------------------------------
+/// Identifies a value: LITERALs by their value, VARIABLEs by their symbol and the number of assignments to it
+/// so far, all other expressions by their type and the value numbers of their operands.
+struct ValueKey {
+    Node::Type type;
+    std::uint64_t first;
+    std::uint64_t second;
+
+    bool operator==(const ValueKey& other) const = default;
+};
+
+std::size_t hashOf(const ValueKey& key) {
+    std::size_t hash = static_cast<std::size_t>(key.type);
+    hash ^= key.first * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= key.second * 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash ^ (hash >> 29);
+}
+
+struct Value {
+    /// The number of nodes of the expressions computing the value.
+    std::size_t size = 1;
+    /// Whether computing the value involves a division.
+    bool may_fail = false;
+    /// The number of binary expressions computing the value.
+    std::size_t computations = 0;
+};
+//---------------------------------------------------------------------------
+/**
+ * Numbers the values of all expressions evaluated by a function, i.e. of the statements up to the first RETURN.
+ */
+class ValueNumbering {
+    struct Entry {
+        ValueKey key;
+        value_number number;
+    };
+    static constexpr value_number EMPTY = std::numeric_limits<value_number>::max();
+
+    const ExpressionArena& expressions;
+    /// Open addressing table of the values numbered so far, sized for every expression of the arena.
+    std::vector<Entry> numbers;
+    /// The number of assignments to every symbol so far, indexed by `symbol_id - 1`.
+    std::vector<std::uint64_t> versions;
+    std::size_t statement;
+    /// The number of divisions evaluated in the current statement so far.
+    std::size_t divisions;
+
+    public:
+    std::vector<Value> values;
+    /// The number of statements evaluated by the function.
+    std::size_t statement_count;
+    /// The binary expressions, in evaluation order.
+    std::vector<node_index> binaries;
+    /// For binary expressions: their value number.
+    std::vector<value_number> value_of;
+    /// For binary expressions: the index of their statement.
+    std::vector<std::size_t> statement_of;
+    /// For binary expressions: whether a division is evaluated before them in their statement.
+    std::vector<bool> preceded_by_division;
+
+    explicit ValueNumbering(const Function& function)
+        : expressions(function.getExpressions()), numbers(std::bit_ceil(2 * expressions.size()), Entry{ {}, EMPTY }),
+          versions(function.symbol_count()), statement(0), divisions(0), statement_count(0), value_of(expressions.size()),
+          statement_of(expressions.size()), preceded_by_division(expressions.size()) {
+        for (auto& current: function.getStatements()) {
+            divisions = 0;
+            number(current.getExpression());
+            ++statement;
+
+            if (current.getType() == Node::Type::RETURN_STATEMENT) {
+                break;
+            }
+            // the assigned value is only visible to the following statements
+            ++versions[current.getVariable().getSymbolId() - 1];
+        }
+        statement_count = statement;
+    }
+
+    private:
+    value_number number(node_index index) {
+        const Expression& expression = expressions[index];
+
+        switch (expression.getType()) {
+            case Node::Type::LITERAL:
+                return intern({ Node::Type::LITERAL, static_cast<std::uint64_t>(expression.value()), 0 });
+            case Node::Type::VARIABLE: {
+                symbol_id symbol = expression.getSymbolId();
+                return intern({ Node::Type::VARIABLE, symbol, versions[symbol - 1] });
+            }
+            case Node::Type::UNARY_PLUS:
+            case Node::Type::UNARY_MINUS: {
+                value_number child = number(expression.getChild());
+                value_number unary = intern({ expression.getType(), child, 0 });
+                values[unary].size = 1 + values[child].size;
+                values[unary].may_fail = values[child].may_fail;
+                return unary;
+            }
+            default:
+                break;
+        }
+
+        bool preceded = divisions > 0;
+        value_number lhs = number(expression.getLeft());
+        value_number rhs = number(expression.getRight());
+        if ((expression.getType() == Node::Type::ADD || expression.getType() == Node::Type::MULTIPLY) && rhs < lhs) {
+            std::swap(lhs, rhs);
+        }
+
+        value_number binary = intern({ expression.getType(), lhs, rhs });
+        Value& value = values[binary];
+        value.size = 1 + values[lhs].size + values[rhs].size;
+        value.may_fail = expression.getType() == Node::Type::DIVIDE || values[lhs].may_fail || values[rhs].may_fail;
+        ++value.computations;
+
+        binaries.push_back(index);
+        value_of[index] = binary;
+        statement_of[index] = statement;
+        preceded_by_division[index] = preceded;
+        if (expression.getType() == Node::Type::DIVIDE) {
+            ++divisions;
+        }
+        return binary;
+    }
+
+    value_number intern(const ValueKey& key) {
+        std::size_t mask = numbers.size() - 1;
+        for (std::size_t index = hashOf(key) & mask;; index = (index + 1) & mask) {
+            Entry& entry = numbers[index];
+            if (entry.number == EMPTY) {
+                entry = { key, static_cast<value_number>(values.size()) };
+                values.emplace_back();
+                return entry.number;
+            }
+            if (entry.key == key) {
+                return entry.number;
+            }
+        }
+    }
+};
+//---------------------------------------------------------------------------
+/// Marks all descendants of the given expression as detached.
+void detachChildren(const ExpressionArena& expressions, node_index index, std::vector<bool>& detached) {
+    const Expression& expression = expressions[index];
+
+    if (expression.isUnaryExpression()) {
+        detached[expression.getChild()] = true;
+        detachChildren(expressions, expression.getChild(), detached);
+    } else if (expression.isBinaryExpression()) {
+        detached[expression.getLeft()] = true;
+        detached[expression.getRight()] = true;
+        detachChildren(expressions, expression.getLeft(), detached);
+        detachChildren(expressions, expression.getRight(), detached);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+bool CommonSubexpressionElimination::optimize(Function& function) {
+    ExpressionArena& expressions = function.getExpressions();
+    ValueNumbering numbering{ function };
+
+    const std::vector<Value>& values = numbering.values;
+
+    std::vector<value_number> shared;
+    for (value_number value = 0; value < values.size(); ++value) {
+        if (values[value].computations >= 2) {
+            shared.push_back(value);
+        }
+    }
+    if (shared.empty()) {
+        return false;
+    }
+    // expressions computing a smaller value might be detached by sharing a larger one
+    std::stable_sort(shared.begin(), shared.end(), [&](value_number lhs, value_number rhs) {
+        return values[lhs].size > values[rhs].size;
+    });
+
+    // the computations of every shared value in evaluation order, stored consecutively starting at `offsets[value]`
+    std::vector<std::size_t> offsets(values.size() + 1);
+    for (value_number value = 0; value < values.size(); ++value) {
+        offsets[value + 1] = offsets[value] + (values[value].computations >= 2 ? values[value].computations : 0);
+    }
+    std::vector<node_index> computations(offsets.back());
+    std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+    for (node_index expression: numbering.binaries) {
+        value_number value = numbering.value_of[expression];
+        if (values[value].computations >= 2) {
+            computations[next[value]++] = expression;
+        }
+    }
+
+    std::vector<bool> detached(expressions.size());
+    // the assignments of the temporaries, inserted before the statement with the same index
+    std::vector<std::vector<Statement>> temporaries(numbering.statement_count);
+    bool changed = false;
+
+    std::vector<node_index> live;
+    for (value_number value: shared) {
+        live.clear();
+        for (std::size_t index = offsets[value]; index < offsets[value + 1]; ++index) {
+            if (!detached[computations[index]]) {
+                live.push_back(computations[index]);
+            }
+        }
+
+        if (live.size() < 2) {
+            continue;
+        }
+        node_index first = live.front();
+        if (values[value].may_fail && numbering.preceded_by_division[first]) {
+            // evaluating it ahead of its statement might raise a different runtime error
+            continue;
+        }
+
+        // the temporary takes over the children of the first computation, the others are detached
+        Variable temporary = function.declareTemporary();
+        node_index computation = expressions.duplicate(first);
+        for (node_index expression: live) {
+            if (expression != first) {
+                detachChildren(expressions, expression, detached);
+            }
+            expressions.replaceWithVariable(expression, temporary);
+        }
+
+        // temporaries created later are smaller and might be used by the ones created before
+        std::vector<Statement>& before = temporaries[numbering.statement_of[first]];
+        before.insert(before.begin(), Statement{ computation, temporary });
+        changed = true;
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    std::vector<Statement>& statements = function.getStatements();
+    std::vector<Statement> rewritten;
+    for (std::size_t index = 0; index < statements.size(); ++index) {
+        if (index < temporaries.size()) {
+            rewritten.insert(rewritten.end(), temporaries[index].begin(), temporaries[index].end());
+        }
+        rewritten.push_back(statements[index]);
+    }
+    statements = std::move(rewritten);
+    return true;
+}
+
+std::string_view CommonSubexpressionElimination::name() const {
+    return "CommonSubexpressionElimination";
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ast::optimize
+//---------------------------------------------------------------------------
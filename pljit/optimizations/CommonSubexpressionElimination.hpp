@@ -0,0 +1,35 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_COMMONSUBEXPRESSIONELIMINATION_HPP
+#define PLJIT_COMMONSUBEXPRESSIONELIMINATION_HPP
+
+#include "./OptimizationPass.hpp"
+
+//---------------------------------------------------------------------------
+namespace pljit::ast::optimize {
+//---------------------------------------------------------------------------
+/**
+ * Evaluates binary expressions computing the same value only once. The statements of a function are straight-line
+ * code, so numbering the values of all expressions in statement order finds every redundant expression
+ * of the function: expressions receive the same value number if they have the same type and the same operand values,
+ * with the operands of commutative operations sorted. A variable is a new value after every assignment to it.
+ *
+ * Every value computed more than once is assigned to a new temporary variable, declared through
+ * `Function::declareTemporary`, right before the statement first computing it. All its expressions are replaced
+ * by the temporary. Larger values are shared first, so the expressions of their temporaries may share smaller ones.
+ *
+ * A value which might raise a runtime error is only shared if no division is evaluated before it in the statement
+ * first computing it, so the function still fails with the same error.
+ */
+class CommonSubexpressionElimination : public OptimizationPass {
+    public:
+    bool optimize(Function& function) override;
+    std::string_view name() const override;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ast::optimize
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_COMMONSUBEXPRESSIONELIMINATION_HPP
@@ -30,7 +30,7 @@ void ConstantPropagation::ConstTableLookup::Entry::updateToVariable() {
 }
 
 //---------------------------------------------------------------------------
-ConstantPropagation::ConstantPropagation() : constTableLookup(0) {}
+ConstantPropagation::ConstantPropagation() : constTableLookup(0), changed(false) {}
 ConstantPropagation::ConstTableLookup::ConstTableLookup(std::size_t symbol_count) : constant_table_lookup(symbol_count) {}
 
 ConstantPropagation::ConstTableLookup::Entry& ConstantPropagation::ConstTableLookup::operator[](symbol_id symbolId) {
@@ -39,8 +39,9 @@ ConstantPropagation::ConstTableLookup::Entry& ConstantPropagation::ConstTableLoo
 }
 
 //---------------------------------------------------------------------------
-void ConstantPropagation::optimize(Function& function) {
+bool ConstantPropagation::optimize(Function& function) {
     constTableLookup = ConstTableLookup{ function.symbol_count() };
+    changed = false;
 
     if (function.getConstDeclaration()) {
         for (auto& [variable, literal]: function.getConstDeclaration()->getConstDeclarations()) {
@@ -48,76 +49,136 @@ void ConstantPropagation::optimize(Function& function) {
         }
     }
 
+    const std::vector<std::optional<long long>>& assumptions = function.getAssumedParameters();
+    for (std::size_t index = 0; index < assumptions.size(); ++index) {
+        if (assumptions[index]) {
+            symbol_id symbol = function.getParamDeclaration()->getDeclaredIdentifiers()[index].getSymbolId();
+            constTableLookup[symbol].updateToConstant(*assumptions[index]);
+        }
+    }
+
     for (auto& statement: function.getStatements()) {
-        optimize(statement);
+        optimize(statement, function.getExpressions());
     }
+
+    return changed;
 }
 
-void ConstantPropagation::optimize(std::unique_ptr<Statement>& statement) {
-    optimize(statement->getExpressionPtr());
+std::string_view ConstantPropagation::name() const {
+    return "ConstantPropagation";
+}
+
+void ConstantPropagation::optimize(const Statement& statement, ExpressionArena& expressions) {
+    optimize(statement.getExpression(), expressions);
 
-    if (statement->getType() == Node::Type::ASSIGNMENT_STATEMENT) {
-        auto& assignment = static_cast<AssignmentStatement&>(*statement);
+    if (statement.getType() == Node::Type::ASSIGNMENT_STATEMENT) {
+        const Expression& expression = expressions[statement.getExpression()];
 
-        if (statement->getExpression().getType() == Node::Type::LITERAL) {
-            long long value = static_cast<const Literal&>(statement->getExpression()).value();
-            constTableLookup[assignment.getVariable().getSymbolId()].updateToConstant(value);
+        if (expression.getType() == Node::Type::LITERAL) {
+            constTableLookup[statement.getVariable().getSymbolId()].updateToConstant(expression.value());
         } else {
-            constTableLookup[assignment.getVariable().getSymbolId()].updateToVariable();
+            constTableLookup[statement.getVariable().getSymbolId()].updateToVariable();
         }
     }
 }
 
-void ConstantPropagation::optimize(std::unique_ptr<Expression>& expression) {
+void ConstantPropagation::optimize(node_index index, ExpressionArena& expressions) {
     // type might be one of the following:
     // LITERAL, VARIABLE, UNARY_PLUS, UNARY_MINUS, ADD, SUBTRACT, MULTIPLY, DIVIDE,
-    auto type = expression->getType();
+    // The reference is re-read after every recursion, as nodes are replaced in place.
+    auto type = expressions[index].getType();
 
     if (type == Node::Type::VARIABLE) {
-        auto& variable = static_cast<Variable&>(*expression);
-        auto& entry = constTableLookup[variable.getSymbolId()];
+        auto& entry = constTableLookup[expressions[index].getSymbolId()];
 
         if (entry.isConstant()) {
-            expression = std::make_unique<Literal>(entry.getCurrentVal());
+            expressions.replaceWithLiteral(index, entry.getCurrentVal());
+            changed = true;
         }
     } else if (type == Node::Type::UNARY_PLUS || type == Node::Type::UNARY_MINUS) {
-        auto& unaryExpression = static_cast<UnaryExpression&>(*expression);
+        node_index child = expressions[index].getChild();
 
-        optimize(unaryExpression.getChildPtr());
+        optimize(child, expressions);
 
-        if (unaryExpression.getChild().getType() == Node::Type::LITERAL) {
-            long long value = static_cast<const Literal&>(unaryExpression.getChild()).value();
+        if (expressions[child].getType() == Node::Type::LITERAL) {
+            long long value = expressions[child].value();
 
             if (type == Node::Type::UNARY_PLUS) {
-                expression = std::make_unique<Literal>(value);
+                expressions.replaceWithLiteral(index, value);
             } else {
-                expression = std::make_unique<Literal>(-value);
+                expressions.replaceWithLiteral(index, -value);
             }
+            changed = true;
         }
     } else if (type == Node::Type::ADD || type == Node::Type::SUBTRACT
                || type == Node::Type::MULTIPLY || type == Node::Type::DIVIDE) {
-        auto& binaryExpression = static_cast<BinaryExpression&>(*expression);
+        node_index left = expressions[index].getLeft();
+        node_index right = expressions[index].getRight();
 
-        optimize(binaryExpression.getLeftPtr());
-        optimize(binaryExpression.getRightPtr());
+        optimize(left, expressions);
+        optimize(right, expressions);
 
-        if (binaryExpression.getLeft().getType() == Node::Type::LITERAL
-            && binaryExpression.getRight().getType() == Node::Type::LITERAL) {
-            long long lhs_value = static_cast<const Literal&>(binaryExpression.getLeft()).value();
-            long long rhs_value = static_cast<const Literal&>(binaryExpression.getRight()).value();
+        if (expressions[left].getType() == Node::Type::LITERAL
+            && expressions[right].getType() == Node::Type::LITERAL) {
+            long long lhs_value = expressions[left].value();
+            long long rhs_value = expressions[right].value();
 
             if (type == Node::Type::ADD) {
-                expression = std::make_unique<Literal>(lhs_value + rhs_value);
+                expressions.replaceWithLiteral(index, lhs_value + rhs_value);
+                changed = true;
             } else if (type == Node::Type::SUBTRACT) {
-                expression = std::make_unique<Literal>(lhs_value - rhs_value);
+                expressions.replaceWithLiteral(index, lhs_value - rhs_value);
+                changed = true;
             } else if (type == Node::Type::MULTIPLY) {
-                expression = std::make_unique<Literal>(lhs_value * rhs_value);
+                expressions.replaceWithLiteral(index, lhs_value * rhs_value);
+                changed = true;
             } else if (rhs_value != 0) { // only optimized divide if we don't generate an error
-                expression = std::make_unique<Literal>(lhs_value / rhs_value);
+                expressions.replaceWithLiteral(index, lhs_value / rhs_value);
+                changed = true;
             }
+        } else if (expressions[left].getType() == Node::Type::LITERAL || expressions[right].getType() == Node::Type::LITERAL) {
+            // e.g. parameters bound to 0 or 1 leave identities behind
+            changed |= simplifyIdentity(index, expressions);
         }
     }
 }
+
+bool ConstantPropagation::simplifyIdentity(node_index index, ExpressionArena& expressions) {
+    auto type = expressions[index].getType();
+    node_index left = expressions[index].getLeft();
+    node_index right = expressions[index].getRight();
+    bool left_literal = expressions[left].getType() == Node::Type::LITERAL;
+    long long literal = left_literal ? expressions[left].value() : expressions[right].value();
+    node_index operand = left_literal ? right : left;
+
+    if (literal == 0 && (type == Node::Type::ADD || (type == Node::Type::SUBTRACT && !left_literal))) {
+        // x + 0, 0 + x, x - 0
+        expressions.replaceWithDescendant(index, operand);
+        return true;
+    } else if (literal == 1 && (type == Node::Type::MULTIPLY || (type == Node::Type::DIVIDE && !left_literal))) {
+        // x * 1, 1 * x, x / 1
+        expressions.replaceWithDescendant(index, operand);
+        return true;
+    } else if (literal == 0 && type == Node::Type::MULTIPLY && !mayFail(operand, expressions)) {
+        // x * 0, 0 * x, unless evaluating x raises a division by zero
+        expressions.replaceWithLiteral(index, 0);
+        return true;
+    }
+    return false;
+}
+
+bool ConstantPropagation::mayFail(node_index index, const ExpressionArena& expressions) {
+    const Expression& expression = expressions[index];
+
+    if (expression.getType() == Node::Type::DIVIDE) {
+        return true;
+    } else if (expression.isUnaryExpression()) {
+        return mayFail(expression.getChild(), expressions);
+    } else if (expression.isBinaryExpression()) {
+        return mayFail(expression.getLeft(), expressions) || mayFail(expression.getRight(), expressions);
+    }
+    return false;
+}
 //---------------------------------------------------------------------------
 } // namespace pljit::ast::optimize
 //---------------------------------------------------------------------------
@@ -7,17 +7,24 @@
 
 #include "./OptimizationPass.hpp"
 #include "../symbol_id.hpp"
+#include <cstdint>
 #include <vector>
-#include <memory>
 
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
 class Statement;
-class Expression;
+class ExpressionArena;
+using node_index = std::uint32_t;
 //---------------------------------------------------------------------------
 namespace optimize {
 //---------------------------------------------------------------------------
+/**
+ * Replaces variables holding a known value with LITERALs and folds expressions of LITERALs.
+ * Constants, parameters bound through `Function::bindParameters` or assumed through `Function::assumeParameters`
+ * and variables assigned a LITERAL are known.
+ * Binary expressions with a single LITERAL operand are simplified if they are an identity, like `x + 0` or `x * 1`.
+ */
 class ConstantPropagation : public OptimizationPass {
     class ConstTableLookup {
         public:
@@ -45,15 +52,22 @@ class ConstantPropagation : public OptimizationPass {
     };
 
     ConstTableLookup constTableLookup;
+    /// Set once the current run replaced any expression.
+    bool changed;
 
     public:
     ConstantPropagation();
 
-    void optimize(Function& function) override;
+    bool optimize(Function& function) override;
+    std::string_view name() const override;
 
     private:
-    void optimize(std::unique_ptr<Statement>& statement);
-    void optimize(std::unique_ptr<Expression>& expression);
+    void optimize(const Statement& statement, ExpressionArena& expressions);
+    void optimize(node_index expression, ExpressionArena& expressions);
+    /// Simplifies a binary expression with a single LITERAL operand, if it is an identity like `x * 1`.
+    static bool simplifyIdentity(node_index expression, ExpressionArena& expressions);
+    /// Whether evaluating the expression might raise a runtime error.
+    static bool mayFail(node_index expression, const ExpressionArena& expressions);
 };
 //---------------------------------------------------------------------------
 } // namespace optimize
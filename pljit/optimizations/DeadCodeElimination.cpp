@@ -8,21 +8,28 @@
 //---------------------------------------------------------------------------
 namespace pljit::ast::optimize {
 //---------------------------------------------------------------------------
-void DeadCodeElimination::optimize(Function& function) {
-    std::vector<std::unique_ptr<Statement>>& statements = function.getStatements();
+bool DeadCodeElimination::optimize(Function& function) {
+    std::vector<Statement>& statements = function.getStatements();
 
     auto iterator = statements.begin();
     for (; iterator != statements.end(); ++iterator) {
-        if ((*iterator)->getType() == Node::Type::RETURN_STATEMENT) {
+        if (iterator->getType() == Node::Type::RETURN_STATEMENT) {
             ++iterator;
             break;
         }
     }
 
-    if (iterator != statements.end()) {
-        // remove dead code!
-        statements.erase(iterator, statements.end());
+    if (iterator == statements.end()) {
+        return false;
     }
+
+    // remove dead code! Their expressions stay detached in the arena of the function.
+    statements.erase(iterator, statements.end());
+    return true;
+}
+
+std::string_view DeadCodeElimination::name() const {
+    return "DeadCodeElimination";
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::ast::optimize
@@ -12,7 +12,8 @@ namespace pljit::ast::optimize {
 //---------------------------------------------------------------------------
 class DeadCodeElimination: public OptimizationPass {
     public:
-    void optimize(Function& function) override;
+    bool optimize(Function& function) override;
+    std::string_view name() const override;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::ast::optimize
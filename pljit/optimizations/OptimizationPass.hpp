@@ -5,6 +5,8 @@
 #ifndef PLJIT_OPTIMIZATIONPASS_HPP
 #define PLJIT_OPTIMIZATIONPASS_HPP
 
+#include <string_view>
+
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
@@ -17,7 +19,17 @@ class OptimizationPass {
     OptimizationPass() = default;
     virtual ~OptimizationPass() = default;
 
-    virtual void optimize(Function& function) = 0;
+    /**
+     * Runs the optimization on the given function.
+     * @param function The `Function` to optimize.
+     * @return Returns `true` if the function was modified.
+     */
+    virtual bool optimize(Function& function) = 0;
+
+    /**
+     * @return Returns the name of the optimization, used for reporting.
+     */
+    virtual std::string_view name() const = 0;
 };
 //---------------------------------------------------------------------------
 } // namespace optimize
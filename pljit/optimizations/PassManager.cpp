@@ -0,0 +1,137 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./PassManager.hpp"
+#include "./CommonSubexpressionElimination.hpp"
+#include "./ConstantPropagation.hpp"
+#include "./DeadCodeElimination.hpp"
+#include "../ast/AST.hpp"
+
+//---------------------------------------------------------------------------
+namespace pljit::ast::optimize {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+std::size_t countNodes(const ExpressionArena& expressions, node_index index) {
+    const Expression& expression = expressions[index];
+
+    if (expression.isUnaryExpression()) {
+        return 1 + countNodes(expressions, expression.getChild());
+    } else if (expression.isBinaryExpression()) {
+        return 1 + countNodes(expressions, expression.getLeft()) + countNodes(expressions, expression.getRight());
+    }
+
+    // LITERAL or VARIABLE
+    return 1;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+PassManager::PassManager() : iterate_to_fixpoint(false), max_iterations(1), iterations(0) {}
+
+PassManager PassManager::forLevel(OptimizationLevel level) {
+    PassManager manager;
+
+    switch (level) {
+        case OptimizationLevel::O0:
+            break;
+        case OptimizationLevel::O1:
+            manager.addPass(std::make_unique<ConstantPropagation>());
+            manager.addPass(std::make_unique<DeadCodeElimination>());
+            break;
+        case OptimizationLevel::O2:
+            manager.setIterateToFixpoint(true);
+            manager.addPass(std::make_unique<ConstantPropagation>());
+            manager.addPass(std::make_unique<DeadCodeElimination>());
+            manager.addPass(std::make_unique<CommonSubexpressionElimination>());
+            break;
+    }
+
+    return manager;
+}
+
+void PassManager::addPass(std::unique_ptr<OptimizationPass> pass) {
+    statistics.push_back(PassStatistics{ .name = pass->name() });
+    passes.push_back(std::move(pass));
+}
+
+void PassManager::setIterateToFixpoint(bool enabled, unsigned iteration_limit) {
+    iterate_to_fixpoint = enabled;
+    max_iterations = enabled ? iteration_limit : 1;
+}
+
+bool PassManager::run(Function& function) {
+    bool modified = false;
+    iterations = 0;
+
+    std::size_t node_count = passes.empty() ? 0 : optimize::countNodes(function);
+
+    while (iterations < max_iterations) {
+        ++iterations;
+        bool changed = false;
+
+        for (std::size_t index = 0; index < passes.size(); ++index) {
+            PassStatistics& statistic = statistics[index];
+
+            auto start = std::chrono::steady_clock::now();
+            bool pass_changed = passes[index]->optimize(function);
+            statistic.duration += std::chrono::steady_clock::now() - start;
+            ++statistic.runs;
+
+            if (pass_changed) {
+                ++statistic.changes;
+                changed = true;
+
+                std::size_t new_node_count = optimize::countNodes(function);
+                if (new_node_count < node_count) {
+                    statistic.removed_nodes += node_count - new_node_count;
+                }
+                node_count = new_node_count;
+            }
+        }
+
+        modified |= changed;
+        if (!changed) {
+            break;
+        }
+    }
+
+    return modified;
+}
+
+const std::vector<PassStatistics>& PassManager::getStatistics() const {
+    return statistics;
+}
+
+unsigned PassManager::getIterations() const {
+    return iterations;
+}
+//---------------------------------------------------------------------------
+std::size_t countNodes(const Function& function) {
+    std::size_t count = 1;
+
+    if (function.getParamDeclaration()) {
+        count += 1 + function.getParamDeclaration()->getDeclaredIdentifiers().size();
+    }
+    if (function.getVarDeclaration()) {
+        count += 1 + function.getVarDeclaration()->getDeclaredIdentifiers().size();
+    }
+    if (function.getConstDeclaration()) {
+        // every constant consists of a Variable and a Literal node
+        count += 1 + 2 * function.getConstDeclaration()->getDeclaredIdentifiers().size();
+    }
+
+    // only counts expressions reachable from a statement, detached ones in the arena don't belong to the AST anymore
+    for (auto& statement: function.getStatements()) {
+        count += 1 + countNodes(function.getExpressions(), statement.getExpression());
+        if (statement.getType() == Node::Type::ASSIGNMENT_STATEMENT) {
+            ++count; // the assigned Variable
+        }
+    }
+
+    return count;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ast::optimize
+//---------------------------------------------------------------------------
@@ -0,0 +1,92 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_PASSMANAGER_HPP
+#define PLJIT_PASSMANAGER_HPP
+
+#include "./OptimizationPass.hpp"
+#include "../CompileOptions.hpp"
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit::ast::optimize {
+//---------------------------------------------------------------------------
+/**
+ * Statistics recorded for a single pass of a `PassManager` pipeline, accumulated over all iterations.
+ */
+struct PassStatistics {
+    /// The name of the pass.
+    std::string_view name;
+    /// How often the pass was run.
+    unsigned runs = 0;
+    /// How often the pass modified the function.
+    unsigned changes = 0;
+    /// The total time spent in the pass.
+    std::chrono::nanoseconds duration{ 0 };
+    /// The total number of AST nodes removed by the pass.
+    std::size_t removed_nodes = 0;
+};
+//---------------------------------------------------------------------------
+/**
+ * Runs an ordered pipeline of `OptimizationPass`es on a `Function`.
+ */
+class PassManager {
+    std::vector<std::unique_ptr<OptimizationPass>> passes;
+
+    /// Whether the pipeline is repeated till no pass modifies the function anymore.
+    bool iterate_to_fixpoint;
+    /// Upper bound for the number of pipeline iterations when iterating to a fixpoint.
+    unsigned max_iterations;
+
+    std::vector<PassStatistics> statistics;
+    unsigned iterations;
+
+    public:
+    PassManager();
+
+    /**
+     * Creates the pipeline for the given `OptimizationLevel`.
+     */
+    static PassManager forLevel(OptimizationLevel level);
+
+    /**
+     * Appends a pass to the end of the pipeline.
+     */
+    void addPass(std::unique_ptr<OptimizationPass> pass);
+
+    /**
+     * Configures if the pipeline is repeated till no pass modifies the function anymore.
+     * @param enabled Enables or disables fixpoint iteration.
+     * @param iteration_limit The maximum number of pipeline iterations.
+     */
+    void setIterateToFixpoint(bool enabled, unsigned iteration_limit = 16);
+
+    /**
+     * Runs the pipeline on the given function.
+     * @return Returns `true` if any pass modified the function.
+     */
+    bool run(Function& function);
+
+    /**
+     * @return Returns the statistics of every pass, in pipeline order.
+     */
+    const std::vector<PassStatistics>& getStatistics() const;
+    /**
+     * @return Returns the number of pipeline iterations performed by the last `run`.
+     */
+    unsigned getIterations() const;
+};
+//---------------------------------------------------------------------------
+/**
+ * @return Returns the number of nodes of the given AST.
+ */
+std::size_t countNodes(const Function& function);
+//---------------------------------------------------------------------------
+} // namespace pljit::ast::optimize
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_PASSMANAGER_HPP
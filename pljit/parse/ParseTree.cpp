@@ -28,13 +28,18 @@ void GenericTerminal::accept(ParseTreeVisitor& visitor) const {
     visitor.visit(*this);
 }
 //---------------------------------------------------------------------------
-Identifier::Identifier() = default;
-Identifier::Identifier(code::SourceCodeReference src_reference) : Symbol(src_reference) {}
+Identifier::Identifier() : identifier(0) {}
+Identifier::Identifier(code::SourceCodeReference src_reference, lex::identifier_id identifier)
+    : Symbol(src_reference), identifier(identifier) {}
 
 std::string_view Identifier::value() const {
     return *src_reference;
 }
 
+lex::identifier_id Identifier::id() const {
+    return identifier;
+}
+
 void Identifier::accept(ParseTreeVisitor& visitor) const {
     visitor.visit(*this);
 }
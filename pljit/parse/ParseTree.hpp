@@ -6,6 +6,7 @@
 #define PLJIT_PARSETREE_HPP
 
 #include "../code/SourceCode.hpp"
+#include "../lex/IdentifierTable.hpp"
 #include <memory>
 #include <optional>
 #include <vector>
@@ -42,11 +43,15 @@ class GenericTerminal : public Symbol {
 };
 //---------------------------------------------------------------------------
 class Identifier : public Symbol {
+    lex::identifier_id identifier;
+
     public:
     Identifier();
-    explicit Identifier(code::SourceCodeReference src_reference);
+    Identifier(code::SourceCodeReference src_reference, lex::identifier_id identifier);
 
     std::string_view value() const;
+    /// The interned id of the identifier name, see {@class lex::IdentifierTable}.
+    lex::identifier_id id() const;
     void accept(ParseTreeVisitor& visitor) const override;
 };
 //---------------------------------------------------------------------------
@@ -16,18 +16,39 @@ Result<FunctionDefinition> Parser::parse_program() {
 }
 
 Result<FunctionDefinition> Parser::parseFunctionDefinition() {
-    Result<lex::Token> result;
-
     std::optional<ParameterDeclarations> parameterDeclarations;
     std::optional<VariableDeclarations> variableDeclarations;
     std::optional<ConstantDeclarations> constantDeclarations;
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    if (auto error = parseDeclarations(parameterDeclarations, variableDeclarations, constantDeclarations)) {
+        return *error;
+    }
+
+    Result<CompoundStatement> compoundStatement = parseCompoundStatement();
+    if (!compoundStatement) {
+        return compoundStatement.error();
+    }
+
+    Result<GenericTerminal> terminator = parseProgramTerminator();
+    if (!terminator) {
+        return terminator.error();
+    }
+
+    return FunctionDefinition{ parameterDeclarations, variableDeclarations, constantDeclarations, compoundStatement.release(), terminator.release() };
+}
+
+std::optional<code::SourceCodeError> Parser::parseDeclarations(
+    std::optional<ParameterDeclarations>& parameterDeclarations,
+    std::optional<VariableDeclarations>& variableDeclarations,
+    std::optional<ConstantDeclarations>& constantDeclarations) {
+    lex::Token token;
+
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
         Result<ParameterDeclarations> declarations = parseParameterDeclarations();
         if (!declarations) {
             return declarations.error();
@@ -35,81 +56,80 @@ Result<FunctionDefinition> Parser::parseFunctionDefinition() {
         parameterDeclarations = declarations.release();
     }
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::KEYWORD, Keyword::VAR)) {
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::VAR)) {
         Result<VariableDeclarations> declarations = parseVariableDeclarations();
         if (!declarations) {
             return declarations.error();
         }
         variableDeclarations = declarations.release();
-    } else if (result->is(lex::Token::Type::KEYWORD, Keyword::PARAM) && parameterDeclarations) {
-        return result->makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
+    } else if (token.is(lex::Token::Type::KEYWORD, Keyword::PARAM) && parameterDeclarations) {
+        return token.makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
             .attachCause(parameterDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
     }
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::KEYWORD, Keyword::CONST)) {
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::CONST)) {
         Result<ConstantDeclarations> declarations = parseConstantDeclarations();
         if (!declarations) {
             return declarations.error();
         }
         constantDeclarations = declarations.release();
-    } else if (result->is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
+    } else if (token.is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
         if (parameterDeclarations) {
-            return result->makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
+            return token.makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
                 .attachCause(parameterDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
         } else {
-            return result->makeError(code::ErrorType::ERROR, "PARAM declaration must appear before VAR declaration!");
+            return token.makeError(code::ErrorType::ERROR, "PARAM declaration must appear before VAR declaration!");
         }
-    } else if (result->is(lex::Token::Type::KEYWORD, Keyword::VAR) && variableDeclarations) {
-        return result->makeError(code::ErrorType::ERROR, "Duplicate VAR declaration!")
+    } else if (token.is(lex::Token::Type::KEYWORD, Keyword::VAR) && variableDeclarations) {
+        return token.makeError(code::ErrorType::ERROR, "Duplicate VAR declaration!")
             .attachCause(variableDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
     }
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::PARAM)) {
         if (parameterDeclarations) {
-            return result->makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
+            return token.makeError(code::ErrorType::ERROR, "Duplicate PARAM declaration!")
                 .attachCause(parameterDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
         } else {
-            return result->makeError(code::ErrorType::ERROR, "PARAM declaration must appear before CONST and VAR declarations!");
+            return token.makeError(code::ErrorType::ERROR, "PARAM declaration must appear before CONST and VAR declarations!");
         }
-    } else if (result->is(lex::Token::Type::KEYWORD, Keyword::VAR)) {
+    } else if (token.is(lex::Token::Type::KEYWORD, Keyword::VAR)) {
         if (variableDeclarations) {
-            return result->makeError(code::ErrorType::ERROR, "Duplicate VAR declaration!")
+            return token.makeError(code::ErrorType::ERROR, "Duplicate VAR declaration!")
                 .attachCause(variableDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
         } else {
-            return result->makeError(code::ErrorType::ERROR, "VAR declaration must appear before CONST declaration!");
+            return token.makeError(code::ErrorType::ERROR, "VAR declaration must appear before CONST declaration!");
         }
-    } else if (result->is(lex::Token::Type::KEYWORD, Keyword::CONST) && constantDeclarations) {
-        return result->makeError(code::ErrorType::ERROR, "Duplicate CONST declaration!")
+    } else if (token.is(lex::Token::Type::KEYWORD, Keyword::CONST) && constantDeclarations) {
+        return token.makeError(code::ErrorType::ERROR, "Duplicate CONST declaration!")
             .attachCause(constantDeclarations->reference().makeError(code::ErrorType::NOTE, "Original declaration here"));
     }
 
-    Result<CompoundStatement> compoundStatement = parseCompoundStatement();
-    if (!compoundStatement) {
-        return compoundStatement.error();
-    }
+    return {};
+}
 
-    result = lexer->consume_next();
-    if (!result) {
-        return result.error();
+Result<GenericTerminal> Parser::parseProgramTerminator() {
+    lex::Token token = lexer->next();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (!result->is(lex::Token::Type::SEPARATOR, Separator::END_OF_PROGRAM)) {
-        return result->makeError(code::ErrorType::ERROR, "Expected `.` terminator!");
+    if (!token.is(lex::Token::Type::SEPARATOR, Separator::END_OF_PROGRAM)) {
+        return token.makeError(code::ErrorType::ERROR, "Expected `.` terminator!");
     }
 
     if (!lexer->endOfStream()) {
@@ -118,7 +138,7 @@ Result<FunctionDefinition> Parser::parseFunctionDefinition() {
             .makeError(code::ErrorType::ERROR, "unexpected character after end of program terminator!");
     }
 
-    return FunctionDefinition{ parameterDeclarations, variableDeclarations, constantDeclarations, compoundStatement.release(), GenericTerminal{ result->reference() } };
+    return GenericTerminal{ token.reference() };
 }
 
 Result<ParameterDeclarations> Parser::parseParameterDeclarations() {
@@ -186,26 +206,26 @@ Result<DeclaratorList> Parser::parseDeclaratorList() {
 
     DeclaratorList declaratorList{ identifier.release() };
 
-    Result<lex::Token> result;
+    lex::Token token;
     while (true) {
-        result = lexer->peek_next();
-        if (!result) {
-            return result.error();
+        token = lexer->peek();
+        if (token.isEmpty()) {
+            return lexer->error();
         }
 
-        if (!result->is(lex::Token::Type::SEPARATOR, Separator::COMMA)) {
+        if (!token.is(lex::Token::Type::SEPARATOR, Separator::COMMA)) {
             break;
         }
 
         // mark token as consumed!
-        lexer->consume(*result);
+        lexer->advance();
 
         Result<Identifier> additionalIdentifier = parseIdentifier();
         if (!additionalIdentifier) {
             return additionalIdentifier.error();
         }
 
-        declaratorList.appendIdentifier(GenericTerminal{ result->reference() }, additionalIdentifier.release());
+        declaratorList.appendIdentifier(GenericTerminal{ token.reference() }, additionalIdentifier.release());
     }
 
     return declaratorList;
@@ -219,26 +239,26 @@ Result<InitDeclaratorList> Parser::parseInitDeclaratorList() {
 
     InitDeclaratorList declaratorList{ initDeclarator.release() };
 
-    Result<lex::Token> result;
+    lex::Token token;
     while (true) {
-        result = lexer->peek_next();
-        if (!result) {
-            return result.error();
+        token = lexer->peek();
+        if (token.isEmpty()) {
+            return lexer->error();
         }
 
-        if (!result->is(lex::Token::Type::SEPARATOR, Separator::COMMA)) {
+        if (!token.is(lex::Token::Type::SEPARATOR, Separator::COMMA)) {
             break;
         }
 
         // mark token as consumed!
-        lexer->consume(*result);
+        lexer->advance();
 
         Result<InitDeclarator> additionalDeclarator = parseInitDeclarator();
         if (!additionalDeclarator) {
             return additionalDeclarator.error();
         }
 
-        declaratorList.appendInitDeclarator(GenericTerminal{ result->reference() }, additionalDeclarator.release());
+        declaratorList.appendInitDeclarator(GenericTerminal{ token.reference() }, additionalDeclarator.release());
     }
 
     return declaratorList;
@@ -290,51 +310,51 @@ Result<StatementList> Parser::parseStatementList() {
 
     StatementList statementList{ statement.release() };
 
-    Result<lex::Token> result;
+    lex::Token token;
     while (true) {
-        result = lexer->peek_next();
-        if (!result) {
-            return result.error();
+        token = lexer->peek();
+        if (token.isEmpty()) {
+            return lexer->error();
         }
 
-        if (result->is(lex::Token::Type::KEYWORD, "END")) {
+        if (token.is(lex::Token::Type::KEYWORD, "END")) {
             // StatementList only ever occurs before END. To provide better error messages, we do this check here.
             break;
-        } else if (!result->is(lex::Token::Type::SEPARATOR, Separator::SEMICOLON)) {
-            return result->makeError(code::ErrorType::ERROR, "Expected `;` to terminate statement!");
+        } else if (!token.is(lex::Token::Type::SEPARATOR, Separator::SEMICOLON)) {
+            return token.makeError(code::ErrorType::ERROR, "Expected `;` to terminate statement!");
         }
 
-        lexer->consume(*result);
+        lexer->advance();
 
         Result<Statement> additionalStatement = parseStatement();
         if (!additionalStatement) {
             return additionalStatement.error();
         }
 
-        statementList.appendStatement(GenericTerminal{ result->reference() }, additionalStatement.release());
+        statementList.appendStatement(GenericTerminal{ token.reference() }, additionalStatement.release());
     }
 
     return statementList;
 }
 
 Result<Statement> Parser::parseStatement() {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::KEYWORD, Keyword::RETURN)) {
-        lexer->consume(*result);
+    if (token.is(lex::Token::Type::KEYWORD, Keyword::RETURN)) {
+        lexer->advance();
 
         Result<AdditiveExpression> expression = parseAdditiveExpression();
         if (!expression) {
             return expression.error();
         }
 
-        return Statement{ GenericTerminal(result->reference()), expression.release() };
-    } else if (result->getType() == lex::Token::Type::IDENTIFIER) {
+        return Statement{ GenericTerminal(token.reference()), expression.release() };
+    } else if (token.getType() == lex::Token::Type::IDENTIFIER) {
         Result<AssignmentExpression> expression = parseAssignmentExpression();
         if (!expression) {
             return expression.error();
@@ -342,7 +362,7 @@ Result<Statement> Parser::parseStatement() {
 
         return Statement{ expression.release() };
     } else {
-        return result->makeError(code::ErrorType::ERROR, "Expected begin of statement. Assignment or RETURN expression!");
+        return token.makeError(code::ErrorType::ERROR, "Expected begin of statement. Assignment or RETURN expression!");
     }
 }
 
@@ -376,20 +396,20 @@ Result<AdditiveExpression> Parser::parseAdditiveExpression() {
         return AdditiveExpression{ multiplicativeExpression.release() };
     }
 
-    Result<lex::Token> result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    lex::Token token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::OPERATOR, Operator::PLUS) || result->is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
-        lexer->consume(*result);
+    if (token.is(lex::Token::Type::OPERATOR, Operator::PLUS) || token.is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
+        lexer->advance();
 
         Result<AdditiveExpression> additiveExpression = parseAdditiveExpression();
         if (!additiveExpression) {
             return additiveExpression.error();
         }
 
-        return AdditiveExpression{ multiplicativeExpression.release(), GenericTerminal{ result->reference() }, additiveExpression.release()};
+        return AdditiveExpression{ multiplicativeExpression.release(), GenericTerminal{ token.reference() }, additiveExpression.release()};
     } else {
         return AdditiveExpression{ multiplicativeExpression.release() };
     }
@@ -406,39 +426,39 @@ Result<MultiplicativeExpression> Parser::parseMultiplicativeExpression() {
         return MultiplicativeExpression{ unaryExpression.release() };
     }
 
-    Result<lex::Token> result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    lex::Token token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->is(lex::Token::Type::OPERATOR, Operator::MULTIPLICATION) || result->is(lex::Token::Type::OPERATOR, Operator::DIVISION)) {
-        lexer->consume(*result);
+    if (token.is(lex::Token::Type::OPERATOR, Operator::MULTIPLICATION) || token.is(lex::Token::Type::OPERATOR, Operator::DIVISION)) {
+        lexer->advance();
 
         Result<MultiplicativeExpression> multiplicativeExpression = parseMultiplicativeExpression();
         if (!multiplicativeExpression) {
             return multiplicativeExpression.error();
         }
 
-        return MultiplicativeExpression{ unaryExpression.release(), GenericTerminal{result->reference()}, multiplicativeExpression.release() };
+        return MultiplicativeExpression{ unaryExpression.release(), GenericTerminal{token.reference()}, multiplicativeExpression.release() };
     } else {
         return MultiplicativeExpression{ unaryExpression.release() };
     }
 }
 Result<UnaryExpression> Parser::parseUnaryExpression() {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
     std::optional<GenericTerminal> unaryOperator;
 
-    if (result->is(lex::Token::Type::OPERATOR, Operator::PLUS) || result->is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
-        lexer->consume(*result);
-        unaryOperator = GenericTerminal{ result->reference() };
-    } else if (result->getType() == lex::Token::Type::OPERATOR) {
-        return result->makeError(code::ErrorType::ERROR, "Unexpected unary operator!");
+    if (token.is(lex::Token::Type::OPERATOR, Operator::PLUS) || token.is(lex::Token::Type::OPERATOR, Operator::MINUS)) {
+        lexer->advance();
+        unaryOperator = GenericTerminal{ token.reference() };
+    } else if (token.getType() == lex::Token::Type::OPERATOR) {
+        return token.makeError(code::ErrorType::ERROR, "Unexpected unary operator!");
     }
 
     Result<PrimaryExpression> expression = parsePrimaryExpression();
@@ -454,28 +474,28 @@ Result<UnaryExpression> Parser::parseUnaryExpression() {
 }
 
 Result<PrimaryExpression> Parser::parsePrimaryExpression() {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->peek_next();
-    if (!result) {
-        return result.error();
+    token = lexer->peek();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->getType() == lex::Token::Type::IDENTIFIER) {
+    if (token.getType() == lex::Token::Type::IDENTIFIER) {
         Result<Identifier> identifier = parseIdentifier();
         if (!identifier) {
             return identifier.error();
         }
 
         return PrimaryExpression{ identifier.release() };
-    } else if (result->getType() == lex::Token::Type::LITERAL) {
+    } else if (token.getType() == lex::Token::Type::LITERAL) {
         Result<Literal> literal = parseLiteral();
         if (!literal) {
             return literal.error();
         }
 
         return PrimaryExpression{ literal.release() };
-    } else if (result->is(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_OPEN)) {
+    } else if (token.is(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_OPEN)) {
         Result<GenericTerminal> open = parseGenericTerminal(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_OPEN, "Expected `(` parenthesis!");
         if (!open) {
             return open.error();
@@ -489,78 +509,78 @@ Result<PrimaryExpression> Parser::parsePrimaryExpression() {
 
         Result<GenericTerminal> close = parseGenericTerminal(lex::Token::Type::PARENTHESIS, Parenthesis::ROUND_CLOSE, "Expected matching `)` parenthesis!");
         if (!close) {
-            return close.error()
+            return code::SourceCodeError{ close.error() }
                     .attachCause(open->reference().makeError(code::ErrorType::NOTE, "opening bracket here"));
         }
 
         return PrimaryExpression{ open.release(), expression.release(), close.release() };
     } else {
-        return result->makeError(code::ErrorType::ERROR, "Expected a primary expression!");
+        return token.makeError(code::ErrorType::ERROR, "Expected a primary expression!");
     }
 }
 
 Result<Identifier> Parser::parseIdentifier() {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->consume_next();
-    if (!result) {
-        return result.error();
+    token = lexer->next();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->getType() != lex::Token::Type::IDENTIFIER) {
-        return result->makeError(code::ErrorType::ERROR, "Expected an identifier!");
+    if (token.getType() != lex::Token::Type::IDENTIFIER) {
+        return token.makeError(code::ErrorType::ERROR, "Expected an identifier!");
     }
 
-    return Identifier{ result->reference() };
+    return Identifier{ token.reference(), token.getIdentifier() };
 }
 
 Result<Literal> Parser::parseLiteral() {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->consume_next();
-    if (!result) {
-        return result.error();
+    token = lexer->next();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (result->getType() != lex::Token::Type::LITERAL) {
-        return result->makeError(code::ErrorType::ERROR, "Expected literal!");
+    if (token.getType() != lex::Token::Type::LITERAL) {
+        return token.makeError(code::ErrorType::ERROR, "Expected literal!");
     }
 
-    std::string_view literal = *result->reference();
+    std::string_view literal = *token.reference();
     long long value;
 
     auto conversion = std::from_chars(literal.data(), literal.data() + literal.size(), value);
 
     if (conversion.ec != std::errc{}) {
         if (conversion.ec == std::errc::result_out_of_range) {
-            return result->makeError(code::ErrorType::ERROR, "Integer literal is out of range. Expected singed 64-bit!");
+            return token.makeError(code::ErrorType::ERROR, "Integer literal is out of range. Expected singed 64-bit!");
         }
-        return result->makeError(code::ErrorType::ERROR, "Encountered unexpected error parsing integer literal!");
+        return token.makeError(code::ErrorType::ERROR, "Encountered unexpected error parsing integer literal!");
     }
 
     if (conversion.ptr != literal.data() + literal.size()) {
-        return result->makeError(code::ErrorType::ERROR, "Integer literal wasn't fully parsed!");
+        return token.makeError(code::ErrorType::ERROR, "Integer literal wasn't fully parsed!");
     }
 
-    return Literal{ result->reference(), value };
+    return Literal{ token.reference(), value };
 }
 
 Result<GenericTerminal> Parser::parseGenericTerminal(
     lex::Token::Type expected_type,
     std::string_view expected_content, // NOLINT(bugprone-easily-swappable-parameters)
     std::string_view potential_error_message) {
-    Result<lex::Token> result;
+    lex::Token token;
 
-    result = lexer->consume_next();
-    if (!result) {
-        return result.error();
+    token = lexer->next();
+    if (token.isEmpty()) {
+        return lexer->error();
     }
 
-    if (!result->is(expected_type, expected_content)) {
-        return result->makeError(code::ErrorType::ERROR, potential_error_message);
+    if (!token.is(expected_type, expected_content)) {
+        return token.makeError(code::ErrorType::ERROR, potential_error_message);
     }
 
-    return GenericTerminal{ result->reference() };
+    return GenericTerminal{ token.reference() };
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::parse
@@ -24,6 +24,20 @@ class Parser {
 
     Result<FunctionDefinition> parseFunctionDefinition();
 
+    /**
+     * Parses the optional PARAM, VAR and CONST declarations at the start of a function.
+     * @return Returns the error if the declarations are missing, duplicated or not in order.
+     */
+    std::optional<code::SourceCodeError> parseDeclarations(
+        std::optional<ParameterDeclarations>& parameterDeclarations,
+        std::optional<VariableDeclarations>& variableDeclarations,
+        std::optional<ConstantDeclarations>& constantDeclarations
+    );
+    /**
+     * Parses the `.` terminator, which must be the last token of the program.
+     */
+    Result<GenericTerminal> parseProgramTerminator();
+
     Result<ParameterDeclarations> parseParameterDeclarations();
     Result<VariableDeclarations> parseVariableDeclarations();
     Result<ConstantDeclarations> parseConstantDeclarations();
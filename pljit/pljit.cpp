@@ -3,54 +3,404 @@
 //
 
 #include "pljit.hpp"
+#include "./CodeCache.hpp"
+#include "./CompileCache.hpp"
 #include "./PljitFunction.hpp"
+#include "./SpecializationCache.hpp"
+#include "./util/EpochReclamation.hpp"
+#include "./util/ThreadPool.hpp"
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
-PljitFunctionHandle::PljitFunctionHandle(PljitFunction* function) : function(function) {}
-
-Pljit::~Pljit() {
-    ListNode* node = list_head;
-    while (node) {
-        ListNode* next = node->next;
-        node->~ListNode();
-        allocator.deallocate(node, 1);
-        node = next;
+namespace {
+//---------------------------------------------------------------------------
+/**
+ * Compiles the current version of the referenced function. The version is loaded when the compilation
+ * starts, so background compilations never refer to a version which was replaced in the meantime.
+ */
+std::optional<code::SourceCodeError> compileCurrentVersion(FunctionReference reference) {
+    EpochGuard guard;
+    PljitFunction* function = FunctionRegistry::current(reference);
+    if (!function) {
+        return {};
     }
+
+    function->ensure_compiled();
+    return function->compilation_error();
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+PljitFunctionHandle::PljitFunctionHandle(FunctionReference reference) : reference(reference) {}
+
+PljitFunction* PljitFunctionHandle::function() const {
+    return FunctionRegistry::current(reference);
 }
 
 std::optional<long long> PljitFunctionHandle::operator()(std::initializer_list<long long int> argument_list) const {
-    std::vector<long long> argument_vector{argument_list};
-    return function->evaluate(argument_vector);
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->evaluate(std::span<const long long>{ argument_list.begin(), argument_list.size() });
+}
+
+std::optional<long long> PljitFunctionHandle::operator()(std::span<const long long> arguments) const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->evaluate(arguments);
+}
+
+EvaluationResult PljitFunctionHandle::call(std::initializer_list<long long> argument_list) const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return EvaluationResult::failure(RuntimeErrorCode::UNREGISTERED_FUNCTION);
+    }
+    return current->call(std::span<const long long>{ argument_list.begin(), argument_list.size() });
+}
+
+EvaluationResult PljitFunctionHandle::call(std::span<const long long> arguments) const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return EvaluationResult::failure(RuntimeErrorCode::UNREGISTERED_FUNCTION);
+    }
+    return current->call(arguments);
+}
+
+RuntimeErrorCode PljitFunctionHandle::evaluateBatch(
+    std::initializer_list<std::span<const long long>> columns,
+    std::span<long long> output,
+    std::span<std::uint64_t> error_bitmap) const {
+    return evaluateBatch(std::span<const std::span<const long long>>{ columns.begin(), columns.size() }, output, error_bitmap);
+}
+
+RuntimeErrorCode PljitFunctionHandle::evaluateBatch(
+    std::span<const std::span<const long long>> columns,
+    std::span<long long> output,
+    std::span<std::uint64_t> error_bitmap) const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return RuntimeErrorCode::UNREGISTERED_FUNCTION;
+    }
+    return current->evaluateBatch(columns, output, error_bitmap);
 }
 
 std::optional<code::SourceCodeError> PljitFunctionHandle::compilation_error() const {
-    return function->compilation_error();
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->compilation_error();
+}
+
+std::future<std::optional<code::SourceCodeError>> PljitFunctionHandle::compileAsync() const {
+    ThreadPool* compile_pool = nullptr;
+    {
+        EpochGuard guard;
+        PljitFunction* current = function();
+        if (!current || current->compiled_function()) {
+            std::promise<std::optional<code::SourceCodeError>> ready;
+            ready.set_value(current ? current->compilation_error() : std::nullopt);
+            return ready.get_future();
+        }
+        compile_pool = current->thread_pool();
+    }
+
+    // the task must not hold on to the current version, it might be replaced before the task runs
+    auto compile = [reference = reference]() {
+        return compileCurrentVersion(reference);
+    };
+
+    if (compile_pool) {
+        return compile_pool->submit(std::move(compile));
+    }
+    return std::async(std::launch::async, std::move(compile));
+}
+
+std::vector<ast::optimize::PassStatistics> PljitFunctionHandle::optimization_statistics() const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    current->ensure_compiled();
+    return current->optimization_statistics();
+}
+
+TierStatistics PljitFunctionHandle::tier_statistics() const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->tier_statistics();
+}
+
+SpeculationStatistics PljitFunctionHandle::speculation_statistics() const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->speculation_statistics();
+}
+
+MemoizationStatistics PljitFunctionHandle::memoization_statistics() const {
+    EpochGuard guard;
+    PljitFunction* current = function();
+    if (!current) {
+        return {};
+    }
+    return current->memoization_statistics();
+}
+
+function_id PljitFunctionHandle::id() const {
+    return reference.id;
+}
+
+std::string_view PljitFunctionHandle::name() const {
+    return reference.slot->name;
+}
+
+bool PljitFunctionHandle::isRegistered() const {
+    return function() != nullptr;
+}
+
+std::uint64_t PljitFunctionHandle::version() const {
+    std::uint64_t version = reference.slot->version.load(std::memory_order_acquire);
+    // versions of a function registered in the reused slot are published after its id
+    return reference.slot->id.load(std::memory_order_acquire) == reference.id ? version : 0;
 }
 //---------------------------------------------------------------------------
-Pljit::ListNode::ListNode(std::unique_ptr<PljitFunction> function) : function(std::move(function)), next(nullptr) {}
-//---------------------------------------------------------------------------
-Pljit::Pljit() : list_head(nullptr), allocator() {}
+Pljit::Pljit(PljitOptions options) : registry() {
+    if (options.compile_threads > 0) {
+        compile_pool = std::make_unique<ThreadPool>(options.compile_threads);
+    }
+    if (!options.code_cache_directory.empty()) {
+        code_cache = std::make_unique<CodeCache>(std::move(options.code_cache_directory));
+    }
+    if (options.compile_cache_mode != CompileCacheMode::DISABLED) {
+        compile_cache = std::make_unique<CompileCache>(options.compile_cache_mode, code_cache.get());
+    }
+    specializations = std::make_unique<SpecializationCache>(options.specialization_cache_size);
+}
 
-PljitFunctionHandle Pljit::registerFunction(std::string&& source_code) {
+Pljit::~Pljit() {
+    // finishes pending compilations, before the functions are destroyed
+    compile_pool.reset();
+}
+
+PljitFunctionHandle Pljit::registerFunction(std::string&& source_code, CompileOptions options) {
     // My original approach was to create a shared_ptr here, which was to my perception the better approach,
     // as it automatically handled reference counting and was able to free its resources independent of the Pljit class
     // (e.g. no danger of dandling pointers when Pljit was accidentally freed; and freeing of resources not used anymore as early as possible!).
     // However, the specification explicitly stated that we shall use the Pljit class to >store< the PljitFunctions.
     // Therefore, I revised my design, and the lifetime of a PljitFunction is now bound to the Pljit class.
 
-    ListNode* node = new (allocator.allocate(1)) ListNode(std::make_unique<PljitFunction>(std::move(source_code)));
+    CompilationMode compilation_mode = options.compilation_mode;
+    FunctionReference reference = registry.add(createFunction(std::move(source_code), std::move(options)));
+    compileIfEager(reference, compilation_mode);
+    return PljitFunctionHandle{ reference };
+}
+
+std::optional<PljitFunctionHandle> Pljit::registerNamedFunction(std::string name, std::string&& source_code, CompileOptions options) {
+    CompilationMode compilation_mode = options.compilation_mode;
+    std::optional<FunctionReference> reference = registry.add(std::move(name), [&]() {
+        return createFunction(std::move(source_code), std::move(options));
+    });
+    if (!reference) {
+        return {};
+    }
 
-    std::atomic_ref head_ref{list_head};
+    compileIfEager(*reference, compilation_mode);
+    return PljitFunctionHandle{ *reference };
+}
 
-    ListNode* head = head_ref.load();
-    do {
-        node->next = head;
-    } while (!head_ref.compare_exchange_weak(head, node));
+bool Pljit::replace(const PljitFunctionHandle& handle, std::string&& source_code, CompileOptions options) {
+    CompilationMode compilation_mode = options.compilation_mode;
+    std::uint64_t version = FunctionRegistry::requestVersion(*handle.reference.slot);
+    if (!registry.replace(handle.reference, createFunction(std::move(source_code), std::move(options)), version)) {
+        return false;
+    }
 
-    return PljitFunctionHandle{ node->function.get() };
+    if (compile_cache) {
+        compile_cache->evictUnreferenced();
+    }
+    compileIfEager(handle.reference, compilation_mode);
+    return true;
+}
+
+std::future<std::optional<code::SourceCodeError>> Pljit::replaceAsync(const PljitFunctionHandle& handle, std::string&& source_code, CompileOptions options) {
+    FunctionReference reference = handle.reference;
+    std::uint64_t version = FunctionRegistry::requestVersion(*reference.slot);
+
+    auto compile = [this, reference, version, function = createFunction(std::move(source_code), std::move(options))]() mutable {
+        // the new version isn't reachable by any handle yet, so it can be compiled without an `EpochGuard`
+        function->ensure_compiled();
+        // retains the source code, the version is dropped with this task while the caller might still read the error
+        std::optional<code::SourceCodeError> error = function->compilation_error();
+        if (error) {
+            return error;
+        }
+
+        if (registry.replace(reference, std::move(function), version) && compile_cache) {
+            compile_cache->evictUnreferenced();
+        }
+        return error;
+    };
+
+    if (compile_pool) {
+        return compile_pool->submit(std::move(compile));
+    }
+    return std::async(std::launch::async, std::move(compile));
+}
+
+bool Pljit::unregisterFunction(const PljitFunctionHandle& handle) {
+    if (!registry.remove(handle.reference)) {
+        return false;
+    }
+
+    if (compile_cache) {
+        compile_cache->evictUnreferenced();
+    }
+    return true;
+}
+
+std::optional<PljitFunctionHandle> Pljit::specialize(const PljitFunctionHandle& handle, std::initializer_list<std::optional<long long>> bindings) {
+    return specialize(handle, std::span<const std::optional<long long>>{ bindings.begin(), bindings.size() });
+}
+
+std::optional<PljitFunctionHandle> Pljit::specialize(const PljitFunctionHandle& handle, std::span<const std::optional<long long>> bindings) {
+    // read before the function, a concurrent replacement then at worst caches the newer version under the older one
+    std::uint64_t version = handle.version();
+
+    std::string source_code;
+    CompileOptions options;
+    std::vector<std::optional<long long>> parameter_bindings;
+    {
+        EpochGuard guard;
+        PljitFunction* current = handle.function();
+        if (!current) {
+            return {};
+        }
+
+        current->ensure_compiled();
+        std::shared_ptr<const CompiledFunction> compiled = current->compiled_function();
+        if (compiled->compilation_error() || bindings.size() > compiled->parameter_count()) {
+            return {};
+        }
+
+        source_code = compiled->getSourceCode().content();
+        options = current->compile_options();
+
+        // the bindings of a specialization refer to its remaining parameters, which are the unbound ones of the source code
+        parameter_bindings = current->bound_parameters();
+        std::size_t position = 0;
+        for (const std::optional<long long>& binding: bindings) {
+            while (position < parameter_bindings.size() && parameter_bindings[position]) {
+                ++position;
+            }
+            if (position == parameter_bindings.size()) {
+                parameter_bindings.emplace_back();
+            }
+            parameter_bindings[position++] = binding;
+        }
+        while (!parameter_bindings.empty() && !parameter_bindings.back()) {
+            parameter_bindings.pop_back();
+        }
+    }
+
+    bool created = false;
+    std::vector<FunctionReference> evicted;
+    FunctionReference specialization = specializations->lookup(handle.id(), version, parameter_bindings, [&]() {
+        created = true;
+        return registry.add(std::make_unique<PljitFunction>(
+            std::string{ source_code }, options, compile_pool.get(), compile_cache.get(), code_cache.get(), parameter_bindings
+        ));
+    }, evicted);
+
+    for (FunctionReference reference: evicted) {
+        registry.remove(reference);
+    }
+    if (created) {
+        compileIfEager(specialization, options.compilation_mode);
+    }
+    return PljitFunctionHandle{ specialization };
+}
+
+std::optional<PljitFunctionHandle> Pljit::lookup(function_id id) const {
+    if (std::optional<FunctionReference> reference = registry.lookup(id)) {
+        return PljitFunctionHandle{ *reference };
+    }
+    return {};
+}
+
+std::optional<PljitFunctionHandle> Pljit::lookup(std::string_view name) const {
+    if (std::optional<FunctionReference> reference = registry.lookup(name)) {
+        return PljitFunctionHandle{ *reference };
+    }
+    return {};
+}
+
+std::vector<PljitFunctionHandle> Pljit::functions() const {
+    std::vector<PljitFunctionHandle> handles;
+    std::size_t count = registry.size();
+    handles.reserve(count);
+
+    // the id of a function grows with the index of its slot
+    for (std::size_t index = 0; index < count; ++index) {
+        if (std::optional<FunctionReference> reference = registry.at(index)) {
+            handles.push_back(PljitFunctionHandle{ *reference });
+        }
+    }
+    return handles;
+}
+
+std::unique_ptr<PljitFunction> Pljit::createFunction(std::string&& source_code, CompileOptions options) {
+    return std::make_unique<PljitFunction>(std::move(source_code), std::move(options), compile_pool.get(), compile_cache.get(), code_cache.get());
+}
+
+void Pljit::compileIfEager(FunctionReference reference, CompilationMode compilation_mode) {
+    if (compilation_mode != CompilationMode::EAGER) {
+        return;
+    }
+
+    if (compile_pool) {
+        compile_pool->submit([reference]() { compileCurrentVersion(reference); });
+    } else {
+        compileCurrentVersion(reference);
+    }
+}
+
+void Pljit::warmup() {
+    std::unique_ptr<ThreadPool> temporary_pool;
+    ThreadPool* pool = compile_pool.get();
+    if (!pool) {
+        temporary_pool = std::make_unique<ThreadPool>(std::max(1u, std::thread::hardware_concurrency()));
+        pool = temporary_pool.get();
+    }
+
+    std::vector<std::future<std::optional<code::SourceCodeError>>> compilations;
+    for (PljitFunctionHandle handle: functions()) {
+        FunctionReference reference = handle.reference;
+        compilations.push_back(pool->submit([reference]() { return compileCurrentVersion(reference); }));
+    }
+
+    for (auto& compilation: compilations) {
+        compilation.wait();
+    }
 }
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -5,10 +5,20 @@
 #ifndef PLJIT_PLJIT_HPP
 #define PLJIT_PLJIT_HPP
 
+#include "./CompileOptions.hpp"
+#include "./FunctionRegistry.hpp"
+#include "./MemoizationStatistics.hpp"
+#include "./SpeculationStatistics.hpp"
+#include "./TierStatistics.hpp"
+#include "./optimizations/PassManager.hpp"
 #include "./util/Result.hpp"
 #include <string>
+#include <future>
 #include <memory>
 #include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
 #include <gtest/gtest_prod.h>
 
 //---------------------------------------------------------------------------
@@ -16,13 +26,25 @@ namespace pljit {
 //---------------------------------------------------------------------------
 class Pljit;
 class PljitFunction;
+class ThreadPool;
+class CompileCache;
+class CodeCache;
+class SpecializationCache;
 //---------------------------------------------------------------------------
 class PljitFunctionHandle {
     friend class Pljit;
 
-    PljitFunction* function;
+    /// The registry slot and id of the function. Slots never move, so handles stay valid as long as the `Pljit` instance.
+    /// Once the slot is reused for another function, the id tells them apart.
+    FunctionReference reference;
 
-    explicit PljitFunctionHandle(PljitFunction* function);
+    explicit PljitFunctionHandle(FunctionReference reference);
+
+    /**
+     * @return Returns the current version of the function, null if it was unregistered.
+     * Must only be called while holding an `EpochGuard`, which keeps the version alive.
+     */
+    PljitFunction* function() const;
     public:
 
     // Copy constructor
@@ -34,6 +56,9 @@ class PljitFunctionHandle {
     // Move assignment
     PljitFunctionHandle& operator=(PljitFunctionHandle&& other) noexcept = default;
 
+    // Calls of a handle whose function was unregistered don't evaluate anything. They return an empty optional,
+    // `RuntimeErrorCode::UNREGISTERED_FUNCTION` or no compilation error and statistics respectively.
+
     /**
      * A call to this function will evaluate the function.
      * The function is compiled before execution if it wasn't compiled yet.
@@ -42,7 +67,7 @@ class PljitFunctionHandle {
      * @return Returns the value of the function evaluation. The optional might be empty if
      * either a compilation error or a runtime error occurred.
      * You can use the `compilation_error()` getter to get access to the compilation error.
-     * Runtime errors are printed to standard out.
+     * Runtime errors are reported to the `RuntimeErrorHandler` (printed to standard out by default).
      */
     template <typename... T>
     std::optional<long long> operator()(T... arguments) const;
@@ -53,14 +78,106 @@ class PljitFunctionHandle {
      * @return Returns the value of the function evaluation. The optional might be empty if
      * either a compilation error or a runtime error occurred.
      * You can use the `compilation_error()` getter to get access to the compilation error.
-     * Runtime errors are printed to standard out.
+     * Runtime errors are reported to the `RuntimeErrorHandler` (printed to standard out by default).
      */
     std::optional<long long> operator()(std::initializer_list<long long> argument_list) const;
+    /**
+     * A call to this function will evaluate the function.
+     * Once compiled, evaluation doesn't perform any heap allocations.
+     * @param arguments The arguments passed to the function.
+     * @return Returns the value of the function evaluation. See `operator()(std::initializer_list<long long>)`.
+     */
+    std::optional<long long> operator()(std::span<const long long> arguments) const;
 
     /**
-     * @return Returns the compilation error, if one occurred.
+     * Evaluates the function like `operator()`, but returns runtime errors as structured result
+     * instead of reporting them to the `RuntimeErrorHandler`.
+     * @param argument_list A list of arguments passed to the function.
+     * @return Returns the `EvaluationResult` holding either the return value or the `RuntimeErrorCode`
+     * and the location of the error. Compilation errors are reported as `RuntimeErrorCode::COMPILATION_ERROR`.
+     * The result retains the source code of the location, see `EvaluationResult::retainSource`.
+     */
+    EvaluationResult call(std::initializer_list<long long> argument_list) const;
+    EvaluationResult call(std::span<const long long> arguments) const;
+
+    /**
+     * Evaluates the function over columns of arguments, e.g. `evaluateBatch({ a, b }, result, errors)`.
+     * The function is compiled before execution if it wasn't compiled yet.
+     * @param columns One column per PARAM, in declaration order. All columns must have as many rows as `output`.
+     * @param output Receives the return value of every row. Zero for rows that failed.
+     * @param error_bitmap Bit `i % 64` of word `i / 64` is set if row `i` failed with a division by zero.
+     * Must provide at least `(output.size() + 63) / 64` words.
+     * @return Returns `RuntimeErrorCode::NONE` if every row succeeded and `RuntimeErrorCode::DIVISION_BY_ZERO`
+     * if any row failed. Errors that apply to all rows (argument count mismatch, compilation error) are returned
+     * without evaluating any row. Runtime errors aren't reported to the `RuntimeErrorHandler`.
+     */
+    RuntimeErrorCode evaluateBatch(
+        std::initializer_list<std::span<const long long>> columns,
+        std::span<long long> output,
+        std::span<std::uint64_t> error_bitmap
+    ) const;
+    RuntimeErrorCode evaluateBatch(
+        std::span<const std::span<const long long>> columns,
+        std::span<long long> output,
+        std::span<std::uint64_t> error_bitmap
+    ) const;
+
+    /**
+     * @return Returns the compilation error, if one occurred. The error retains its source code,
+     * so it stays valid after the function was replaced or unregistered.
      */
     std::optional<code::SourceCodeError> compilation_error() const;
+
+    /**
+     * Starts compiling the function in the background, so the first evaluation doesn't pay for it.
+     * The function is compiled on the compile thread pool of the `Pljit` instance if present,
+     * otherwise on a new thread. Concurrent evaluations wait for the compilation to complete.
+     * @return Returns a future holding the compilation error, if one occurred.
+     * The future is ready immediately if the function is already compiled.
+     */
+    std::future<std::optional<code::SourceCodeError>> compileAsync() const;
+
+    /**
+     * The function is compiled if it wasn't compiled yet.
+     * @return Returns the time spent in and the AST nodes removed by every optimization pass.
+     */
+    std::vector<ast::optimize::PassStatistics> optimization_statistics() const;
+
+    /**
+     * @return Returns the current tier, the call counter and the promotion state of the function.
+     * See `CompileOptions::tier_up_threshold`.
+     */
+    TierStatistics tier_statistics() const;
+    /**
+     * @return Returns the value profiling state, the speculated values and the guard hit and miss counters of the
+     * function. See `CompileOptions::value_profile_calls`.
+     */
+    SpeculationStatistics speculation_statistics() const;
+    /**
+     * @return Returns the hit, miss and eviction counters of the result cache of the function.
+     * See `CompileOptions::memoization_memory_limit`.
+     */
+    MemoizationStatistics memoization_statistics() const;
+
+    /**
+     * @return Returns the id of the function, which can be used to look it up through `Pljit::lookup`.
+     * Ids aren't handed out again once the function was unregistered.
+     */
+    function_id id() const;
+    /**
+     * @return Returns the name the function was registered with. Empty for unnamed functions.
+     */
+    std::string_view name() const;
+    /**
+     * @return Returns false once the function was unregistered through `Pljit::unregisterFunction`.
+     */
+    bool isRegistered() const;
+    /**
+     * @return Returns the version of the function currently evaluated by the handle. 0 for the registered source code,
+     * incremented with every replacement requested through `Pljit::replace` or `Pljit::replaceAsync`.
+     * 0 once the function was unregistered and its slot was reused.
+     */
+    std::uint64_t version() const;
 };
 
 template <typename... T>
@@ -74,31 +191,121 @@ std::optional<long long> PljitFunctionHandle::operator()(T... arguments) const {
  */
 class Pljit {
     FRIEND_TEST(Pljit, testMultiThreadedRegistration);
+    FRIEND_TEST(Pljit, testCompileCache);
+    FRIEND_TEST(Pljit, testHotReloadReclamation);
+    FRIEND_TEST(Pljit, testReplaceAsync);
+    FRIEND_TEST(Pljit, testSpecializationSlotReuse);
     friend class PljitFunctionHandle;
 
-    class ListNode {
-        public:
-        std::unique_ptr<PljitFunction> function;
-        ListNode* next;
-
-        explicit ListNode(std::unique_ptr<PljitFunction> function);
-    };
-
-    ListNode* list_head;
-    std::allocator<ListNode> allocator;
+    /// Compiles functions in the background. Null if the instance was created without compile threads.
+    std::unique_ptr<ThreadPool> compile_pool;
+    /// Loads and stores compilations across process restarts. Null if no directory was configured.
+    std::unique_ptr<CodeCache> code_cache;
+    /// Shares compilations of the same source code. Null if the `CompileCacheMode` is DISABLED.
+    std::unique_ptr<CompileCache> compile_cache;
+    /// The specializations kept alive, see `specialize`.
+    std::unique_ptr<SpecializationCache> specializations;
+    /// All registered functions. Declared last, so functions are destroyed before the caches they refer to.
+    FunctionRegistry registry;
 
     public:
-    Pljit();
+    /**
+     * @param options The `PljitOptions` applying to all functions of this instance.
+     */
+    explicit Pljit(PljitOptions options = {});
     ~Pljit();
 
     /**
-     * Registers a new function for the given source code. The code will
-     * be compiled just-in-time once required.
+     * Registers a new function for the given source code. The code will be compiled just-in-time once
+     * required, or right away if the `CompilationMode` of the options is `CompilationMode::EAGER`.
+     * Registrations of the same source code with the same `ExecutionMode` and `OptimizationLevel`
+     * share a single compilation, according to the `CompileCacheMode` of this instance.
      * The lifetime of the returned handle is bound to the lifetime of the Pljit object.
      * @param source_code The source code of the function.
+     * @param options The `CompileOptions` used to compile and execute the function.
      * @return Returns a easy to copy/move handle to a PljitFunction.
      */
-    PljitFunctionHandle registerFunction(std::string&& source_code);
+    PljitFunctionHandle registerFunction(std::string&& source_code, CompileOptions options = {});
+    /**
+     * Registers a new function under the given name, like `registerFunction(source_code, options)`.
+     * @param name The name used to look up the function. Must be unique within this instance.
+     * @return Returns the handle of the function, or an empty optional if the name is already taken.
+     */
+    std::optional<PljitFunctionHandle> registerNamedFunction(std::string name, std::string&& source_code, CompileOptions options = {});
+
+    /**
+     * Replaces the source code of the given function. All handles of the function evaluate the new version
+     * with their next call, evaluations already in progress complete with the previous version.
+     * The previous version is freed once no thread executes it anymore.
+     * The new version is compiled just-in-time, or right away if requested by the `CompilationMode`.
+     * @return Returns false if the function was unregistered.
+     */
+    bool replace(const PljitFunctionHandle& handle, std::string&& source_code, CompileOptions options = {});
+    /**
+     * Replaces the source code of the given function without any downtime. The new version is compiled in the
+     * background, on the compile thread pool if present or a new thread otherwise. Meanwhile, all handles keep
+     * evaluating the previous version. Once compiled, the new version is published atomically and picked up by
+     * every handle with its next call, without taking any locks.
+     * If the new version fails to compile, it is dropped and the previous version stays in place.
+     * If multiple replacements are pending, the most recently requested one wins, even if it completes first.
+     * The replacement must complete before the `Pljit` instance is destroyed.
+     * @return Returns a future holding the compilation error of the new version, if one occurred. The error retains
+     * the source code of the dropped version, so it stays valid after the replacement completed.
+     */
+    std::future<std::optional<code::SourceCodeError>> replaceAsync(const PljitFunctionHandle& handle, std::string&& source_code, CompileOptions options = {});
+    /**
+     * Unregisters the given function. Its name can be registered again and it is no longer returned by `lookup`.
+     * Evaluations already in progress complete, the function is freed once no thread executes it anymore.
+     * @return Returns false if the function was already unregistered.
+     */
+    bool unregisterFunction(const PljitFunctionHandle& handle);
+
+    /**
+     * Specializes the given function for fixed values of some of its parameters, e.g. `specialize(handle, { 2, {} })`
+     * for a function with two parameters. The specialization is compiled with the bound parameters turned into
+     * constants, so the optimization passes fold them away (unless the `OptimizationLevel` is O0). It takes the
+     * unbound parameters only, in declaration order, and uses the `CompileOptions` of the given function.
+     *
+     * Specializations are registered as unnamed functions of this instance and cached per function version and
+     * bound arguments, so repeated requests return the same handle. At most `PljitOptions::specialization_cache_size`
+     * specializations are kept, the least recently requested one is unregistered once the limit is exceeded.
+     * The registry slot of an unregistered specialization is reused, its handles stay unregistered.
+     * Specializing a specialization binds its remaining parameters.
+     * The given function is compiled if it wasn't compiled yet.
+     * @param bindings The value of every parameter in declaration order, empty for parameters which stay unbound.
+     * Trailing parameters without an entry stay unbound.
+     * @return Returns the handle of the specialization, or an empty optional if the function was unregistered,
+     * failed to compile or declares fewer parameters than bindings were given.
+     */
+    std::optional<PljitFunctionHandle> specialize(const PljitFunctionHandle& handle, std::initializer_list<std::optional<long long>> bindings);
+    std::optional<PljitFunctionHandle> specialize(const PljitFunctionHandle& handle, std::span<const std::optional<long long>> bindings);
+
+    /**
+     * Looks up a function by the id of its handle. Wait-free, never blocks concurrent registrations.
+     * @return Returns the handle of the function, or an empty optional if there is no function with that id.
+     */
+    std::optional<PljitFunctionHandle> lookup(function_id id) const;
+    /**
+     * Looks up a function by the name it was registered with. Never blocks, even during concurrent registrations.
+     * @return Returns the handle of the function, or an empty optional if there is no function with that name.
+     */
+    std::optional<PljitFunctionHandle> lookup(std::string_view name) const;
+
+    /**
+     * @return Returns the handles of all functions registered so far, ordered by their id.
+     */
+    std::vector<PljitFunctionHandle> functions() const;
+
+    /**
+     * Compiles every function registered so far in parallel and waits till all of them are compiled.
+     * Uses the compile thread pool if present, otherwise one temporary thread per hardware thread.
+     */
+    void warmup();
+
+    private:
+    std::unique_ptr<PljitFunction> createFunction(std::string&& source_code, CompileOptions options);
+    /// Compiles the function right away if requested by its `CompilationMode`.
+    void compileIfEager(FunctionReference reference, CompilationMode compilation_mode);
 };
 //---------------------------------------------------------------------------
 } // namespace pljit
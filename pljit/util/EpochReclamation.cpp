@@ -0,0 +1,144 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./EpochReclamation.hpp"
+#include <algorithm>
+#include <atomic>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * The epoch announced by a single thread. Records are never freed, a record released by an exited thread
+ * is reused by the next new thread, so the list is as long as the maximum number of threads alive at once.
+ */
+struct ThreadRecord {
+    /// The announced epoch, 0 while the thread isn't pinned.
+    std::atomic<std::uint64_t> epoch{ 0 };
+    std::atomic<bool> in_use{ true };
+    ThreadRecord* next = nullptr;
+    /// Number of nested guards, only accessed by the owning thread.
+    unsigned depth = 0;
+};
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The epoch of a record whose thread isn't pinned. The global epoch starts at 1.
+constexpr std::uint64_t INACTIVE = 0;
+
+std::atomic<std::uint64_t> global_epoch{ 1 };
+
+std::atomic<ThreadRecord*> records{ nullptr };
+
+ThreadRecord* acquireRecord() {
+    for (ThreadRecord* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        bool in_use = false;
+        if (!record->in_use.load(std::memory_order_relaxed) && record->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+
+    auto* record = new ThreadRecord;
+    record->next = records.load(std::memory_order_relaxed);
+    while (!records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {}
+    return record;
+}
+
+/// Releases the record of a thread once it exits.
+struct RecordOwner {
+    ThreadRecord* record = acquireRecord();
+
+    ~RecordOwner() {
+        record->in_use.store(false, std::memory_order_release);
+    }
+};
+
+/// Trivially initialized, so accessing it doesn't require a check whether the thread_local was constructed.
+thread_local ThreadRecord* thread_record = nullptr;
+
+ThreadRecord* threadRecord() {
+    if (!thread_record) [[unlikely]] {
+        thread_local RecordOwner owner;
+        thread_record = owner.record;
+    }
+    return thread_record;
+}
+
+/**
+ * Advances the global epoch if every pinned thread announced the current one.
+ */
+void tryAdvanceEpoch() {
+    std::uint64_t epoch = global_epoch.load();
+    for (ThreadRecord* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        std::uint64_t announced = record->epoch.load();
+        if (announced != INACTIVE && announced != epoch) {
+            return;
+        }
+    }
+    global_epoch.compare_exchange_strong(epoch, epoch + 1);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+EpochGuard::EpochGuard() : record(threadRecord()) {
+    if (record->depth++ > 0) {
+        return;
+    }
+
+    // The announcement must be visible before any shared pointer is read. Re-reading the global epoch ensures
+    // we didn't announce an epoch which was already left behind by a concurrent `tryAdvanceEpoch`.
+    std::uint64_t epoch = global_epoch.load();
+    while (true) {
+        record->epoch.store(epoch);
+        std::uint64_t current = global_epoch.load();
+        if (current == epoch) {
+            break;
+        }
+        epoch = current;
+    }
+}
+
+EpochGuard::~EpochGuard() {
+    if (--record->depth == 0) {
+        record->epoch.store(INACTIVE, std::memory_order_release);
+    }
+}
+//---------------------------------------------------------------------------
+RetireList::RetireList() = default;
+
+RetireList::~RetireList() {
+    for (auto& object: retired) {
+        object.destroy(object.object);
+    }
+}
+
+std::size_t RetireList::pending() const {
+    std::lock_guard lock{ mutex };
+    return retired.size();
+}
+
+void RetireList::retire(void* object, void (*destroy)(void*)) {
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard lock{ mutex };
+        retired.push_back({ global_epoch.load(), object, destroy });
+
+        tryAdvanceEpoch();
+        std::uint64_t epoch = global_epoch.load();
+
+        auto safe = std::partition(retired.begin(), retired.end(), [epoch](const Retired& candidate) {
+            return candidate.epoch + 2 > epoch;
+        });
+        reclaimable.assign(safe, retired.end());
+        retired.erase(safe, retired.end());
+    }
+
+    // destroyed outside the lock, destructors might be expensive
+    for (auto& candidate: reclaimable) {
+        candidate.destroy(candidate.object);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_EPOCHRECLAMATION_HPP
+#define PLJIT_EPOCHRECLAMATION_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+struct ThreadRecord;
+//---------------------------------------------------------------------------
+/**
+ * Pins the calling thread to the current global epoch for the lifetime of the guard.
+ * Objects retired through a `RetireList` aren't destroyed while a thread which might still reference them is pinned.
+ *
+ * Entering and leaving a guard only touches a record owned by the calling thread, no shared counter is modified.
+ * Guards may be nested. A thread must not hold a guard for an unbounded time, as that delays all reclamation.
+ */
+class EpochGuard {
+    ThreadRecord* record;
+
+    public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(const EpochGuard& other) = delete;
+    EpochGuard& operator=(const EpochGuard& other) = delete;
+};
+//---------------------------------------------------------------------------
+/**
+ * Objects which were unlinked from a shared data structure, but might still be referenced by pinned threads.
+ * An object retired in epoch `e` is destroyed once the global epoch reached `e + 2`: the epoch only advances
+ * if every pinned thread observed the current one, therefore no thread pinned before the object was unlinked remains.
+ *
+ * Every `retire` tries to advance the global epoch and destroys the objects which became safe to destroy,
+ * so the number of pending objects stays bounded as long as no thread stays pinned forever.
+ */
+class RetireList {
+    struct Retired {
+        std::uint64_t epoch;
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Retired> retired;
+
+    public:
+    RetireList();
+    /// Destroys all pending objects. No thread may reference them anymore.
+    ~RetireList();
+
+    RetireList(const RetireList& other) = delete;
+    RetireList& operator=(const RetireList& other) = delete;
+
+    /**
+     * Takes ownership of the given object, which must not be reachable for threads pinning an epoch from now on.
+     */
+    template <typename T>
+    void retire(T* object);
+
+    /**
+     * @return Returns the number of retired objects which weren't destroyed yet.
+     */
+    std::size_t pending() const;
+
+    private:
+    void retire(void* object, void (*destroy)(void*));
+};
+
+template <typename T>
+void RetireList::retire(T* object) {
+    retire(object, [](void* retired) { delete static_cast<T*>(retired); });
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_EPOCHRECLAMATION_HPP
@@ -8,23 +8,23 @@
 #include "../code/SourceCode.hpp"
 #include <cassert>
 #include <concepts>
-#include <optional>
+#include <variant>
 
 namespace pljit {
 //---------------------------------------------------------------------------
 /**
  * Result type describing some result which might fail with an `SourceCodeError`.
+ * Holds either the value or the error, so `T` doesn't need to be default constructible.
  * @tparam T - Some result type.
  */
 template <typename T>
 class Result {
-    std::optional<code::SourceCodeError> source_error;
-    T result_content;
+    std::variant<T, code::SourceCodeError> content;
 
     public:
     Result() requires std::default_initializable<T>;
     Result(T result) requires std::move_constructible<T>; // NOLINT(google-explicit-constructor)
-    Result(code::SourceCodeError error) requires std::default_initializable<T>; // NOLINT(google-explicit-constructor)
+    Result(code::SourceCodeError error); // NOLINT(google-explicit-constructor)
 
     /**
      * @return Returns the value of the Result (only if a value is present).
@@ -37,7 +37,7 @@ class Result {
     /**
      * @return Returns the error of the Result (only if an error is present).
      */
-    code::SourceCodeError error() const;
+    const code::SourceCodeError& error() const;
 
     /**
      * Implicit conversion to bool. Returns true if the Result has a value.
@@ -51,45 +51,45 @@ class Result {
     const T* operator->() const;
 };
 template <typename T>
-Result<T>::Result() requires std::default_initializable<T> : source_error(), result_content() {}
+Result<T>::Result() requires std::default_initializable<T> : content(std::in_place_index<0>) {}
 
 template <typename T>
-Result<T>::Result(T result) requires std::move_constructible<T> : source_error(), result_content(std::move(result)) {}
+Result<T>::Result(T result) requires std::move_constructible<T> : content(std::in_place_index<0>, std::move(result)) {}
 
 template <typename T>
-Result<T>::Result(code::SourceCodeError error) requires std::default_initializable<T> : source_error(std::move(error)), result_content() {}
+Result<T>::Result(code::SourceCodeError error) : content(std::in_place_index<1>, std::move(error)) {}
 
 template <typename T>
 const T& Result<T>::value() const {
-    assert(!source_error.has_value() && "Result: result not present. SourceCode error occurred!");
-    return result_content;
+    assert(isSuccess() && "Result: result not present. SourceCode error occurred!");
+    return *std::get_if<0>(&content);
 }
 
 template <typename T>
 T&& Result<T>::release() requires std::movable<T> {
-    assert(!source_error.has_value() && "Result: result not present. SourceCode error occurred!");
-    return std::move(result_content);
+    assert(isSuccess() && "Result: result not present. SourceCode error occurred!");
+    return std::move(*std::get_if<0>(&content));
 }
 
 template <typename T>
-code::SourceCodeError Result<T>::error() const {
-    assert(source_error.has_value() && "LexerResult: tried accessing non-existent error!");
-    return *source_error;
+const code::SourceCodeError& Result<T>::error() const {
+    assert(isFailure() && "Result: tried accessing non-existent error!");
+    return *std::get_if<1>(&content);
 }
 
 template <typename T>
 Result<T>::operator bool() const {
-    return !source_error.has_value();
+    return isSuccess();
 }
 
 template <typename T>
 bool Result<T>::isSuccess() const {
-    return !source_error.has_value();
+    return content.index() == 0;
 }
 
 template <typename T>
 bool Result<T>::isFailure() const {
-    return source_error.has_value();
+    return content.index() == 1;
 }
 
 template <typename T>
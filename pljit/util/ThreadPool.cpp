@@ -0,0 +1,67 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./ThreadPool.hpp"
+#include <cassert>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+ThreadPool::ThreadPool(std::size_t thread_count) : stopping(false) {
+    assert(thread_count > 0 && "ThreadPool requires at least one thread!");
+
+    workers.reserve(thread_count);
+    for (std::size_t index = 0; index < thread_count; ++index) {
+        workers.emplace_back([this]() { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{ queue_mutex };
+        stopping = true;
+    }
+    queue_condition.notify_all();
+
+    for (auto& worker: workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::thread_count() const {
+    return workers.size();
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard lock{ queue_mutex };
+        assert(!stopping && "Tried to submit a task to a stopping ThreadPool!");
+        queue.push_back(std::move(task));
+    }
+    queue_condition.notify_one();
+}
+
+void ThreadPool::run() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock{ queue_mutex };
+            queue_condition.wait(lock, [this]() { return stopping || !queue.empty(); });
+
+            // the queue is drained before stopping
+            if (queue.empty()) {
+                return;
+            }
+
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        task();
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_THREADPOOL_HPP
+#define PLJIT_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * A fixed number of worker threads executing submitted tasks in FIFO order.
+ * Tasks still queued on destruction are executed before the workers are joined.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    std::deque<std::function<void()>> queue;
+    bool stopping;
+
+    public:
+    /**
+     * @param thread_count The number of worker threads, at least one.
+     */
+    explicit ThreadPool(std::size_t thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    /**
+     * Enqueues the given task.
+     * @return Returns a future which becomes ready once the task was executed.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task);
+
+    std::size_t thread_count() const;
+
+    private:
+    void enqueue(std::function<void()> task);
+    void run();
+};
+
+template <typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task) {
+    // std::function requires a copyable target, thus the move-only packaged_task is shared.
+    auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+    std::future<std::invoke_result_t<F>> future = packaged->get_future();
+
+    enqueue([packaged]() { (*packaged)(); });
+    return future;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_THREADPOOL_HPP
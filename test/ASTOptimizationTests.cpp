@@ -5,8 +5,10 @@
 #include "pljit/ast/AST.hpp"
 #include "pljit/ast/ASTDOTVisitor.hpp"
 #include "pljit/lex/Lexer.hpp"
+#include "pljit/optimizations/CommonSubexpressionElimination.hpp"
 #include "pljit/optimizations/ConstantPropagation.hpp"
 #include "pljit/optimizations/DeadCodeElimination.hpp"
+#include "pljit/optimizations/PassManager.hpp"
 #include "pljit/parse/Parser.hpp"
 #include "test/utils/ast_utils.hpp"
 #include "utils/CaptureCOut.hpp"
@@ -173,4 +175,251 @@ TEST(ASTOptimization, testConstantPropagation) {
         "}\n"
     );
 }
+
+TEST(ASTOptimization, testPassManager) {
+    SourceCodeManagement management{"PARAM x;\n"
+                                    "VAR a;\n"
+                                    "CONST c = 2;\n"
+                                    "BEGIN\n"
+                                    "  a := c * 3;\n" // a := 6;
+                                    "  RETURN a + x;\n" // RETURN 6 + x
+                                    "  RETURN 0\n" // removed
+                                    "END."};
+
+    for (auto level: {OptimizationLevel::O0, OptimizationLevel::O1, OptimizationLevel::O2}) {
+        Result<Function> result = buildAST(management);
+        ASSERT_TRUE(result.isSuccess());
+        Function function = result.release();
+
+        std::size_t nodes = countNodes(function);
+
+        PassManager manager = PassManager::forLevel(level);
+        bool modified = manager.run(function);
+        auto& statistics = manager.getStatistics();
+
+        if (level == OptimizationLevel::O0) {
+            ASSERT_FALSE(modified);
+            ASSERT_TRUE(statistics.empty());
+            ASSERT_EQ(countNodes(function), nodes);
+        } else {
+            ASSERT_TRUE(modified);
+            ASSERT_EQ(statistics.size(), level == OptimizationLevel::O2 ? 3 : 2);
+            ASSERT_EQ(statistics[0].name, "ConstantPropagation");
+            ASSERT_EQ(statistics[1].name, "DeadCodeElimination");
+            if (level == OptimizationLevel::O2) {
+                ASSERT_EQ(statistics[2].name, "CommonSubexpressionElimination");
+                ASSERT_EQ(statistics[2].changes, 0);
+            }
+
+            // O2 needs a second iteration to detect the fixpoint
+            unsigned iterations = level == OptimizationLevel::O2 ? 2 : 1;
+            ASSERT_EQ(manager.getIterations(), iterations);
+            ASSERT_EQ(statistics[0].runs, iterations);
+            ASSERT_EQ(statistics[0].changes, 1);
+            ASSERT_EQ(statistics[1].changes, 1);
+            ASSERT_GT(statistics[0].removed_nodes, 0);
+            ASSERT_GT(statistics[1].removed_nodes, 0);
+            ASSERT_EQ(countNodes(function), nodes - statistics[0].removed_nodes - statistics[1].removed_nodes);
+        }
+
+        auto context = function.evaluate({5});
+        ASSERT_TRUE(context.return_value());
+        ASSERT_EQ(*context.return_value(), 11);
+    }
+}
+
+TEST(ASTOptimization, testBindParameters) {
+    SourceCodeManagement management{"PARAM a, b, c;\n"
+                                    "CONST d = 2;\n"
+                                    "BEGIN\n"
+                                    "  RETURN (a * b + c) * d\n"
+                                    "END."};
+
+    Result<Function> result = buildAST(management);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+
+    std::optional<long long> bindings[] = { 1, std::nullopt, 0 };
+    function.bindParameters(bindings);
+
+    ASSERT_TRUE(function.getParamDeclaration());
+    ASSERT_EQ(function.getParamDeclaration()->getDeclaredIdentifiers().size(), 1);
+    ASSERT_EQ(function.getParamDeclaration()->getDeclaredIdentifiers()[0].getName(), "b");
+    ASSERT_EQ(function.getConstDeclaration()->getConstDeclarations().size(), 3);
+
+    ConstantPropagation optimization;
+    ASSERT_TRUE(optimization.optimize(function));
+
+    // `(1 * b + 0) * 2` leaves `b * 2` behind
+    const ExpressionArena& expressions = function.getExpressions();
+    const Expression& expression = expressions[function.getStatements()[0].getExpression()];
+    ASSERT_EQ(expression.getType(), Node::Type::MULTIPLY);
+    ASSERT_EQ(expressions[expression.getLeft()].getType(), Node::Type::VARIABLE);
+    ASSERT_EQ(expressions.getName(expressions[expression.getLeft()]), "b");
+    ASSERT_EQ(expressions[expression.getRight()].value(), 2);
+
+    auto context = function.evaluate({5});
+    ASSERT_TRUE(context.return_value());
+    ASSERT_EQ(*context.return_value(), 10);
+
+    // binding every parameter removes the PARAM declaration
+    std::optional<long long> remaining[] = { 3 };
+    function.bindParameters(remaining);
+    ASSERT_FALSE(function.getParamDeclaration());
+    ASSERT_EQ(function.evaluate(std::span<const long long>{}).return_value(), 6);
+    ASSERT_EQ(function.evaluate({3}).runtime_error_code(), RuntimeErrorCode::UNEXPECTED_ARGUMENTS);
+}
+
+TEST(ASTOptimization, testAssumeParameters) {
+    SourceCodeManagement management{"PARAM a, b;\n"
+                                    "BEGIN\n"
+                                    "  RETURN a * b\n"
+                                    "END."};
+
+    Result<Function> result = buildAST(management);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+
+    std::optional<long long> assumptions[] = { 1 };
+    function.assumeParameters(assumptions);
+
+    ConstantPropagation optimization;
+    ASSERT_TRUE(optimization.optimize(function));
+
+    // the signature is unchanged, `a` must be passed matching the assumption
+    ASSERT_EQ(function.getParamDeclaration()->getDeclaredIdentifiers().size(), 2);
+    ASSERT_FALSE(function.getConstDeclaration());
+    const ExpressionArena& expressions = function.getExpressions();
+    ASSERT_EQ(expressions.getName(expressions[function.getStatements()[0].getExpression()]), "b");
+    ASSERT_EQ(function.evaluate({1, 5}).return_value(), 5);
+}
+
+TEST(ASTOptimization, testConstantPropagationIdentities) {
+    SourceCodeManagement management{"PARAM a, b;\n"
+                                    "VAR c, d, e;\n"
+                                    "BEGIN\n"
+                                    "  c := 0 + a - 0;\n" // c := a;
+                                    "  d := 1 * (b / 1);\n" // d := b;
+                                    "  e := (a + b) * 0;\n" // e := 0;
+                                    "  RETURN (a / b) * 0 + 0\n" // RETURN (a / b) * 0
+                                    "END."};
+
+    Result<Function> result = buildAST(management);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+
+    ConstantPropagation optimization;
+    ASSERT_TRUE(optimization.optimize(function));
+
+    const ExpressionArena& expressions = function.getExpressions();
+    auto& statements = function.getStatements();
+    ASSERT_EQ(expressions.getName(expressions[statements[0].getExpression()]), "a");
+    ASSERT_EQ(expressions.getName(expressions[statements[1].getExpression()]), "b");
+    ASSERT_EQ(expressions[statements[2].getExpression()].getType(), Node::Type::LITERAL);
+
+    // the division might fail, thus it isn't folded
+    const Expression& returned = expressions[statements[3].getExpression()];
+    ASSERT_EQ(returned.getType(), Node::Type::MULTIPLY);
+    ASSERT_EQ(expressions[returned.getLeft()].getType(), Node::Type::DIVIDE);
+
+    ASSERT_EQ(function.evaluate({4, 2}).return_value(), 0);
+    ASSERT_EQ(function.evaluate({4, 0}).runtime_error_code(), RuntimeErrorCode::DIVISION_BY_ZERO);
+}
+
+TEST(ASTOptimization, testCommonSubexpressionElimination) {
+    SourceCodeManagement management{"PARAM a, b, c;\n"
+                                    "VAR d, e;\n"
+                                    "BEGIN\n"
+                                    "  d := a * b + c;\n"
+                                    "  e := c + b * a;\n" // the same value
+                                    "  a := a + 1;\n"
+                                    "  RETURN (a * b + c) + d * e\n" // `a` was reassigned
+                                    "END."};
+
+    Result<Function> result = buildAST(management);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+    ASSERT_EQ(function.symbol_count(), 5);
+
+    CommonSubexpressionElimination optimization;
+    ASSERT_TRUE(optimization.optimize(function));
+    ASSERT_FALSE(optimization.optimize(function));
+
+    // `$0 := a * b + c` is inserted before the first statement computing it
+    ASSERT_EQ(function.symbol_count(), 6);
+    ASSERT_EQ(function.getVarDeclaration()->getDeclaredIdentifiers().size(), 3);
+    const ExpressionArena& expressions = function.getExpressions();
+    auto& statements = function.getStatements();
+    ASSERT_EQ(statements.size(), 5);
+    ASSERT_EQ(statements[0].getVariable().getName(), "$0");
+    ASSERT_EQ(statements[0].getVariable().getSymbolId(), 6);
+    ASSERT_EQ(expressions[statements[0].getExpression()].getType(), Node::Type::ADD);
+    ASSERT_EQ(expressions.getName(expressions[statements[1].getExpression()]), "$0");
+    ASSERT_EQ(expressions.getName(expressions[statements[2].getExpression()]), "$0");
+    const Expression& returned = expressions[statements[4].getExpression()];
+    ASSERT_EQ(expressions[returned.getLeft()].getType(), Node::Type::ADD);
+
+    ASSERT_EQ(function.evaluate({2, 3, 4}).return_value(), 3 * 3 + 4 + 100);
+}
+
+TEST(ASTOptimization, testCommonSubexpressionEliminationNested) {
+    SourceCodeManagement management{"PARAM a, b;\n"
+                                    "BEGIN\n"
+                                    "  RETURN (a * b + 1) * (a * b + 1) + a * b\n"
+                                    "END."};
+
+    Result<Function> result = buildAST(management);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+
+    CommonSubexpressionElimination optimization;
+    ASSERT_TRUE(optimization.optimize(function));
+
+    // the larger value is shared first, its temporary uses the one of the smaller value
+    const ExpressionArena& expressions = function.getExpressions();
+    auto& statements = function.getStatements();
+    ASSERT_EQ(function.symbol_count(), 4);
+    ASSERT_EQ(statements.size(), 3);
+    ASSERT_EQ(statements[0].getVariable().getName(), "$1");
+    ASSERT_EQ(expressions[statements[0].getExpression()].getType(), Node::Type::MULTIPLY);
+    ASSERT_EQ(statements[1].getVariable().getName(), "$0");
+    const Expression& temporary = expressions[statements[1].getExpression()];
+    ASSERT_EQ(expressions.getName(expressions[temporary.getLeft()]), "$1");
+
+    const Expression& returned = expressions[statements[2].getExpression()];
+    const Expression& product = expressions[returned.getLeft()];
+    ASSERT_EQ(expressions.getName(expressions[product.getLeft()]), "$0");
+    ASSERT_EQ(expressions.getName(expressions[product.getRight()]), "$0");
+    ASSERT_EQ(expressions.getName(expressions[returned.getRight()]), "$1");
+
+    ASSERT_EQ(function.evaluate({3, 4}).return_value(), 13 * 13 + 12);
+}
+
+TEST(ASTOptimization, testCommonSubexpressionEliminationDivisions) {
+    // sharing `b / a` would evaluate it before `a / b`, which fails first for `a = b = 0`
+    SourceCodeManagement preceded{"PARAM a, b;\n"
+                                  "BEGIN\n"
+                                  "  RETURN a / b + (b / a) * (b / a)\n"
+                                  "END."};
+    Result<Function> result = buildAST(preceded);
+    ASSERT_TRUE(result.isSuccess());
+    Function function = result.release();
+
+    CommonSubexpressionElimination optimization;
+    ASSERT_FALSE(optimization.optimize(function));
+
+    SourceCodeManagement first{"PARAM a, b;\n"
+                               "BEGIN\n"
+                               "  RETURN (b / a) * (b / a) + a / b\n"
+                               "END."};
+    result = buildAST(first);
+    ASSERT_TRUE(result.isSuccess());
+    function = result.release();
+
+    ASSERT_TRUE(optimization.optimize(function));
+    auto context = function.evaluate({0, 0});
+    ASSERT_EQ(context.runtime_error_code(), RuntimeErrorCode::DIVISION_BY_ZERO);
+    ASSERT_EQ(*context.result().reference(), "b / a");
+    ASSERT_EQ(function.evaluate({2, 4}).return_value(), 4);
+}
 //---------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/ast/AST.hpp"
+#include "pljit/ast/ASTBuilder.hpp"
+#include "pljit/ast/ASTDOTVisitor.hpp"
+#include "pljit/ast/ASTParser.hpp"
+#include "pljit/lex/Lexer.hpp"
+#include "pljit/parse/Parser.hpp"
+#include "utils/CaptureCOut.hpp"
+#include "utils/CountAllocations.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::code;
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+Result<Function> buildThroughParseTree(const SourceCodeManagement& management) {
+    lex::Lexer lexer{ management };
+    parse::Parser parser{ lexer };
+
+    Result<parse::FunctionDefinition> program = parser.parse_program();
+    if (!program) {
+        return program.error();
+    }
+
+    ASTBuilder builder;
+    return builder.analyzeFunction(*program);
+}
+
+Result<Function> buildDirectly(const SourceCodeManagement& management) {
+    lex::Lexer lexer{ management };
+    ASTParser parser{ lexer };
+    return parser.parseFunction();
+}
+
+std::string printDOT(const Function& function) {
+    DOTVisitor visitor;
+    CaptureCOut capture;
+    visitor.print(function);
+    return capture.str();
+}
+
+std::string printError(const Result<Function>& function) {
+    CaptureCOut capture;
+    function.error().printCompilerError();
+    return capture.str();
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(ASTParser, testMatchesASTBuilder) {
+    std::vector<std::string> sources{
+        "PARAM width, height, depth;\n"
+        "VAR volume;\n"
+        "CONST density = 2400;\n"
+        "BEGIN\n"
+        "  volume := width * height * depth;\n"
+        "  RETURN density * volume\n"
+        "END.",
+        "PARAM a, b;\n"
+        "VAR x, y;\n"
+        "BEGIN\n"
+        "  x := -(a - b - 3) / +b * (a + 1);\n"
+        "  y := x / 2 / a;\n"
+        "  RETURN x - y + -a;\n"
+        "  x := 1\n"
+        "END.",
+        "BEGIN RETURN 1 END.",
+    };
+
+    for (auto& source: sources) {
+        SourceCodeManagement management{ std::string{ source } };
+        Result<Function> expected = buildThroughParseTree(management);
+        Result<Function> actual = buildDirectly(management);
+        ASSERT_TRUE(expected.isSuccess());
+        ASSERT_TRUE(actual.isSuccess());
+
+        EXPECT_EQ(printDOT(*actual), printDOT(*expected));
+        EXPECT_EQ(actual->symbol_count(), expected->symbol_count());
+    }
+
+    // source code references of divisions must point to the same expression
+    SourceCodeManagement management{"PARAM a;\n"
+                                    "BEGIN\n"
+                                    "  RETURN 3 + (a + 1) * 2 / (a - a)\n"
+                                    "END."};
+    EvaluationResult expected = buildThroughParseTree(management)->evaluate({ 1 }).result();
+    EvaluationResult actual = buildDirectly(management)->evaluate({ 1 }).result();
+    ASSERT_TRUE(actual.error() == RuntimeErrorCode::DIVISION_BY_ZERO);
+    ASSERT_EQ(actual.reference(), expected.reference());
+}
+
+TEST(ASTParser, testErrorsMatchASTBuilder) {
+    std::vector<std::string> sources{
+        // syntax errors
+        "BEGIN RETURN 1 END",
+        "BEGIN RETURN (1 + 2 END.",
+        "VAR a; PARAM b; BEGIN RETURN 1 END.",
+        "CONST a = 99999999999999999999; BEGIN RETURN a END.",
+        "BEGIN RETURN 1 * / 2 END.",
+        "BEGIN RETURN 1 END. x",
+        // semantic errors
+        "VAR a; BEGIN RETURN a END.",
+        "BEGIN RETURN b END.",
+        "CONST c = 1; BEGIN c := 2; RETURN c END.",
+        "PARAM a; VAR a; BEGIN RETURN a END.",
+        "VAR a; BEGIN a := a + 1; RETURN a END.",
+        "VAR a; BEGIN a := 1 END.",
+        // a semantic error before a syntax error reports the syntax error
+        "VAR a; BEGIN RETURN a + b; a := END.",
+    };
+
+    for (auto& source: sources) {
+        SourceCodeManagement management{ std::string{ source } };
+        Result<Function> expected = buildThroughParseTree(management);
+        Result<Function> actual = buildDirectly(management);
+        ASSERT_TRUE(expected.isFailure()) << source;
+        ASSERT_TRUE(actual.isFailure()) << source;
+
+        EXPECT_EQ(printError(actual), printError(expected)) << source;
+    }
+}
+
+TEST(ASTParser, testFewerAllocations) {
+    std::string source = "PARAM p;\nVAR v;\nBEGIN\n  v := p;\n";
+    for (unsigned index = 0; index < 32; ++index) {
+        source += "  v := (v + p) * 3 - v / (p + 1) + -v;\n";
+    }
+    source += "  RETURN v\nEND.";
+    SourceCodeManagement management{ std::move(source) };
+
+    std::size_t parse_tree_allocations;
+    {
+        CountAllocations allocations;
+        ASSERT_TRUE(buildThroughParseTree(management).isSuccess());
+        parse_tree_allocations = allocations.count();
+    }
+
+    std::size_t direct_allocations;
+    {
+        CountAllocations allocations;
+        ASSERT_TRUE(buildDirectly(management).isSuccess());
+        direct_allocations = allocations.count();
+    }
+
+    EXPECT_LT(direct_allocations * 2, parse_tree_allocations);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,314 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/ast/AST.hpp"
+#include "pljit/bytecode/BatchKernels.hpp"
+#include "pljit/bytecode/Bytecode.hpp"
+#include "pljit/bytecode/BytecodeCompiler.hpp"
+#include "test/utils/ast_utils.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::code;
+using namespace pljit::ast;
+using namespace pljit::bytecode;
+//---------------------------------------------------------------------------
+TEST(Bytecode, testExampleProgram) {
+    SourceCodeManagement management{"PARAM width, height, depth;\n"
+                                    "VAR volume;\n"
+                                    "CONST density = 2400;\n"
+                                    "BEGIN\n"
+                                    "  volume := width * height * depth;\n"
+                                    "  RETURN density * volume\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    BytecodeCompiler compiler;
+    BytecodeFunction bytecode = compiler.compile(*function);
+
+    // volume := width * (height * depth) writes the outer product directly into `volume`.
+    auto& instructions = bytecode.getInstructions();
+    ASSERT_EQ(instructions.size(), 4);
+    EXPECT_EQ(instructions[0].opCode, OpCode::MULTIPLY);
+    EXPECT_EQ(instructions[1].opCode, OpCode::MULTIPLY);
+    EXPECT_EQ(instructions[1].target, 3); // volume
+    EXPECT_EQ(instructions[2].opCode, OpCode::MULTIPLY);
+    EXPECT_EQ(instructions[3].opCode, OpCode::RETURN);
+
+    // 5 symbols and a single temporary.
+    EXPECT_EQ(bytecode.register_count(), 6);
+    EXPECT_EQ(bytecode.getInitialRegisters()[4], 2400);
+
+    auto result = bytecode.evaluate({100, 100, 100});
+    ASSERT_TRUE(result.return_value());
+    ASSERT_EQ(*result.return_value(), 2400000000);
+}
+
+TEST(Bytecode, testMatchesASTInterpreter) {
+    SourceCodeManagement management{"PARAM a, b, c;\n"
+                                    "VAR x, y, z;\n"
+                                    "CONST k = 7, m = 3;\n"
+                                    "BEGIN\n"
+                                    "  x := (+a - -b) + a / (c * c + 1);\n"
+                                    "  y := x * (x - k) - -(m * (b + 7));\n"
+                                    "  x := x + y / 3 - 7;\n"
+                                    "  z := -(-(-x)) * +(+y);\n"
+                                    "  RETURN z - x * (y + 7) / (k * k)\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    BytecodeCompiler compiler;
+    BytecodeFunction bytecode = compiler.compile(*function);
+
+    for (long long a = -6; a <= 6; a += 3) {
+        for (long long b = -5; b <= 5; b += 2) {
+            for (long long c = -4; c <= 4; ++c) {
+                auto expected = function->evaluate({a, b, c});
+                auto actual = bytecode.evaluate({a, b, c});
+
+                ASSERT_TRUE(expected.return_value());
+                ASSERT_TRUE(actual.return_value());
+                ASSERT_EQ(*actual.return_value(), *expected.return_value());
+            }
+        }
+    }
+}
+
+TEST(Bytecode, testDeadStatementsAfterReturn) {
+    SourceCodeManagement management{"PARAM a;\n"
+                                    "BEGIN\n"
+                                    "  RETURN a;\n"
+                                    "  RETURN a / 0\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    BytecodeCompiler compiler;
+    BytecodeFunction bytecode = compiler.compile(*function);
+    ASSERT_EQ(bytecode.getInstructions().size(), 1);
+
+    auto result = bytecode.evaluate({5});
+    ASSERT_TRUE(result.return_value());
+    ASSERT_EQ(*result.return_value(), 5);
+}
+
+TEST(Bytecode, testArgumentCount) {
+    {
+        SourceCodeManagement management{"PARAM a;\n"
+                                        "BEGIN\n"
+                                        "  RETURN a\n"
+                                        "END."};
+        Result<Function> function = buildAST(management);
+        ASSERT_TRUE(function.isSuccess());
+        BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+        EvaluationContext result = bytecode.evaluate({});
+        ASSERT_TRUE(result.runtime_error());
+        ASSERT_EQ(*result.runtime_error(), "Received to few arguments!");
+
+        result = bytecode.evaluate({1, 1});
+        ASSERT_TRUE(result.runtime_error());
+        ASSERT_EQ(*result.runtime_error(), "Received to many arguments!");
+    }
+    {
+        SourceCodeManagement management{"BEGIN\n"
+                                        "  RETURN 0\n"
+                                        "END."};
+        Result<Function> function = buildAST(management);
+        ASSERT_TRUE(function.isSuccess());
+        BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+        EvaluationContext result = bytecode.evaluate({1, 1});
+        ASSERT_TRUE(result.runtime_error());
+        ASSERT_EQ(*result.runtime_error(), "Provided arguments to function with missing PARAM declaration!");
+    }
+}
+
+TEST(Bytecode, testDivisionByZero) {
+    SourceCodeManagement management{"PARAM a;\n"
+                                    "VAR b;\n"
+                                    "BEGIN\n"
+                                    "  b := ((((1 / a) / 1) * 1) - 1) + 1;\n"
+                                    "  RETURN b\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+    BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+    EvaluationContext result = bytecode.evaluate({0});
+    ASSERT_FALSE(result.return_value());
+    ASSERT_TRUE(result.runtime_error());
+    ASSERT_EQ(*result.runtime_error(), "Division by zero!");
+
+    result = bytecode.evaluate({1});
+    ASSERT_TRUE(result.return_value());
+    ASSERT_EQ(*result.return_value(), 1);
+}
+
+TEST(Bytecode, testBatchEvaluation) {
+    SourceCodeManagement management{"PARAM a, b;\n"
+                                    "VAR c;\n"
+                                    "CONST k = 7;\n"
+                                    "BEGIN\n"
+                                    "  c := a * -b + k;\n"
+                                    "  c := c - (a + b) / (a - 3);\n"
+                                    "  RETURN c * 2 / b\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+    BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+    // spans multiple chunks and ends with a partial one
+    const std::size_t rows = 3 * BytecodeFunction::BATCH_CHUNK_SIZE + 17;
+    std::vector<long long> a(rows), b(rows), output(rows);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+    for (std::size_t row = 0; row < rows; ++row) {
+        a[row] = static_cast<long long>(row % 11);
+        b[row] = static_cast<long long>(row % 7) - 3;
+    }
+
+    std::vector<std::span<const long long>> columns{ a, b };
+    ASSERT_EQ(bytecode.evaluateBatch(columns, output, errors), RuntimeErrorCode::DIVISION_BY_ZERO);
+
+    for (std::size_t row = 0; row < rows; ++row) {
+        EvaluationContext expected = function->evaluate({a[row], b[row]});
+        bool failed = (errors[row / 64] >> (row % 64)) & 1;
+
+        ASSERT_EQ(failed, expected.runtime_error().has_value()) << "row " << row;
+        ASSERT_EQ(output[row], expected.return_value().value_or(0)) << "row " << row;
+    }
+
+    // no failing row
+    std::fill(b.begin(), b.end(), 1);
+    std::fill(a.begin(), a.end(), 4);
+    ASSERT_EQ(bytecode.evaluateBatch(columns, output, errors), RuntimeErrorCode::NONE);
+    ASSERT_TRUE(std::all_of(errors.begin(), errors.end(), [](std::uint64_t word) { return word == 0; }));
+    ASSERT_TRUE(std::all_of(output.begin(), output.end(), [](long long value) { return value == -4; }));
+
+    // wrong number of columns
+    std::vector<std::span<const long long>> single{ a };
+    ASSERT_EQ(bytecode.evaluateBatch(single, output, errors), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+}
+
+TEST(Bytecode, testConstantDivisor) {
+    constexpr long long min = std::numeric_limits<long long>::min();
+    constexpr long long max = std::numeric_limits<long long>::max();
+
+    ASSERT_FALSE(ConstantDivisor::create(0));
+
+    std::vector<long long> values{ 0, 1, 2, 3, 5, 6, 7, 10, 64, 100, 641, 1000000007, 9000000000, max - 1, max };
+    for (std::size_t index = 0, size = values.size(); index < size; ++index) {
+        values.push_back(-values[index]);
+    }
+    values.push_back(min);
+    values.push_back(min + 1);
+
+    for (long long divisor: values) {
+        if (divisor == 0) {
+            continue;
+        }
+        auto constant = ConstantDivisor::create(divisor);
+        ASSERT_TRUE(constant);
+        ASSERT_EQ(constant->getDivisor(), divisor);
+
+        for (long long dividend: values) {
+            if (dividend == min && divisor == -1) {
+                continue; // overflows
+            }
+            ASSERT_EQ(constant->divide(dividend), dividend / divisor) << dividend << " / " << divisor;
+        }
+    }
+}
+
+TEST(Bytecode, testBatchKernels) {
+    const std::size_t rows = 67; // not a multiple of any vector width
+    std::vector<long long> lhs(rows), rhs(rows);
+    for (std::size_t row = 0; row < rows; ++row) {
+        lhs[row] = (static_cast<long long>(row) - 30) * 123456789013;
+        rhs[row] = static_cast<long long>(row % 9) - 4 + (row % 5 == 0 ? 8000000000 : 0);
+    }
+
+    const BatchKernels& scalar = BatchKernels::get(KernelSet::SCALAR);
+    for (KernelSet kernel_set: { KernelSet::SCALAR, KernelSet::AVX2, KernelSet::AVX512 }) {
+        if (!BatchKernels::isSupported(kernel_set)) {
+            continue;
+        }
+        const BatchKernels& kernels = BatchKernels::get(kernel_set);
+        ASSERT_EQ(kernels.kernel_set, kernel_set);
+
+        std::vector<long long> expected(rows), actual(rows);
+        for (auto kernel: { &BatchKernels::add, &BatchKernels::subtract, &BatchKernels::multiply }) {
+            (scalar.*kernel)(expected.data(), lhs.data(), rhs.data(), rows);
+            (kernels.*kernel)(actual.data(), lhs.data(), rhs.data(), rows);
+            ASSERT_EQ(actual, expected);
+        }
+
+        scalar.negate(expected.data(), lhs.data(), rows);
+        kernels.negate(actual.data(), lhs.data(), rows);
+        ASSERT_EQ(actual, expected);
+
+        std::vector<unsigned char> expected_failed(rows), actual_failed(rows);
+        scalar.divide(expected.data(), lhs.data(), rhs.data(), expected_failed.data(), rows);
+        kernels.divide(actual.data(), lhs.data(), rhs.data(), actual_failed.data(), rows);
+        ASSERT_EQ(actual, expected);
+        ASSERT_EQ(actual_failed, expected_failed);
+        ASSERT_EQ(std::count(actual_failed.begin(), actual_failed.end(), 1), 6);
+
+        auto divisor = ConstantDivisor::create(-7);
+        kernels.divideConstant(actual.data(), lhs.data(), *divisor, rows);
+        for (std::size_t row = 0; row < rows; ++row) {
+            ASSERT_EQ(actual[row], lhs[row] / -7);
+        }
+
+        // in-place operation
+        actual = lhs;
+        kernels.add(actual.data(), actual.data(), rhs.data(), rows);
+        scalar.add(expected.data(), lhs.data(), rhs.data(), rows);
+        ASSERT_EQ(actual, expected);
+    }
+}
+
+TEST(Bytecode, testBatchEvaluationKernelSets) {
+    SourceCodeManagement management{"PARAM a, b;\n"
+                                    "VAR c;\n"
+                                    "CONST k = 7, zero = 0;\n"
+                                    "BEGIN\n"
+                                    "  c := a * -b + k;\n"
+                                    "  c := c / k - c / -3 + a / (b - 2);\n"
+                                    "  RETURN c * 2 / b + (a / (zero + 1))\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+    BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+    const std::size_t rows = BytecodeFunction::BATCH_CHUNK_SIZE + 13;
+    std::vector<long long> a(rows), b(rows), output(rows);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+    for (std::size_t row = 0; row < rows; ++row) {
+        a[row] = static_cast<long long>(row * 37 % 101) - 50;
+        b[row] = static_cast<long long>(row % 9) - 4;
+    }
+    std::vector<std::span<const long long>> columns{ a, b };
+
+    for (KernelSet kernel_set: { KernelSet::SCALAR, KernelSet::AVX2, KernelSet::AVX512 }) {
+        if (!BatchKernels::isSupported(kernel_set)) {
+            continue;
+        }
+        ASSERT_EQ(bytecode.evaluateBatch(columns, output, errors, BatchKernels::get(kernel_set)), RuntimeErrorCode::DIVISION_BY_ZERO);
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            EvaluationContext expected = function->evaluate({a[row], b[row]});
+            bool failed = (errors[row / 64] >> (row % 64)) & 1;
+
+            ASSERT_EQ(failed, expected.runtime_error().has_value()) << "row " << row;
+            ASSERT_EQ(output[row], expected.return_value().value_or(0)) << "row " << row;
+        }
+    }
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/CodeCache.hpp"
+#include "pljit/CompiledFunction.hpp"
+#include "pljit/bytecode/BytecodeCompiler.hpp"
+#include "pljit/bytecode/BytecodeSerializer.hpp"
+#include "pljit/pljit.hpp"
+#include "test/utils/ast_utils.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::code;
+using namespace pljit::bytecode;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/**
+ * A fresh directory below the temporary directory, removed on destruction.
+ */
+class TemporaryDirectory {
+    std::filesystem::path path;
+
+    public:
+    TemporaryDirectory() {
+        const auto* test = testing::UnitTest::GetInstance()->current_test_info();
+        path = std::filesystem::temp_directory_path() / ("pljit-" + std::to_string(getpid()) + "-" + test->name());
+        std::filesystem::remove_all(path);
+    }
+    ~TemporaryDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    const std::filesystem::path& get() const {
+        return path;
+    }
+};
+
+const char* const SOURCE = "PARAM a, b;\n"
+                           "VAR c;\n"
+                           "CONST k = 7;\n"
+                           "BEGIN\n"
+                           "  c := a * k - b;\n"
+                           "  RETURN c / (b - 2)\n"
+                           "END.";
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(CodeCache, testSerializationRoundTrip) {
+    SourceCodeManagement management{ SOURCE };
+    Result<ast::Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+    BytecodeFunction bytecode = BytecodeCompiler{}.compile(*function);
+
+    std::vector<std::uint8_t> data = BytecodeSerializer::serialize(bytecode, management);
+    std::optional<BytecodeFunction> restored = BytecodeSerializer::deserialize(data, management);
+    ASSERT_TRUE(restored);
+
+    ASSERT_EQ(restored->getInitialRegisters(), bytecode.getInitialRegisters());
+    ASSERT_EQ(restored->getParameterRegisters(), bytecode.getParameterRegisters());
+    ASSERT_EQ(restored->getDivisionReferences(), bytecode.getDivisionReferences());
+    ASSERT_EQ(restored->getInstructions().size(), bytecode.getInstructions().size());
+    ASSERT_EQ(*restored->evaluate({ 3, 4 }).return_value(), 8);
+
+    EvaluationContext error = restored->evaluate({ 3, 2 });
+    ASSERT_EQ(error.runtime_error_code(), RuntimeErrorCode::DIVISION_BY_ZERO);
+    ASSERT_EQ(*error.result().reference(), "c / (b - 2)");
+
+    // every truncation is rejected
+    for (std::size_t size = 0; size < data.size(); ++size) {
+        ASSERT_FALSE(BytecodeSerializer::deserialize(std::span{ data.data(), size }, management)) << size;
+    }
+    // out of bounds register
+    std::vector<std::uint8_t> corrupt = data;
+    corrupt[20 + 4] = 0xff;
+    ASSERT_FALSE(BytecodeSerializer::deserialize(corrupt, management));
+}
+
+TEST(CodeCache, testLoadAndStore) {
+    TemporaryDirectory directory;
+    CodeCache cache{ directory.get() };
+
+    SourceCodeManagement management{ SOURCE };
+    ASSERT_FALSE(cache.load(management, OptimizationLevel::O2));
+
+    auto compiled = CompiledFunction::compile(SOURCE, ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+    ASSERT_FALSE(compiled->isLoadedFromCodeCache());
+    ASSERT_TRUE(std::filesystem::exists(cache.entryPath(SOURCE, OptimizationLevel::O2)));
+    ASSERT_FALSE(std::filesystem::exists(cache.entryPath(SOURCE, OptimizationLevel::O1)));
+
+    for (auto mode: { ExecutionMode::BYTECODE, ExecutionMode::NATIVE }) {
+        auto loaded = CompiledFunction::compile(SOURCE, mode, OptimizationLevel::O2, &cache);
+        ASSERT_TRUE(loaded->isLoadedFromCodeCache());
+        ASSERT_FALSE(loaded->getFunction());
+        ASSERT_TRUE(loaded->getBytecode());
+        ASSERT_EQ(*loaded->getBytecode()->evaluate({ 3, 4 }).return_value(), 8);
+    }
+
+    // the interpreter requires the AST
+    ASSERT_FALSE(CompiledFunction::compile(SOURCE, ExecutionMode::AST_INTERPRETER, OptimizationLevel::O2, &cache)->isLoadedFromCodeCache());
+
+    // compilation errors aren't cached
+    auto broken = CompiledFunction::compile("BEGIN RETURN a END.", ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+    ASSERT_TRUE(broken->compilation_error());
+    ASSERT_FALSE(std::filesystem::exists(cache.entryPath("BEGIN RETURN a END.", OptimizationLevel::O2)));
+}
+
+TEST(CodeCache, testCorruptEntry) {
+    TemporaryDirectory directory;
+    CodeCache cache{ directory.get() };
+    auto path = cache.entryPath(SOURCE, OptimizationLevel::O2);
+
+    CompiledFunction::compile(SOURCE, ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+    auto size = std::filesystem::file_size(path);
+
+    // a truncated entry is a cache miss and gets replaced
+    std::filesystem::resize_file(path, size - 3);
+    auto recompiled = CompiledFunction::compile(SOURCE, ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+    ASSERT_FALSE(recompiled->isLoadedFromCodeCache());
+    ASSERT_EQ(std::filesystem::file_size(path), size);
+
+    // an entry of another source with the same name is rejected by the header
+    {
+        std::fstream stream{ path, std::ios::in | std::ios::out | std::ios::binary };
+        stream.seekp(28); // low byte of the source length
+        stream.put('\x01');
+    }
+    ASSERT_FALSE(CompiledFunction::compile(SOURCE, ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache)->isLoadedFromCodeCache());
+}
+
+TEST(CodeCache, testHashCollision) {
+    TemporaryDirectory directory;
+    CodeCache cache{ directory.get() };
+    CompiledFunction::compile(SOURCE, ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+
+    // pretends that another source code of the same length has the same hash
+    std::string other{ SOURCE };
+    other.replace(other.find("k = 7"), 5, "k = 9");
+    auto path = cache.entryPath(other, OptimizationLevel::O2);
+    std::filesystem::copy_file(cache.entryPath(SOURCE, OptimizationLevel::O2), path);
+    {
+        std::fstream stream{ path, std::ios::in | std::ios::out | std::ios::binary };
+        stream.seekp(20); // the source hash
+        std::uint64_t hash = CodeCache::hash(other);
+        for (unsigned index = 0; index < 8; ++index) {
+            stream.put(static_cast<char>(hash >> (8 * index)));
+        }
+    }
+
+    SourceCodeManagement management{ std::string{ other } };
+    ASSERT_FALSE(cache.load(management, OptimizationLevel::O2));
+    auto compiled = CompiledFunction::compile(std::move(other), ExecutionMode::BYTECODE, OptimizationLevel::O2, &cache);
+    ASSERT_FALSE(compiled->isLoadedFromCodeCache());
+    ASSERT_EQ(*compiled->getBytecode()->evaluate({ 3, 4 }).return_value(), 11);
+}
+
+TEST(CodeCache, testRestart) {
+    TemporaryDirectory directory;
+
+    for (unsigned run = 0; run < 2; ++run) {
+        Pljit pljit{ { .code_cache_directory = directory.get() } };
+        auto function = pljit.registerFunction(SOURCE);
+        ASSERT_EQ(function(3, 4), 8);
+
+        // only the first run executes the optimization passes
+        ASSERT_EQ(function.optimization_statistics().empty(), run == 1);
+    }
+}
+//---------------------------------------------------------------------------
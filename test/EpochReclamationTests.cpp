@@ -0,0 +1,98 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/util/EpochReclamation.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <thread>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+struct Tracked {
+    std::atomic<unsigned>& destroyed;
+
+    explicit Tracked(std::atomic<unsigned>& destroyed) : destroyed(destroyed) {}
+    ~Tracked() {
+        ++destroyed;
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(EpochReclamation, testReclaimWithoutReaders) {
+    std::atomic<unsigned> destroyed{ 0 };
+    RetireList list;
+
+    for (unsigned index = 0; index < 100; ++index) {
+        list.retire(new Tracked{ destroyed });
+        // every retire advances the epoch, objects are destroyed two epochs later
+        ASSERT_LE(list.pending(), 2);
+    }
+    ASSERT_EQ(destroyed.load() + list.pending(), 100);
+}
+
+TEST(EpochReclamation, testDeferredWhilePinned) {
+    std::atomic<unsigned> destroyed{ 0 };
+    RetireList list;
+
+    std::promise<void> pinned;
+    std::promise<void> release;
+    std::thread reader([&]() {
+        EpochGuard guard;
+        pinned.set_value();
+        release.get_future().wait();
+    });
+    pinned.get_future().wait();
+
+    for (unsigned index = 0; index < 16; ++index) {
+        list.retire(new Tracked{ destroyed });
+    }
+    ASSERT_EQ(destroyed.load(), 0);
+    ASSERT_EQ(list.pending(), 16);
+
+    release.set_value();
+    reader.join();
+
+    list.retire(new Tracked{ destroyed });
+    list.retire(new Tracked{ destroyed });
+    ASSERT_GE(destroyed.load(), 16);
+}
+
+TEST(EpochReclamation, testNestedGuards) {
+    std::atomic<unsigned> destroyed{ 0 };
+    RetireList list;
+
+    {
+        EpochGuard outer;
+        {
+            EpochGuard inner;
+        }
+        // still pinned by the outer guard
+        for (unsigned index = 0; index < 8; ++index) {
+            list.retire(new Tracked{ destroyed });
+        }
+        ASSERT_EQ(destroyed.load(), 0);
+    }
+
+    list.retire(new Tracked{ destroyed });
+    list.retire(new Tracked{ destroyed });
+    ASSERT_GE(destroyed.load(), 8);
+}
+
+TEST(EpochReclamation, testDestroyPending) {
+    std::atomic<unsigned> destroyed{ 0 };
+    {
+        RetireList list;
+        EpochGuard guard;
+        list.retire(new Tracked{ destroyed });
+        list.retire(new Tracked{ destroyed });
+        ASSERT_EQ(destroyed.load(), 0);
+    }
+    ASSERT_EQ(destroyed.load(), 2);
+}
+//---------------------------------------------------------------------------
@@ -2,6 +2,8 @@
 #include "pljit/lang.hpp"
 #include "pljit/lex/Lexer.hpp"
 #include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
 #include "./utils/assert_macros.hpp"
 //---------------------------------------------------------------------------
 using namespace pljit;
@@ -378,3 +380,115 @@ TEST(Lexer, testPeekNext) {
     result = lexer.peek_next();
     ASSERT_TOKEN(result, Token::Type::IDENTIFIER, "width");
 }
+
+TEST(Lexer, testPackedTokens) {
+    SourceCodeManagement management{ "x := 12;\n  RETURN x" };
+    Lexer lexer{ management };
+
+    std::span<const PackedToken> tokens = lexer.packed_tokens();
+    ASSERT_EQ(tokens.size(), 7);
+
+    std::vector<std::tuple<unsigned, unsigned, Token::Type>> expected{
+        { 0, 1, Token::Type::IDENTIFIER },
+        { 2, 2, Token::Type::OPERATOR },
+        { 5, 2, Token::Type::LITERAL },
+        { 7, 1, Token::Type::SEPARATOR },
+        { 11, 6, Token::Type::KEYWORD },
+        { 18, 1, Token::Type::IDENTIFIER },
+        { 19, 0, Token::Type::EMPTY },
+    };
+    for (std::size_t index = 0; index < expected.size(); ++index) {
+        EXPECT_EQ(tokens[index].offset, std::get<0>(expected[index]));
+        EXPECT_EQ(tokens[index].length, std::get<1>(expected[index]));
+        EXPECT_EQ(tokens[index].type, std::get<2>(expected[index]));
+    }
+}
+
+TEST(Lexer, testLongRuns) {
+    std::string identifier = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string literal = "1234567890123456789";
+    std::string program = identifier + std::string(40, ' ') + "\n\t" + literal + std::string(17, '\t');
+    SourceCodeManagement management{ std::move(program) };
+    Lexer lexer{ management };
+
+    Result<Token> result;
+
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, identifier);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::LITERAL, literal);
+    ASSERT_TRUE(lexer.endOfStream());
+}
+
+TEST(Lexer, testIllegalCharacterAfterLongRun) {
+    // the `@` and `[` lie right beside the letter ranges and must end an identifier.
+    std::string program = "abcdefghijklmnopqrstu@";
+    SourceCodeManagement management{ std::move(program) };
+    Lexer lexer{ management };
+
+    Result<Token> result = lexer.consume_next();
+    ASSERT_SRC_ERROR(result, CodePosition(1, 22), "Unexpected character!", "@");
+    ASSERT_FALSE(lexer.endOfStream());
+    ASSERT_EQ(*lexer.cur_position(), 'a');
+
+    SourceCodeManagement other{ "BEGIN abcdefghijklmnopqrstuvwxyz[" };
+    Lexer otherLexer{ other };
+
+    ASSERT_NEXT_TOKEN(otherLexer, result, Token::Type::KEYWORD, Keyword::BEGIN);
+    result = otherLexer.consume_next();
+    ASSERT_SRC_ERROR(result, CodePosition(1, 33), "Unexpected character!", "[");
+}
+
+TEST(Lexer, testKeywordLookalikes) {
+    SourceCodeManagement management{ "PARAM PARAMS VAR VA CONST Const BEGIN BEGINN END EN RETURN RETURNS" };
+    Lexer lexer{ management };
+
+    Result<Token> result;
+
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::PARAM);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "PARAMS");
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::VAR);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "VA");
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::CONST);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "Const");
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::BEGIN);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "BEGINN");
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::END);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "EN");
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::KEYWORD, Keyword::RETURN);
+    ASSERT_NEXT_TOKEN(lexer, result, Token::Type::IDENTIFIER, "RETURNS");
+    ASSERT_TRUE(lexer.endOfStream());
+}
+
+TEST(Lexer, testInternedIdentifiers) {
+    std::string program = "a := b + a * ab;";
+    for (unsigned index = 0; index < 64; ++index) {
+        program += " v" + std::string(index % 26 + 1, static_cast<char>('a' + index % 26)) + std::string(index / 26 + 1, 'x');
+    }
+    SourceCodeManagement management{ std::move(program) };
+    Lexer lexer{ management };
+
+    lex::identifier_id a = lexer.next().getIdentifier();
+    lexer.advance();
+    lex::identifier_id b = lexer.next().getIdentifier();
+    lexer.advance();
+    EXPECT_EQ(lexer.next().getIdentifier(), a);
+    lexer.advance();
+    lex::identifier_id ab = lexer.next().getIdentifier();
+
+    EXPECT_NE(a, b);
+    EXPECT_NE(a, ab);
+    EXPECT_NE(b, ab);
+
+    const IdentifierTable& identifiers = lexer.identifier_table();
+    EXPECT_EQ(identifiers.name(a), "a");
+    EXPECT_EQ(identifiers.name(b), "b");
+    EXPECT_EQ(identifiers.name(ab), "ab");
+    // the table has to grow multiple times for the remaining identifiers
+    ASSERT_EQ(identifiers.size(), 3 + 64);
+
+    lexer.advance();
+    for (lex::identifier_id id = 3; id < identifiers.size(); ++id) {
+        Token token = lexer.next();
+        EXPECT_EQ(token.getIdentifier(), id);
+        EXPECT_EQ(identifiers.name(id), *token.reference());
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/MemoizationCache.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Memoizes the sum of the arguments, counting the evaluations.
+EvaluationResult memoizeSum(MemoizationCache& cache, std::vector<long long> arguments, unsigned& evaluations) {
+    return cache.memoize(arguments, [&]() {
+        ++evaluations;
+        long long sum = 0;
+        for (long long argument: arguments) {
+            sum += argument;
+        }
+        return EvaluationResult::success(sum);
+    });
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(MemoizationCache, testHitsAndMisses) {
+    MemoizationCache cache{ 2, 64 * 1024 };
+    unsigned evaluations = 0;
+
+    EXPECT_EQ(memoizeSum(cache, { 1, 2 }, evaluations).value(), 3);
+    EXPECT_EQ(memoizeSum(cache, { 1, 2 }, evaluations).value(), 3);
+    EXPECT_EQ(memoizeSum(cache, { 2, 1 }, evaluations).value(), 3);
+    EXPECT_EQ(memoizeSum(cache, { 2, 1 }, evaluations).value(), 3);
+    EXPECT_EQ(evaluations, 2);
+
+    // calls with a different arity are neither cached nor counted
+    EXPECT_EQ(memoizeSum(cache, { 1 }, evaluations).value(), 1);
+    EXPECT_EQ(memoizeSum(cache, { 1 }, evaluations).value(), 1);
+    EXPECT_EQ(evaluations, 4);
+
+    MemoizationStatistics statistics = cache.statistics();
+    EXPECT_EQ(statistics.hits, 2);
+    EXPECT_EQ(statistics.misses, 2);
+    EXPECT_EQ(statistics.evictions, 0);
+    EXPECT_EQ(statistics.entries, 2);
+    EXPECT_NEAR(statistics.hit_rate(), 0.5, 0.001);
+    EXPECT_LE(statistics.memory_bytes, 64 * 1024);
+    EXPECT_EQ(statistics.memory_bytes, statistics.capacity * MemoizationCache::entrySize(2));
+}
+
+TEST(MemoizationCache, testRuntimeErrors) {
+    MemoizationCache cache{ 1, 64 * 1024 };
+    unsigned evaluations = 0;
+    auto divide = [&](long long divisor) {
+        std::vector<long long> arguments{ divisor };
+        return cache.memoize(arguments, [&]() {
+            ++evaluations;
+            return divisor == 0 ? EvaluationResult::failure(RuntimeErrorCode::DIVISION_BY_ZERO) : EvaluationResult::success(12 / divisor);
+        });
+    };
+
+    EXPECT_EQ(divide(0).error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+    EXPECT_EQ(divide(0).error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+    EXPECT_EQ(divide(4).value(), 3);
+    EXPECT_EQ(evaluations, 2);
+}
+
+TEST(MemoizationCache, testClockEviction) {
+    MemoizationCache cache{ 1, 4 * MemoizationCache::entrySize(1) };
+    ASSERT_EQ(cache.statistics().capacity, 4);
+    unsigned evaluations = 0;
+
+    for (long long argument = 0; argument < 4; ++argument) {
+        memoizeSum(cache, { argument }, evaluations);
+    }
+    // 0 and 2 get a second chance, the hand evicts 1 and then 3
+    memoizeSum(cache, { 0 }, evaluations);
+    memoizeSum(cache, { 2 }, evaluations);
+    memoizeSum(cache, { 4 }, evaluations);
+    memoizeSum(cache, { 5 }, evaluations);
+    ASSERT_EQ(evaluations, 6);
+
+    memoizeSum(cache, { 0 }, evaluations);
+    memoizeSum(cache, { 2 }, evaluations);
+    memoizeSum(cache, { 4 }, evaluations);
+    memoizeSum(cache, { 5 }, evaluations);
+    EXPECT_EQ(evaluations, 6);
+    memoizeSum(cache, { 1 }, evaluations);
+    EXPECT_EQ(evaluations, 7);
+
+    MemoizationStatistics statistics = cache.statistics();
+    EXPECT_EQ(statistics.evictions, 3);
+    EXPECT_EQ(statistics.entries, 4);
+}
+
+TEST(MemoizationCache, testEvictionKeepsIndexConsistent) {
+    // eviction removes entries from the middle of probe sequences, every cached result must still be found
+    MemoizationCache cache{ 2, 300 * MemoizationCache::entrySize(2) };
+    std::mt19937_64 random{ 42 };
+    std::uniform_int_distribution<long long> values{ 0, 600 };
+
+    for (unsigned call = 0; call < 20'000; ++call) {
+        long long a = values(random);
+        long long b = values(random) % 3;
+        std::vector<long long> arguments{ a, b };
+        EvaluationResult result = cache.memoize(arguments, [&]() { return EvaluationResult::success(a * 3 + b); });
+        ASSERT_EQ(result.value(), a * 3 + b);
+    }
+
+    MemoizationStatistics statistics = cache.statistics();
+    EXPECT_EQ(statistics.entries, statistics.capacity);
+    EXPECT_EQ(statistics.hits + statistics.misses, 20'000);
+    EXPECT_EQ(statistics.misses - statistics.evictions, statistics.entries);
+}
+
+TEST(MemoizationCache, testMultiThreaded) {
+    MemoizationCache cache{ 2, 1024 * MemoizationCache::entrySize(2) };
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+    for (long long thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (long long call = 0; call < 5000; ++call) {
+                // overlapping argument tuples, some of which are evaluated concurrently
+                long long a = (call * 7 + thread) % 2000;
+                std::vector<long long> arguments{ a, -a };
+                EvaluationResult result = cache.memoize(arguments, [&]() { return EvaluationResult::success(a * 2); });
+                if (!result || result.value() != a * 2) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    MemoizationStatistics statistics = cache.statistics();
+    EXPECT_EQ(statistics.hits + statistics.misses, 20'000);
+    EXPECT_LE(statistics.entries, statistics.capacity);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,196 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/ast/AST.hpp"
+#include "pljit/bytecode/BytecodeCompiler.hpp"
+#include "pljit/native/NativeCompiler.hpp"
+#include "pljit/native/X86Assembler.hpp"
+#include "test/utils/ast_utils.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+using namespace pljit::code;
+using namespace pljit::ast;
+using namespace pljit::native;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+std::optional<NativeFunction> compileNative(const Function& function) {
+    bytecode::BytecodeFunction bytecode = bytecode::BytecodeCompiler{}.compile(function);
+    return NativeCompiler{}.compile(bytecode);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(Native, testInstructionEncoding) {
+    X86Assembler assembler;
+    X86Assembler::Label label = assembler.createLabel();
+
+    assembler.mov(Reg::RAX, Reg::R12);                 // 49 8b c4
+    assembler.mov(Reg::R9, Memory{ Reg::RSP, 8 });     // 4c 8b 8c 24 08 00 00 00
+    assembler.mov(Memory{ Reg::RSI, 0 }, Reg::RAX);    // 48 89 86 00 00 00 00
+    assembler.imul(Reg::RBX, Reg::R15);                // 49 0f af df
+    assembler.sub(Reg::RSP, 16);                       // 48 81 ec 10 00 00 00
+    assembler.jz(label);                               // 0f 84 01 00 00 00
+    assembler.push(Reg::R13);                          // 41 55
+    assembler.bind(label);
+    assembler.ret();                                   // c3
+
+    std::vector<std::uint8_t> expected{
+        0x49, 0x8b, 0xc4,
+        0x4c, 0x8b, 0x8c, 0x24, 0x08, 0x00, 0x00, 0x00,
+        0x48, 0x89, 0x86, 0x00, 0x00, 0x00, 0x00,
+        0x49, 0x0f, 0xaf, 0xdf,
+        0x48, 0x81, 0xec, 0x10, 0x00, 0x00, 0x00,
+        0x0f, 0x84, 0x02, 0x00, 0x00, 0x00,
+        0x41, 0x55,
+        0xc3,
+    };
+    ASSERT_EQ(assembler.finalize(), expected);
+}
+
+TEST(Native, testExampleProgram) {
+    SourceCodeManagement management{"PARAM width, height, depth;\n"
+                                    "VAR volume;\n"
+                                    "CONST density = 2400;\n"
+                                    "BEGIN\n"
+                                    "  volume := width * height * depth;\n"
+                                    "  RETURN density * volume\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    auto native = compileNative(*function);
+    ASSERT_TRUE(native);
+
+    auto result = native->evaluate({100, 100, 100});
+    ASSERT_TRUE(result.return_value());
+    ASSERT_EQ(*result.return_value(), 2400000000);
+}
+
+TEST(Native, testMatchesASTInterpreter) {
+    SourceCodeManagement management{"PARAM a, b, c;\n"
+                                    "VAR x, y, z;\n"
+                                    "CONST k = 7, m = 3, huge = 9000000000;\n"
+                                    "BEGIN\n"
+                                    "  x := (+a - -b) + a / (c * c + 1);\n"
+                                    "  y := x * (x - k) - -(m * (b + 7));\n"
+                                    "  x := x + y / 3 - 7;\n"
+                                    "  z := -(-(-x)) * +(+y) + huge;\n"
+                                    "  z := z - huge * 2 + z / 5000000000;\n"
+                                    "  RETURN z - x * (y + 7) / (k * k)\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    auto native = compileNative(*function);
+    ASSERT_TRUE(native);
+
+    for (long long a = -6; a <= 6; a += 3) {
+        for (long long b = -5; b <= 5; b += 2) {
+            for (long long c = -4; c <= 4; ++c) {
+                auto expected = function->evaluate({a, b, c});
+                auto actual = native->evaluate({a, b, c});
+
+                ASSERT_TRUE(expected.return_value());
+                ASSERT_TRUE(actual.return_value());
+                ASSERT_EQ(*actual.return_value(), *expected.return_value());
+            }
+        }
+    }
+}
+
+TEST(Native, testRegisterSpilling) {
+    // more live variables than allocatable machine registers
+    std::string source = "PARAM p;\nVAR ";
+    for (unsigned index = 0; index < 20; ++index) {
+        source += (index ? ", v" : "v") + std::string(1, static_cast<char>('a' + index));
+    }
+    source += ";\nBEGIN\n  va := p;\n";
+    for (unsigned index = 1; index < 20; ++index) {
+        std::string previous = "v" + std::string(1, static_cast<char>('a' + index - 1));
+        source += "  v" + std::string(1, static_cast<char>('a' + index)) + " := " + previous + " * 3 - " + previous + " / (p + 1);\n";
+    }
+    source += "  RETURN va + vb + vc + vd + ve + vf + vg + vh + vi + vj + vk + vl + vm + vn + vo + vp + vq + vr + vs + vt\nEND.";
+
+    SourceCodeManagement management{ std::move(source) };
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    auto native = compileNative(*function);
+    ASSERT_TRUE(native);
+
+    for (long long p: {1, 2, 3, 17, -5}) {
+        auto expected = function->evaluate({p});
+        auto actual = native->evaluate({p});
+
+        ASSERT_TRUE(expected.return_value());
+        ASSERT_TRUE(actual.return_value());
+        ASSERT_EQ(*actual.return_value(), *expected.return_value());
+    }
+}
+
+TEST(Native, testDivisionByZero) {
+    {
+        SourceCodeManagement management{"PARAM a, b;\n"
+                                        "VAR c;\n"
+                                        "BEGIN\n"
+                                        "  c := a / b;\n"
+                                        "  RETURN (c + 1) / (a - 3)\n"
+                                        "END."};
+        Result<Function> function = buildAST(management);
+        ASSERT_TRUE(function.isSuccess());
+
+        auto native = compileNative(*function);
+        ASSERT_TRUE(native);
+
+        for (auto& arguments: std::vector<std::vector<long long>>{{1, 0}, {3, 1}}) {
+            EvaluationContext result = native->evaluate(arguments);
+            ASSERT_FALSE(result.return_value());
+            ASSERT_TRUE(result.runtime_error());
+            ASSERT_EQ(*result.runtime_error(), "Division by zero!");
+        }
+
+        EvaluationContext result = native->evaluate({8, 2});
+        ASSERT_TRUE(result.return_value());
+        ASSERT_EQ(*result.return_value(), 1);
+    }
+    {
+        SourceCodeManagement management{"BEGIN\n"
+                                        "  RETURN 1 / 0\n"
+                                        "END."};
+        Result<Function> function = buildAST(management);
+        ASSERT_TRUE(function.isSuccess());
+
+        auto native = compileNative(*function);
+        ASSERT_TRUE(native);
+
+        EvaluationContext result = native->evaluate({});
+        ASSERT_TRUE(result.runtime_error());
+        ASSERT_EQ(*result.runtime_error(), "Division by zero!");
+    }
+}
+
+TEST(Native, testArgumentCount) {
+    SourceCodeManagement management{"PARAM a;\n"
+                                    "BEGIN\n"
+                                    "  RETURN a\n"
+                                    "END."};
+    Result<Function> function = buildAST(management);
+    ASSERT_TRUE(function.isSuccess());
+
+    auto native = compileNative(*function);
+    ASSERT_TRUE(native);
+
+    EvaluationContext result = native->evaluate({});
+    ASSERT_TRUE(result.runtime_error());
+    ASSERT_EQ(*result.runtime_error(), "Received to few arguments!");
+
+    result = native->evaluate({1, 1});
+    ASSERT_TRUE(result.runtime_error());
+    ASSERT_EQ(*result.runtime_error(), "Received to many arguments!");
+}
+//---------------------------------------------------------------------------
@@ -3,9 +3,15 @@
 //
 
 #include "pljit/pljit.hpp"
+#include "pljit/CompileCache.hpp"
+#include "pljit/EvaluationContext.hpp"
 #include "./utils/assert_macros.hpp"
 #include "./utils/CaptureCOut.hpp"
+#include "./utils/CountAllocations.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <thread>
 
@@ -32,6 +38,130 @@ TEST(Pljit, testExampleProgram) {
     ASSERT_EQ(*result, 2400000000);
 }
 
+TEST(Pljit, testExecutionModes) {
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto func = pljit.registerFunction("PARAM a, b;\n"
+                                           "VAR c;\n"
+                                           "BEGIN\n"
+                                           "  c := a * -b + 3;\n"
+                                           "  RETURN c / a\n"
+                                           "END.", { .execution_mode = mode });
+
+        auto result = func(4, 5);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(*result, -4);
+
+        CaptureCOut capture;
+        result = func(0, 5);
+        capture.stopCapture();
+
+        ASSERT_FALSE(result);
+        ASSERT_EQ(capture.str(), "Division by zero!\n");
+    }
+}
+
+TEST(Pljit, testOptimizationLevels) {
+    Pljit pljit;
+
+    for (auto level: {OptimizationLevel::O0, OptimizationLevel::O1, OptimizationLevel::O2}) {
+        auto func = pljit.registerFunction("PARAM a;\n"
+                                           "VAR b;\n"
+                                           "CONST c = 4;\n"
+                                           "BEGIN\n"
+                                           "  b := c * c - 1;\n"
+                                           "  RETURN (a * b - a * c) * 2 + (b * a - c * a);\n"
+                                           "  RETURN a\n"
+                                           "END.", { .optimization_level = level });
+
+        auto result = func(3);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(*result, 99);
+
+        auto statistics = func.optimization_statistics();
+        ASSERT_EQ(statistics.empty(), level == OptimizationLevel::O0);
+        for (auto& statistic: statistics) {
+            ASSERT_GT(statistic.runs, 0);
+            ASSERT_GT(statistic.removed_nodes, 0);
+        }
+    }
+}
+
+TEST(Pljit, testAllocationFreeEvaluation) {
+    // exceeds the inline storage of the `EvaluationContext`
+    constexpr std::size_t variables = EvaluationContext::INLINE_CAPACITY + 6;
+    auto name = [](std::size_t index) {
+        return "v" + std::string(1, static_cast<char>('a' + index / 26)) + static_cast<char>('a' + index % 26);
+    };
+
+    std::string large_source = "PARAM p;\nVAR ";
+    std::string sum;
+    for (std::size_t index = 0; index < variables; ++index) {
+        large_source += (index ? ", " : "") + name(index);
+        sum += (index ? " + " : "") + name(index);
+    }
+    large_source += ";\nBEGIN\n";
+    for (std::size_t index = 0; index < variables; ++index) {
+        large_source += "  " + name(index) + " := p * " + std::to_string(index) + ";\n";
+    }
+    large_source += "  RETURN " + sum + "\nEND.";
+
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto small = pljit.registerFunction("PARAM a, b;\n"
+                                            "VAR c;\n"
+                                            "CONST d = 3;\n"
+                                            "BEGIN\n"
+                                            "  c := a * b + d;\n"
+                                            "  RETURN c / a\n"
+                                            "END.", { .execution_mode = mode });
+        auto large = pljit.registerFunction(std::string{ large_source }, { .execution_mode = mode });
+
+        std::vector<long long> arguments{ 4, 5 };
+
+        // compiles the functions and warms up the evaluation context of this thread
+        ASSERT_EQ(small(4, 5), 5);
+        ASSERT_EQ(large(2), 4830);
+
+        CountAllocations allocations;
+        for (unsigned iteration = 0; iteration < 16; ++iteration) {
+            ASSERT_EQ(small(4, 5), 5);
+            ASSERT_EQ(small(std::span<const long long>{ arguments }), 5);
+            ASSERT_EQ(large(2), 4830);
+        }
+        ASSERT_EQ(allocations.count(), 0);
+    }
+}
+
+TEST(Pljit, testBatchEvaluation) {
+    Pljit pljit;
+
+    std::vector<long long> a{ 4, 3, 0, 8, -5 };
+    std::vector<long long> b{ 5, 1, 2, 2, 7 };
+    std::vector<long long> output(a.size());
+    std::vector<std::uint64_t> errors(1);
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto func = pljit.registerFunction("PARAM a, b;\n"
+                                           "VAR c;\n"
+                                           "BEGIN\n"
+                                           "  c := a * -b + 3;\n"
+                                           "  RETURN c / (a - 3)\n"
+                                           "END.", { .execution_mode = mode });
+
+        ASSERT_EQ(func.evaluateBatch({ a, b }, output, errors), RuntimeErrorCode::DIVISION_BY_ZERO);
+        ASSERT_EQ(output, std::vector<long long>({ -17, 0, -1, -2, -4 }));
+        ASSERT_EQ(errors[0], 0b10);
+
+        ASSERT_EQ(func.evaluateBatch({ a }, output, errors), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+    }
+
+    auto func = pljit.registerFunction("VAR a; BEGIN RETURN a END.");
+    ASSERT_EQ(func.evaluateBatch({}, output, errors), RuntimeErrorCode::COMPILATION_ERROR);
+}
+
 TEST(Pljit, testMultiThreadedExecution) {
     Pljit pljit;
     auto func = pljit.registerFunction("PARAM width, height, depth;\n"
@@ -147,14 +277,752 @@ TEST(Pljit, testMultiThreadedRegistration) {
         thread.join();
     }
 
-    std::size_t count = 0;
-    auto head = pljit.list_head;
-    while (head != nullptr) {
-        ++count;
-        head = head->next;
+    ASSERT_EQ(pljit.registry.size(), 8);
+    ASSERT_EQ(pljit.functions().size(), 8);
+}
+
+TEST(Pljit, testLookup) {
+    Pljit pljit;
+
+    auto unnamed = pljit.registerFunction("BEGIN RETURN 0 END.");
+    auto square = pljit.registerNamedFunction("square", "PARAM a; BEGIN RETURN a * a END.");
+    auto negate = pljit.registerNamedFunction("negate", "PARAM a; BEGIN RETURN -a END.");
+    ASSERT_TRUE(square.has_value());
+    ASSERT_TRUE(negate.has_value());
+
+    // names are unique
+    ASSERT_FALSE(pljit.registerNamedFunction("square", "BEGIN RETURN 1 END.").has_value());
+
+    EXPECT_EQ(unnamed.name(), "");
+    EXPECT_EQ(square->name(), "square");
+
+    auto found = pljit.lookup("square");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->id(), square->id());
+    EXPECT_EQ((*found)(3), 9);
+
+    found = pljit.lookup(negate->id());
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->name(), "negate");
+    EXPECT_EQ((*found)(3), -3);
+
+    EXPECT_FALSE(pljit.lookup("cube").has_value());
+    EXPECT_FALSE(pljit.lookup(function_id{ 42 }).has_value());
+
+    std::vector<PljitFunctionHandle> functions = pljit.functions();
+    ASSERT_EQ(functions.size(), 3);
+    EXPECT_EQ(functions[0].id(), unnamed.id());
+    EXPECT_EQ(functions[1].id(), square->id());
+    EXPECT_EQ(functions[2].id(), negate->id());
+}
+
+TEST(Pljit, testMultiThreadedLookup) {
+    Pljit pljit{ { .compile_cache_mode = CompileCacheMode::DISABLED } };
+
+    // enough functions to span multiple segments of the registry and to grow the name tables
+    unsigned thread_count = 4;
+    unsigned functions_per_thread = 1000;
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+
+    for (unsigned thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (unsigned index = 0; index < functions_per_thread; ++index) {
+                std::string name = "f" + std::to_string(thread) + "_" + std::to_string(index);
+                auto handle = pljit.registerNamedFunction(name, "BEGIN RETURN " + std::to_string(index) + " END.");
+                if (!handle) {
+                    failed = true;
+                    continue;
+                }
+
+                // concurrently look up a function registered by this thread before
+                std::string previous = "f" + std::to_string(thread) + "_" + std::to_string(index / 2);
+                auto found = pljit.lookup(previous);
+                if (!found || found->name() != previous) {
+                    failed = true;
+                }
+            }
+        });
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    ASSERT_EQ(pljit.functions().size(), thread_count * functions_per_thread);
+
+    auto handle = pljit.lookup("f3_999");
+    ASSERT_TRUE(handle.has_value());
+    EXPECT_EQ((*handle)(), 999);
+}
+
+TEST(Pljit, testUnregister) {
+    Pljit pljit;
+
+    auto square = pljit.registerNamedFunction("square", "PARAM a; BEGIN RETURN a * a END.");
+    auto other = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_TRUE(square.has_value());
+    ASSERT_EQ((*square)(3), 9);
+
+    ASSERT_TRUE(pljit.unregisterFunction(*square));
+    ASSERT_FALSE(pljit.unregisterFunction(*square));
+    EXPECT_FALSE(square->isRegistered());
+    EXPECT_TRUE(other.isRegistered());
+
+    // remaining handles don't evaluate anything
+    EXPECT_FALSE((*square)(3).has_value());
+    EXPECT_EQ(square->call({ 3 }).error(), RuntimeErrorCode::UNREGISTERED_FUNCTION);
+    EXPECT_FALSE(square->compilation_error().has_value());
+    EXPECT_FALSE(square->compileAsync().get().has_value());
+    EXPECT_FALSE(pljit.replace(*square, "PARAM a; BEGIN RETURN a END."));
+
+    EXPECT_FALSE(pljit.lookup("square").has_value());
+    EXPECT_FALSE(pljit.lookup(square->id()).has_value());
+    ASSERT_EQ(pljit.functions().size(), 1);
+
+    // the name can be registered again, with a new id
+    auto registered_again = pljit.registerNamedFunction("square", "PARAM a; BEGIN RETURN a * a * a END.");
+    ASSERT_TRUE(registered_again.has_value());
+    EXPECT_NE(registered_again->id(), square->id());
+    EXPECT_EQ((*pljit.lookup("square"))(3), 27);
+}
+
+TEST(Pljit, testReplace) {
+    Pljit pljit;
+
+    auto handle = *pljit.registerNamedFunction("rule", "PARAM a; BEGIN RETURN a + 1 END.");
+    auto copy = handle;
+    ASSERT_EQ(handle(1), 2);
+
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a + 2 END."));
+    EXPECT_EQ(handle(1), 3);
+    EXPECT_EQ(copy(1), 3);
+    EXPECT_EQ((*pljit.lookup("rule"))(1), 3);
+
+    // a replacement might fail to compile
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a + END.", { .compilation_mode = CompilationMode::EAGER }));
+    EXPECT_EQ(handle.call({ 1 }).error(), RuntimeErrorCode::COMPILATION_ERROR);
+    EXPECT_TRUE(handle.compilation_error().has_value());
+
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a + 3 END."));
+    EXPECT_EQ(handle(1), 4);
+    EXPECT_FALSE(handle.compilation_error().has_value());
+}
+
+TEST(Pljit, testResultsOutliveTheirVersion) {
+    // without a compile cache, nothing but the function keeps its compilation alive
+    Pljit pljit{ { .compile_cache_mode = CompileCacheMode::DISABLED } };
+
+    auto handle = pljit.registerFunction("PARAM a; BEGIN RETURN 1 / a END.");
+    EvaluationResult result = handle.call({ 0 });
+    ASSERT_EQ(result.error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+    auto broken = pljit.registerFunction("PARAM a; BEGIN RETURN b END.");
+    EvaluationResult failed = broken.call({ 0 });
+    std::optional<code::SourceCodeError> error = broken.compilation_error();
+    ASSERT_TRUE(error.has_value());
+
+    // without readers, replaced and unregistered versions are reclaimed by the following replacements
+    ASSERT_TRUE(pljit.unregisterFunction(broken));
+    for (long long version = 0; version < 3; ++version) {
+        ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a + " + std::to_string(version) + " END."));
+        ASSERT_EQ(handle(1), version + 1);
+    }
+
+    EXPECT_EQ(*result.reference(), "1 / a");
+    EXPECT_EQ(result.makeError().position(), code::CodePosition(1, 23));
+    ASSERT_SRC_ERROR_CONTENTS(*error, code::CodePosition(1, 23), "Using undeclared identifier!", "b");
+    EXPECT_EQ(failed.error(), RuntimeErrorCode::COMPILATION_ERROR);
+    EXPECT_EQ(*failed.reference(), "b");
+}
+
+TEST(Pljit, testReplaceAsync) {
+    Pljit pljit{ { .compile_threads = 2 } };
+
+    auto handle = *pljit.registerNamedFunction("rule", "PARAM a; BEGIN RETURN a + 1 END.");
+    ASSERT_EQ(handle(1), 2);
+    ASSERT_EQ(handle.version(), 0);
+
+    ASSERT_FALSE(pljit.replaceAsync(handle, "PARAM a; BEGIN RETURN a + 2 END.").get().has_value());
+    EXPECT_EQ(handle(1), 3);
+    EXPECT_EQ(handle.version(), 1);
+    // the published version is compiled already
+    EXPECT_FALSE(handle.optimization_statistics().empty());
+
+    // a version which fails to compile is never published
+    auto error = pljit.replaceAsync(handle, "PARAM a; BEGIN RETURN a + END.").get();
+    ASSERT_TRUE(error.has_value());
+    ASSERT_SRC_ERROR_CONTENTS(*error, code::CodePosition(1, 27), "Expected a primary expression!", "END");
+    EXPECT_EQ(handle(1), 3);
+    EXPECT_EQ(handle.version(), 1);
+    EXPECT_FALSE(handle.compilation_error().has_value());
+
+    // the most recently requested version wins, regardless of the order the compilations complete
+    std::vector<std::future<std::optional<code::SourceCodeError>>> replacements;
+    for (unsigned version = 3; version <= 20; ++version) {
+        replacements.push_back(pljit.replaceAsync(handle, "PARAM a; BEGIN RETURN a + " + std::to_string(version) + " END."));
+    }
+    for (auto& replacement: replacements) {
+        ASSERT_FALSE(replacement.get().has_value());
+    }
+    EXPECT_EQ(handle(1), 21);
+    EXPECT_EQ(handle.version(), 20);
+
+    // replacements of unregistered functions are dropped
+    ASSERT_TRUE(pljit.unregisterFunction(handle));
+    EXPECT_FALSE(pljit.replaceAsync(handle, "PARAM a; BEGIN RETURN a END.").get().has_value());
+    EXPECT_FALSE(handle.isRegistered());
+
+    // without a compile cache, nothing but the error keeps the dropped version's source code alive
+    for (std::size_t compile_threads: { 0, 2 }) {
+        Pljit uncached{ { .compile_threads = compile_threads, .compile_cache_mode = CompileCacheMode::DISABLED } };
+        auto function = uncached.registerFunction("PARAM a; BEGIN RETURN a END.");
+        auto dropped = uncached.replaceAsync(function, "PARAM a; BEGIN RETURN a + END.").get();
+        ASSERT_TRUE(dropped.has_value());
+        ASSERT_SRC_ERROR_CONTENTS(*dropped, code::CodePosition(1, 27), "Expected a primary expression!", "END");
+        EXPECT_EQ(function(1), 1);
+    }
+}
+
+TEST(Pljit, testMultiThreadedReplaceAsync) {
+    Pljit pljit{ { .compile_threads = 2 } };
+
+    auto handle = pljit.registerFunction("PARAM a; BEGIN RETURN a END.");
+    ASSERT_EQ(handle(0), 0);
+
+    unsigned versions = 200;
+    std::atomic<bool> done = false;
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> readers;
+
+    for (unsigned reader = 0; reader < 2; ++reader) {
+        readers.emplace_back([&]() {
+            long long previous = 0;
+            while (!done.load()) {
+                // every evaluated version is compiled and versions are only ever published in order
+                EvaluationResult result = handle.call({ 0 });
+                if (!result || result.value() < previous) {
+                    failed = true;
+                }
+                previous = result ? result.value() : previous;
+            }
+        });
+    }
+
+    std::vector<std::future<std::optional<code::SourceCodeError>>> replacements;
+    for (unsigned version = 1; version <= versions; ++version) {
+        std::string source = version % 10 == 0 ? "PARAM a; BEGIN RETURN END." : "PARAM a; BEGIN RETURN a + " + std::to_string(version) + " END.";
+        replacements.push_back(pljit.replaceAsync(handle, std::move(source)));
+    }
+    for (unsigned index = 0; index < versions; ++index) {
+        ASSERT_EQ(replacements[index].get().has_value(), (index + 1) % 10 == 0);
+    }
+
+    done = true;
+    for (auto& thread: readers) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    EXPECT_EQ(handle(0), versions - 1);
+}
+
+TEST(Pljit, testHotReloadReclamation) {
+    Pljit pljit{ { .compile_threads = 1 } };
+
+    auto handle = *pljit.registerNamedFunction("rule", "PARAM a; BEGIN RETURN a END.");
+
+    unsigned reader_count = 3;
+    unsigned versions = 2000;
+    std::atomic<bool> done = false;
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> readers;
+
+    for (unsigned reader = 0; reader < reader_count; ++reader) {
+        readers.emplace_back([&, reader]() {
+            while (!done.load()) {
+                // the result of any version is `a + version`
+                long long argument = reader * 100'000;
+                std::optional<long long> result = reader % 2 == 0 ? handle(argument) : (*pljit.lookup("rule"))(argument);
+                if (!result || *result < argument || *result > argument + versions) {
+                    failed = true;
+                }
+            }
+        });
+    }
+
+    for (unsigned version = 1; version <= versions; ++version) {
+        CompileOptions options;
+        if (version % 2 == 0) {
+            options.compilation_mode = CompilationMode::EAGER;
+        }
+        ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a + " + std::to_string(version) + " END.", options));
+
+        // continuously register and unregister temporary functions as well
+        auto temporary = pljit.registerNamedFunction("temporary", "BEGIN RETURN 1 END.");
+        ASSERT_TRUE(temporary.has_value());
+        ASSERT_TRUE(pljit.unregisterFunction(*temporary));
     }
 
-    ASSERT_EQ(count, 8);
+    // previous versions are reclaimed while readers are active, instead of accumulating till destruction.
+    // A reader preempted while evaluating delays reclamation, so this doesn't hold for single versions.
+    EXPECT_LT(pljit.registry.pendingReclamation(), versions);
+
+    done = true;
+    for (auto& thread: readers) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    EXPECT_EQ(handle(0), versions);
+
+    // without readers, everything but the latest retirements is reclaimed
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN a END."));
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a; BEGIN RETURN -a END."));
+    EXPECT_LE(pljit.registry.pendingReclamation(), 2);
+    EXPECT_LE(pljit.compile_cache->size(), 3);
+}
+
+TEST(Pljit, testTieredExecution) {
+    std::string source = "PARAM a; VAR b; CONST c = 3; BEGIN b := c * 4; RETURN a + b END.";
+    CompileOptions options{ .tier_up_threshold = 10 };
+
+    {
+        // without compile threads, the optimized tier is compiled on a new thread
+        Pljit pljit;
+        auto handle = pljit.registerFunction(std::string{ source }, options);
+
+        for (unsigned call = 1; call < 10; ++call) {
+            ASSERT_EQ(handle(call), call + 12);
+        }
+        TierStatistics statistics = handle.tier_statistics();
+        EXPECT_EQ(statistics.tier, ExecutionTier::BASELINE);
+        EXPECT_EQ(statistics.tier_up_threshold, 10);
+        EXPECT_EQ(statistics.baseline_calls, 9);
+        EXPECT_FALSE(statistics.promotion_pending);
+        // the baseline tier isn't optimized
+        EXPECT_TRUE(handle.optimization_statistics().empty());
+
+        // the call crossing the threshold still evaluates the baseline tier
+        ASSERT_EQ(handle(10), 22);
+        EXPECT_EQ(handle.tier_statistics().tier, ExecutionTier::BASELINE);
+        EXPECT_TRUE(handle.optimization_statistics().empty());
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while (handle.tier_statistics().promotion_pending && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        // the first call after the compilation completed is promoted
+        ASSERT_EQ(handle(11), 23);
+        statistics = handle.tier_statistics();
+        EXPECT_EQ(statistics.tier, ExecutionTier::OPTIMIZED);
+        EXPECT_EQ(statistics.baseline_calls, 11);
+        EXPECT_GT(statistics.promotion_time.count(), 0);
+        EXPECT_FALSE(handle.optimization_statistics().empty());
+
+        // calls aren't counted anymore once promoted
+        ASSERT_EQ(handle(12), 24);
+        EXPECT_EQ(handle.tier_statistics().baseline_calls, 11);
+    }
+
+    {
+        // the optimized tier is compiled in the background and picked up once ready
+        Pljit pljit{ { .compile_threads = 1 } };
+        auto handle = pljit.registerFunction(std::string{ source }, options);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        long long call = 0;
+        while (handle.tier_statistics().tier == ExecutionTier::BASELINE && std::chrono::steady_clock::now() < deadline) {
+            ++call;
+            ASSERT_EQ(handle(call), call + 12);
+        }
+
+        TierStatistics statistics = handle.tier_statistics();
+        EXPECT_EQ(statistics.tier, ExecutionTier::OPTIMIZED);
+        EXPECT_GE(statistics.baseline_calls, 10);
+        EXPECT_FALSE(statistics.promotion_pending);
+        EXPECT_EQ(handle(1), 13);
+    }
+
+    {
+        // tiered execution is disabled by default
+        Pljit pljit;
+        auto handle = pljit.registerFunction(std::string{ source });
+        ASSERT_EQ(handle(1), 13);
+        TierStatistics statistics = handle.tier_statistics();
+        EXPECT_EQ(statistics.tier, ExecutionTier::OPTIMIZED);
+        EXPECT_EQ(statistics.tier_up_threshold, 0);
+        EXPECT_EQ(statistics.baseline_calls, 0);
+    }
+}
+
+TEST(Pljit, testMultiThreadedTieredExecution) {
+    Pljit pljit{ { .compile_threads = 2 } };
+    auto handle = pljit.registerFunction("PARAM a, b; BEGIN RETURN a * b + 2 * 3 END.", { .tier_up_threshold = 100 });
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+    for (long long thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (long long call = 0; call < 500; ++call) {
+                if (handle(thread, call) != thread * call + 6) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    EXPECT_GE(handle.tier_statistics().baseline_calls, 100);
+}
+
+TEST(Pljit, testValueSpeculation) {
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto handle = pljit.registerFunction("PARAM a, b; BEGIN RETURN a * b + b / (a - 4) END.", { .execution_mode = mode, .value_profile_calls = 20 });
+
+        for (long long call = 0; call < 19; ++call) {
+            ASSERT_EQ(handle(5, call), 6 * call);
+        }
+        SpeculationStatistics statistics = handle.speculation_statistics();
+        EXPECT_EQ(statistics.state, SpeculationState::PROFILING);
+        EXPECT_EQ(statistics.profiled_calls, 19);
+        EXPECT_TRUE(statistics.guarded_values.empty());
+
+        // without compile threads, the speculative version is compiled on a new thread
+        ASSERT_EQ(handle(5, 19), 6 * 19);
+        statistics = handle.speculation_statistics();
+        EXPECT_EQ(statistics.state, SpeculationState::COMPILING);
+        EXPECT_EQ(statistics.profiled_calls, 20);
+        EXPECT_EQ(statistics.guarded_values, (std::vector<std::optional<long long>>{ 5, std::nullopt }));
+
+        // calls failing with an argument count error pick up the speculative version once ready, without touching the guard
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while (handle.speculation_statistics().state == SpeculationState::COMPILING && std::chrono::steady_clock::now() < deadline) {
+            EXPECT_EQ(handle.call({ 5 }).error(), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        EXPECT_EQ(handle.speculation_statistics().state, SpeculationState::GUARDED);
+
+        ASSERT_EQ(handle(5, 3), 18);
+        ASSERT_EQ(handle(4, 3), std::nullopt);
+        // the speculative version reports the same runtime errors
+        auto result = handle.call({ 4, 3 });
+        EXPECT_EQ(result.error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+        EXPECT_EQ(*result.reference(), "b / (a - 4)");
+        EXPECT_EQ(handle.call({ 5 }).error(), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+
+        statistics = handle.speculation_statistics();
+        EXPECT_EQ(statistics.guard_hits, 1);
+        EXPECT_EQ(statistics.guard_misses, 2);
+        EXPECT_NEAR(statistics.hit_rate(), 1.0 / 3.0, 0.001);
+
+        // a guard which keeps missing drops the speculative version
+        for (long long call = 0; call < 100; ++call) {
+            ASSERT_EQ(handle(6, call), 6 * call + call / 2);
+        }
+        statistics = handle.speculation_statistics();
+        EXPECT_EQ(statistics.state, SpeculationState::DROPPED);
+        EXPECT_LT(statistics.guard_misses, 100);
+        ASSERT_EQ(handle(5, 3), 18);
+        EXPECT_EQ(handle.speculation_statistics().guard_hits, statistics.guard_hits);
+    }
+
+    auto unstable = pljit.registerFunction("PARAM a, b; BEGIN RETURN a + b END.", { .value_profile_calls = 10 });
+    for (long long call = 0; call < 20; ++call) {
+        ASSERT_EQ(unstable(call, -call), 0);
+    }
+    EXPECT_EQ(unstable.speculation_statistics().state, SpeculationState::UNSTABLE);
+    EXPECT_EQ(unstable.speculation_statistics().guarded_values, (std::vector<std::optional<long long>>{ std::nullopt, std::nullopt }));
+
+    // value profiling is disabled by default
+    auto disabled = pljit.registerFunction("PARAM a; BEGIN RETURN a END.");
+    ASSERT_EQ(disabled(1), 1);
+    EXPECT_EQ(disabled.speculation_statistics().state, SpeculationState::DISABLED);
+}
+
+TEST(Pljit, testMultiThreadedValueSpeculation) {
+    Pljit pljit{ { .compile_threads = 1 } };
+    auto handle = pljit.registerFunction("PARAM a, b, c; BEGIN RETURN a * b + c END.", { .value_profile_calls = 100 });
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+    for (long long thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread]() {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+            for (long long call = 0; call < 500 || (handle.speculation_statistics().guard_hits == 0 && std::chrono::steady_clock::now() < deadline); ++call) {
+                // every 50th call misses the guard of `a`. `c` differs for every call, even if a single thread
+                // happens to evaluate all profiled calls.
+                long long a = call % 50 == 0 ? 3 : 2;
+                long long c = call * 4 + thread;
+                if (handle(a, call, c) != a * call + c) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(failed);
+    SpeculationStatistics statistics = handle.speculation_statistics();
+    EXPECT_EQ(statistics.state, SpeculationState::GUARDED);
+    ASSERT_EQ(statistics.guarded_values.size(), 3);
+    EXPECT_EQ(statistics.guarded_values[0], 2);
+    EXPECT_FALSE(statistics.guarded_values[1]);
+    EXPECT_FALSE(statistics.guarded_values[2]);
+    EXPECT_GT(statistics.guard_hits, 0);
+    EXPECT_GT(statistics.hit_rate(), 0.9);
+}
+
+TEST(Pljit, testCommonSubexpressionElimination) {
+    Pljit pljit;
+    const char* source = "PARAM a, b, c; VAR d; BEGIN d := (a + b) * c - (a + b); a := (a + b) / c; RETURN d * ((a + b) / c) + (b + a) / c END.";
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto reference = pljit.registerFunction(source, { .execution_mode = mode, .optimization_level = OptimizationLevel::O0 });
+        auto optimized = pljit.registerFunction(source, { .execution_mode = mode, .optimization_level = OptimizationLevel::O2 });
+
+        for (long long a = -3; a <= 3; ++a) {
+            for (long long c = -2; c <= 2; ++c) {
+                auto expected = reference.call({ a, 2, c });
+                auto actual = optimized.call({ a, 2, c });
+                ASSERT_EQ(actual.error(), expected.error());
+                if (expected) {
+                    ASSERT_EQ(actual.value(), expected.value());
+                } else {
+                    ASSERT_EQ(*actual.reference(), *expected.reference());
+                }
+            }
+        }
+
+        auto statistics = optimized.optimization_statistics();
+        ASSERT_EQ(statistics.size(), 3);
+        EXPECT_EQ(statistics[2].name, "CommonSubexpressionElimination");
+        EXPECT_EQ(statistics[2].changes, 1);
+    }
+}
+
+TEST(Pljit, testMemoization) {
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        unsigned reported = 0;
+        auto handle = pljit.registerFunction(
+            "PARAM a, b; BEGIN RETURN a / b END.",
+            { .execution_mode = mode, .runtime_error_handler = [&](const EvaluationResult&) { ++reported; }, .memoization_memory_limit = 4096 }
+        );
+
+        EXPECT_EQ(handle(6, 3), 2);
+        EXPECT_EQ(handle(6, 3), 2);
+        EXPECT_EQ(handle.call({ 6, 3 }).value(), 2);
+
+        // runtime errors are cached with their reference, but still reported on every call
+        EXPECT_EQ(handle(1, 0), std::nullopt);
+        auto result = handle.call({ 1, 0 });
+        EXPECT_EQ(result.error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+        EXPECT_EQ(*result.reference(), "a / b");
+        EXPECT_EQ(handle(1, 0), std::nullopt);
+        EXPECT_EQ(reported, 2);
+
+        EXPECT_EQ(handle.call({ 1 }).error(), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+
+        MemoizationStatistics statistics = handle.memoization_statistics();
+        EXPECT_EQ(statistics.hits, 4);
+        EXPECT_EQ(statistics.misses, 2);
+        EXPECT_EQ(statistics.entries, 2);
+        EXPECT_GT(statistics.capacity, 2);
+        EXPECT_LE(statistics.memory_bytes, 4096);
+    }
+
+    // only calls missing the cache are counted for the tier promotion
+    auto tiered = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.", { .tier_up_threshold = 3, .memoization_memory_limit = 4096 });
+    for (unsigned call = 0; call < 10; ++call) {
+        ASSERT_EQ(tiered(1), 2);
+        ASSERT_EQ(tiered(2), 4);
+    }
+    EXPECT_EQ(tiered.tier_statistics().baseline_calls, 2);
+    EXPECT_EQ(tiered(3), 6);
+    EXPECT_EQ(tiered.tier_statistics().baseline_calls, 3);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+    while (tiered.tier_statistics().promotion_pending && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    EXPECT_EQ(tiered(4), 8);
+    EXPECT_EQ(tiered.tier_statistics().tier, ExecutionTier::OPTIMIZED);
+
+    // replacing the function starts with an empty cache
+    ASSERT_TRUE(pljit.replace(tiered, "PARAM a; BEGIN RETURN a * 3 END.", { .memoization_memory_limit = 4096 }));
+    EXPECT_EQ(tiered(1), 3);
+    EXPECT_EQ(tiered.memoization_statistics().misses, 1);
+
+    // memoization is disabled by default, for limits not fitting a single result and for functions failing to compile
+    auto disabled = pljit.registerFunction("PARAM a; BEGIN RETURN a END.");
+    ASSERT_EQ(disabled(1), 1);
+    EXPECT_EQ(disabled.memoization_statistics().capacity, 0);
+    auto small = pljit.registerFunction("PARAM a; BEGIN RETURN a END.", { .memoization_memory_limit = 1 });
+    ASSERT_EQ(small(1), 1);
+    EXPECT_EQ(small.memoization_statistics().capacity, 0);
+    auto broken = pljit.registerFunction("PARAM a; BEGIN RETURN b END.", { .memoization_memory_limit = 4096 });
+    EXPECT_EQ(broken.call({ 1 }).error(), RuntimeErrorCode::COMPILATION_ERROR);
+    EXPECT_EQ(broken.memoization_statistics().misses, 0);
+}
+
+TEST(Pljit, testMultiThreadedMemoization) {
+    Pljit pljit{ { .compile_threads = 1 } };
+    auto handle = pljit.registerFunction("PARAM a, b; BEGIN RETURN a * b END.", { .tier_up_threshold = 50, .memoization_memory_limit = 16 * 1024 });
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+    for (long long thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (long long call = 0; call < 2000; ++call) {
+                long long a = (call + thread) % 500;
+                if (handle(a, 3) != a * 3) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    MemoizationStatistics statistics = handle.memoization_statistics();
+    EXPECT_EQ(statistics.hits + statistics.misses, 8000);
+    EXPECT_GT(statistics.hits, 0);
+}
+
+TEST(Pljit, testSpecialize) {
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto handle = pljit.registerFunction("PARAM a, b, c; VAR d; BEGIN d := a * b + c; RETURN d / b END.", { .execution_mode = mode });
+
+        auto specialization = pljit.specialize(handle, { 2, std::nullopt, 3 });
+        ASSERT_TRUE(specialization.has_value());
+        EXPECT_NE(specialization->id(), handle.id());
+        EXPECT_EQ((*specialization)(4), 2);
+        EXPECT_EQ(handle(2, 4, 3), 2);
+        EXPECT_EQ(specialization->call({ 0 }).error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+        EXPECT_EQ(specialization->call({ 4, 3 }).error(), RuntimeErrorCode::TOO_MANY_ARGUMENTS);
+
+        // the same bindings return the same specialization, trailing unbound parameters don't matter
+        EXPECT_EQ(pljit.specialize(handle, { 2, {}, 3 })->id(), specialization->id());
+        EXPECT_EQ(pljit.specialize(handle, { 2 })->id(), pljit.specialize(handle, { 2, {}, {} })->id());
+        EXPECT_NE(pljit.specialize(handle, { 2 })->id(), specialization->id());
+
+        // specializing a specialization binds its remaining parameters
+        auto constant = pljit.specialize(*specialization, { 4 });
+        ASSERT_TRUE(constant.has_value());
+        EXPECT_EQ(constant->call({}).value(), 2);
+        EXPECT_EQ(constant->call({ 4 }).error(), RuntimeErrorCode::UNEXPECTED_ARGUMENTS);
+        auto statistics = constant->optimization_statistics();
+        ASSERT_FALSE(statistics.empty());
+        EXPECT_GT(statistics[0].removed_nodes, 0);
+
+        EXPECT_FALSE(pljit.specialize(handle, { 1, 2, 3, 4 }).has_value());
+        EXPECT_FALSE(pljit.specialize(*specialization, { 1, 2 }).has_value());
+    }
+
+    // bound parameters can still be assigned, also without constant propagation folding the reads
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        for (auto level: {OptimizationLevel::O0, OptimizationLevel::O2}) {
+            auto accumulate = pljit.registerFunction("PARAM a, b; BEGIN a := a + b; RETURN a * 2 END.", { .execution_mode = mode, .optimization_level = level });
+            auto specialization = *pljit.specialize(accumulate, { 5 });
+            EXPECT_EQ(specialization(3), 16);
+            EXPECT_EQ(specialization(1), 12);
+
+            // every chunk of a batch starts with the bound value
+            std::vector<long long> b(3000);
+            for (std::size_t row = 0; row < b.size(); ++row) {
+                b[row] = static_cast<long long>(row % 7);
+            }
+            std::vector<long long> output(b.size());
+            std::vector<std::uint64_t> errors((b.size() + 63) / 64);
+            ASSERT_EQ(specialization.evaluateBatch({ b }, output, errors), RuntimeErrorCode::NONE);
+            for (std::size_t row = 0; row < b.size(); ++row) {
+                ASSERT_EQ(output[row], (5 + b[row]) * 2) << row;
+            }
+        }
+    }
+
+    // identities never hide a runtime error
+    auto divide = pljit.registerFunction("PARAM a, b; BEGIN RETURN a * (b / 0) END.");
+    EXPECT_EQ(pljit.specialize(divide, { 0 })->call({ 1 }).error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+
+    auto broken = pljit.registerFunction("PARAM a; BEGIN RETURN b END.");
+    EXPECT_FALSE(pljit.specialize(broken, { 1 }).has_value());
+}
+
+TEST(Pljit, testSpecializationCache) {
+    Pljit pljit{ { .specialization_cache_size = 2 } };
+    auto handle = pljit.registerFunction("PARAM a, b; BEGIN RETURN a + b END.");
+
+    auto one = *pljit.specialize(handle, { 1 });
+    auto two = *pljit.specialize(handle, { 2 });
+    EXPECT_EQ(one(1), 2);
+
+    // requesting `one` again makes `two` the least recently used specialization
+    EXPECT_EQ(pljit.specialize(handle, { 1 })->id(), one.id());
+    auto three = *pljit.specialize(handle, { 3 });
+    EXPECT_EQ(three(1), 4);
+    EXPECT_TRUE(one.isRegistered());
+    EXPECT_FALSE(two.isRegistered());
+    EXPECT_EQ(two.call({ 1 }).error(), RuntimeErrorCode::UNREGISTERED_FUNCTION);
+
+    // evicted and explicitly unregistered specializations are created again
+    auto two_again = *pljit.specialize(handle, { 2 });
+    EXPECT_NE(two_again.id(), two.id());
+    EXPECT_EQ(two_again(1), 3);
+    ASSERT_TRUE(pljit.unregisterFunction(two_again));
+    auto previous = *pljit.specialize(handle, { 2 });
+    EXPECT_EQ(previous(1), 3);
+
+    // replacing the function doesn't affect existing specializations, new requests specialize the new version
+    ASSERT_TRUE(pljit.replace(handle, "PARAM a, b; BEGIN RETURN a - b END."));
+    auto replaced = *pljit.specialize(handle, { 2 });
+    EXPECT_EQ(replaced(1), 1);
+    EXPECT_EQ(previous(1), 3);
+    EXPECT_EQ(pljit.specialize(handle, { 2 })->id(), replaced.id());
+
+    ASSERT_TRUE(pljit.unregisterFunction(handle));
+    EXPECT_FALSE(pljit.specialize(handle, { 2 }).has_value());
+}
+
+TEST(Pljit, testSpecializationSlotReuse) {
+    Pljit pljit{ { .specialization_cache_size = 2 } };
+    auto handle = pljit.registerFunction("PARAM a, b; BEGIN RETURN a + b END.");
+    auto evicted = *pljit.specialize(handle, { 0 });
+
+    // every evicted specialization frees its slot for the next one, so the registry doesn't grow
+    for (long long binding = 1; binding <= 1000; ++binding) {
+        EXPECT_EQ((*pljit.specialize(handle, { binding }))(1), binding + 1);
+    }
+    EXPECT_LT(pljit.registry.size(), 16);
+    std::vector<PljitFunctionHandle> functions = pljit.functions();
+    EXPECT_EQ(functions.size(), 3);
+
+    auto reusing = std::find_if(functions.begin(), functions.end(), [&](const PljitFunctionHandle& function) {
+        return function.id() >> FunctionRegistry::GENERATION_BITS == evicted.id() >> FunctionRegistry::GENERATION_BITS;
+    });
+    ASSERT_NE(reusing, functions.end());
+    EXPECT_NE(reusing->id(), evicted.id());
+
+    // handles of the evicted specialization don't resolve to the function which reuses its slot
+    EXPECT_FALSE(evicted.isRegistered());
+    EXPECT_EQ(evicted.call({ 1 }).error(), RuntimeErrorCode::UNREGISTERED_FUNCTION);
+    EXPECT_FALSE(pljit.lookup(evicted.id()).has_value());
+    EXPECT_FALSE(pljit.replace(evicted, "PARAM b; BEGIN RETURN b END."));
+    EXPECT_FALSE(pljit.unregisterFunction(evicted));
+    EXPECT_TRUE(reusing->isRegistered());
+    EXPECT_EQ(pljit.lookup(reusing->id())->id(), reusing->id());
 }
 
 TEST(Pljit, testErrorPrinting) {
@@ -168,6 +1036,209 @@ TEST(Pljit, testErrorPrinting) {
     ASSERT_FALSE(result);
     ASSERT_EQ(capture.str(), "Division by zero!\n");
 }
+
+TEST(Pljit, testEvaluationResult) {
+    Pljit pljit;
+
+    for (auto mode: {ExecutionMode::AST_INTERPRETER, ExecutionMode::BYTECODE, ExecutionMode::NATIVE}) {
+        auto func = pljit.registerFunction("PARAM a, b;\n"
+                                           "VAR c;\n"
+                                           "BEGIN\n"
+                                           "  c := a / b;\n"
+                                           "  RETURN (c + 1) / (a - 3)\n"
+                                           "END.", { .execution_mode = mode });
+
+        CaptureCOut capture;
+
+        EvaluationResult result = func.call({8, 2});
+        ASSERT_TRUE(result);
+        ASSERT_EQ(result.value(), 1);
+
+        result = func.call({1, 0});
+        ASSERT_TRUE(result.isFailure());
+        ASSERT_EQ(result.error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+        ASSERT_EQ(result.message(), "Division by zero!");
+        ASSERT_TRUE(result.hasReference());
+        ASSERT_EQ(*result.reference(), "a / b");
+        ASSERT_EQ(result.reference().position(), code::CodePosition(4, 8));
+
+        result = func.call({3, 1});
+        ASSERT_EQ(result.error(), RuntimeErrorCode::DIVISION_BY_ZERO);
+        ASSERT_EQ(*result.reference(), "(c + 1) / (a - 3)");
+        ASSERT_EQ(result.reference().position(), code::CodePosition(5, 10));
+
+        result = func.call({1});
+        ASSERT_EQ(result.error(), RuntimeErrorCode::TOO_FEW_ARGUMENTS);
+        ASSERT_FALSE(result.hasReference());
+        result = func.call({1, 2, 3});
+        ASSERT_EQ(result.error(), RuntimeErrorCode::TOO_MANY_ARGUMENTS);
+
+        capture.stopCapture();
+        ASSERT_EQ(capture.str(), "");
+    }
+
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(func.call({1}).error(), RuntimeErrorCode::UNEXPECTED_ARGUMENTS);
+
+    func = pljit.registerFunction("VAR a; BEGIN RETURN a END.");
+    ASSERT_EQ(func.call({}).error(), RuntimeErrorCode::COMPILATION_ERROR);
+    ASSERT_TRUE(func.compilation_error());
+}
+
+TEST(Pljit, testRuntimeErrorHandler) {
+    Pljit pljit;
+
+    std::vector<RuntimeErrorCode> errors;
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN 1 / a END.", {
+        .runtime_error_handler = [&](const EvaluationResult& result) { errors.push_back(result.error()); }
+    });
+
+    CaptureCOut capture;
+    ASSERT_FALSE(func(0));
+    ASSERT_FALSE(func());
+    ASSERT_EQ(func(1), 1);
+    ASSERT_EQ(errors, std::vector({ RuntimeErrorCode::DIVISION_BY_ZERO, RuntimeErrorCode::TOO_FEW_ARGUMENTS }));
+
+    // reporting disabled
+    func = pljit.registerFunction("BEGIN RETURN 1 / 0 END.", { .runtime_error_handler = nullptr });
+    ASSERT_FALSE(func());
+
+    capture.stopCapture();
+    ASSERT_EQ(capture.str(), "");
+}
+
+TEST(Pljit, testEagerCompilation) {
+    auto isReady = [](const std::future<std::optional<code::SourceCodeError>>& future) {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+
+    // without a compile thread pool, the function is compiled during registration
+    {
+        Pljit pljit;
+        auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.", { .compilation_mode = CompilationMode::EAGER });
+        ASSERT_TRUE(isReady(func.compileAsync()));
+        ASSERT_EQ(func(21), 42);
+    }
+    {
+        Pljit pljit{ { .compile_threads = 2 } };
+        auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.", { .compilation_mode = CompilationMode::EAGER });
+        auto broken = pljit.registerFunction("BEGIN RETURN a END.", { .compilation_mode = CompilationMode::EAGER });
+
+        // evaluation waits for the background compilation
+        ASSERT_EQ(func(21), 42);
+        ASSERT_FALSE(broken.compileAsync().get()->message().empty());
+        ASSERT_TRUE(broken.compilation_error());
+    }
+}
+
+TEST(Pljit, testCompileAsync) {
+    for (std::size_t compile_threads: { 0, 4 }) {
+        Pljit pljit{ { .compile_threads = compile_threads } };
+        auto func = pljit.registerFunction("PARAM a; CONST b = 3; BEGIN RETURN a - b END.");
+        auto broken = pljit.registerFunction("CONST a;\nBEGIN\n  RETURN a\nEND.");
+
+        auto compilation = func.compileAsync();
+        auto failed_compilation = broken.compileAsync();
+
+        ASSERT_FALSE(compilation.get());
+        ASSERT_EQ(func(5), 2);
+
+        std::optional<code::SourceCodeError> error = failed_compilation.get();
+        ASSERT_TRUE(error);
+        ASSERT_SRC_ERROR_CONTENTS(*error, code::CodePosition(1, 8), "Expected `=` operator!", ";");
+        ASSERT_FALSE(broken());
+    }
+}
+
+TEST(Pljit, testWarmup) {
+    for (std::size_t compile_threads: { 0, 3 }) {
+        Pljit pljit{ { .compile_threads = compile_threads } };
+
+        std::vector<PljitFunctionHandle> functions;
+        for (long long index = 0; index < 16; ++index) {
+            functions.push_back(pljit.registerFunction("PARAM a; BEGIN RETURN a + " + std::to_string(index) + " END."));
+        }
+
+        pljit.warmup();
+
+        for (long long index = 0; index < 16; ++index) {
+            auto compilation = functions[index].compileAsync();
+            ASSERT_EQ(compilation.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+            ASSERT_EQ(functions[index](1), index + 1);
+        }
+    }
+}
+
+TEST(Pljit, testCompileCache) {
+    {
+        Pljit pljit;
+        auto first = pljit.registerFunction("PARAM a; BEGIN RETURN a * 3 END.");
+        auto second = pljit.registerFunction("PARAM a; BEGIN RETURN a * 3 END.");
+        auto interpreted = pljit.registerFunction("PARAM a; BEGIN RETURN a * 3 END.", { .execution_mode = ExecutionMode::AST_INTERPRETER });
+        auto spaced = pljit.registerFunction("PARAM a;\nBEGIN\n  RETURN a * 3\nEND.");
+
+        ASSERT_EQ(first(2), 6);
+        ASSERT_EQ(second(3), 9);
+        ASSERT_EQ(interpreted(4), 12);
+        ASSERT_EQ(spaced(5), 15);
+        ASSERT_EQ(pljit.compile_cache->size(), 3);
+    }
+    {
+        Pljit pljit{ { .compile_cache_mode = CompileCacheMode::IGNORE_WHITESPACE } };
+        auto first = pljit.registerFunction("PARAM a; BEGIN RETURN a * 3 END.");
+        auto spaced = pljit.registerFunction("PARAM a;\nBEGIN\n  RETURN a*3\nEND.\n");
+        auto broken = pljit.registerFunction("BEGIN RETURN b END.");
+        auto broken_spaced = pljit.registerFunction("BEGIN\tRETURN b END.");
+
+        ASSERT_EQ(first(2), 6);
+        ASSERT_EQ(spaced(5), 15);
+        ASSERT_FALSE(broken());
+        ASSERT_FALSE(broken_spaced());
+        ASSERT_EQ(broken.compilation_error()->message(), broken_spaced.compilation_error()->message());
+        ASSERT_EQ(pljit.compile_cache->size(), 2);
+    }
+    {
+        Pljit pljit{ { .compile_cache_mode = CompileCacheMode::DISABLED } };
+        auto first = pljit.registerFunction("PARAM a; BEGIN RETURN a * 3 END.");
+        ASSERT_EQ(first(2), 6);
+        ASSERT_EQ(pljit.compile_cache, nullptr);
+    }
+}
+
+TEST(Pljit, testCompileCacheNormalization) {
+    ASSERT_EQ(CompileCache::normalize(" PARAM  a, b ;\n\tBEGIN RETURN a+b\nEND. ", CompileCacheMode::IGNORE_WHITESPACE),
+              "PARAM a,b;BEGIN RETURN a+b END.");
+    // `: =` must not be joined to the assignment operator
+    ASSERT_EQ(CompileCache::normalize("a : = 1", CompileCacheMode::IGNORE_WHITESPACE), "a: =1");
+    ASSERT_EQ(CompileCache::normalize("a := 1 2", CompileCacheMode::IGNORE_WHITESPACE), "a:=1 2");
+    ASSERT_EQ(CompileCache::normalize(" a ", CompileCacheMode::EXACT), " a ");
+}
+
+TEST(Pljit, testMultiThreadedCompileCache) {
+    Pljit pljit;
+
+    unsigned thread_count = 8;
+    std::vector<PljitFunctionHandle> functions;
+    for (unsigned i = 0; i < thread_count; ++i) {
+        functions.push_back(pljit.registerFunction("PARAM a; VAR b; BEGIN b := a * a; RETURN b - 1 END."));
+    }
+
+    std::vector<std::optional<long long>> results(thread_count);
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&functions, &results, i]() {
+            results[i] = functions[i](static_cast<long long>(i));
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (unsigned i = 0; i < thread_count; ++i) {
+        ASSERT_EQ(results[i], static_cast<long long>(i * i) - 1);
+    }
+}
 //---------------------------------------------------------------------------
 } // namespace pljit
 //---------------------------------------------------------------------------
@@ -1,4 +1,5 @@
 #include "pljit/code/SourceCodeManagement.hpp"
+#include "pljit/util/Result.hpp"
 #include "utils/CaptureCOut.hpp"
 #include <gtest/gtest.h>
 //---------------------------------------------------------------------------
@@ -136,3 +137,77 @@ TEST(SourceCodeManagement, testErrorInLineWithTabs) {
                              "\t \tsome program;\n"
                              "\t \t   ^\n");
 }
+
+TEST(SourceCodeManagement, testPositions) {
+    std::string program = "PARAM a;\n\nBEGIN\n\tRETURN a\nEND.\n";
+    SourceCodeManagement management{ std::string{ program } };
+
+    unsigned line = 1;
+    unsigned column = 1;
+    for (std::size_t offset = 0; offset <= program.size(); ++offset) {
+        EXPECT_EQ(management.reference(offset, 0).position(), CodePosition(line, column)) << offset;
+
+        if (offset < program.size() && program[offset] == '\n') {
+            ++line;
+            column = 1;
+        } else {
+            ++column;
+        }
+    }
+
+    SourceCodeError error = management.reference(17, 6).makeError(ErrorType::ERROR, "some error!");
+    ASSERT_EQ(*error.reference(), "RETURN");
+    ASSERT_EQ(error.position(), CodePosition(4, 2));
+}
+
+TEST(SourceCodeManagement, testNestedCauses) {
+    SourceCodeManagement management{ "a b c d" };
+
+    SourceCodeError note = management.reference(4, 1).makeError(ErrorType::NOTE, "c");
+    note.attachCause(management.reference(6, 1).makeError(ErrorType::NOTE, "d"));
+
+    SourceCodeError error = management.reference(0, 1).makeError(ErrorType::ERROR, "a");
+    error.attachCause(management.reference(2, 1).makeError(ErrorType::NOTE, "b"));
+    error.attachCause(std::move(note));
+
+    std::span<const Diagnostic> causes = error.attachedCauses();
+    ASSERT_EQ(causes.size(), 3);
+    EXPECT_EQ(causes[0].message, "b");
+    EXPECT_EQ(causes[1].message, "c");
+    EXPECT_EQ(causes[2].message, "d");
+
+    CaptureCOut capture;
+
+    error.printCompilerError();
+    EXPECT_EQ(capture.str(), "1:1: error: a\n"
+                             "a b c d\n"
+                             "^\n"
+                             "1:3: note: b\n"
+                             "a b c d\n"
+                             "  ^\n"
+                             "1:5: note: c\n"
+                             "a b c d\n"
+                             "    ^\n"
+                             "1:7: note: d\n"
+                             "a b c d\n"
+                             "      ^\n");
+}
+
+TEST(SourceCodeManagement, testResultWithoutDefaultConstructor) {
+    struct Value {
+        explicit Value(int value) : value(value) {}
+        int value;
+    };
+    static_assert(!std::default_initializable<Value>);
+
+    SourceCodeManagement management{ "value" };
+
+    Result<Value> success{ Value{ 42 } };
+    ASSERT_TRUE(success.isSuccess());
+    EXPECT_EQ(success->value, 42);
+
+    Result<Value> failure{ management.reference(0, 5).makeError(ErrorType::ERROR, "failed!") };
+    ASSERT_TRUE(failure.isFailure());
+    EXPECT_EQ(failure.error().message(), "failed!");
+    EXPECT_EQ(*failure.error().reference(), "value");
+}
@@ -0,0 +1,37 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "pljit/util/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+//---------------------------------------------------------------------------
+using namespace pljit;
+//---------------------------------------------------------------------------
+TEST(ThreadPool, testSubmit) {
+    ThreadPool pool{ 4 };
+    ASSERT_EQ(pool.thread_count(), 4);
+
+    std::vector<std::future<int>> results;
+    for (int index = 0; index < 100; ++index) {
+        results.push_back(pool.submit([index]() { return index * index; }));
+    }
+
+    for (int index = 0; index < 100; ++index) {
+        ASSERT_EQ(results[index].get(), index * index);
+    }
+}
+
+TEST(ThreadPool, testDrainOnDestruction) {
+    std::atomic<unsigned> executed{ 0 };
+    {
+        ThreadPool pool{ 2 };
+        for (unsigned index = 0; index < 64; ++index) {
+            pool.submit([&executed]() { ++executed; });
+        }
+    }
+    ASSERT_EQ(executed.load(), 64);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#include "./CountAllocations.hpp"
+#include <cstdlib>
+#include <new>
+
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Number of allocations performed by this thread.
+thread_local std::size_t allocations = 0;
+
+void* allocate(std::size_t size) noexcept {
+    ++allocations;
+    return std::malloc(size ? size : 1);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Replace all non-aligned allocation functions, such that allocation and deallocation always match.
+void* operator new(std::size_t size) {
+    if (void* pointer = allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+CountAllocations::CountAllocations() : start(allocations) {}
+CountAllocations::~CountAllocations() = default;
+
+std::size_t CountAllocations::count() const {
+    return allocations - start;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
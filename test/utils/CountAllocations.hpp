@@ -0,0 +1,36 @@
+//
+// Created by Andreas Bauer on 16.10.26.
+//
+
+#ifndef PLJIT_COUNTALLOCATIONS_HPP
+#define PLJIT_COUNTALLOCATIONS_HPP
+
+#include <cstddef>
+
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/**
+ * Counts the calls to the global `operator new` made by the current thread
+ * during the lifetime of the instance.
+ */
+class CountAllocations {
+    std::size_t start;
+
+    public:
+    CountAllocations();
+    ~CountAllocations();
+
+    CountAllocations(const CountAllocations& other) = delete;
+    CountAllocations& operator=(const CountAllocations& other) = delete;
+
+    /**
+     * @return Returns the number of allocations since construction.
+     */
+    std::size_t count() const;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+
+#endif //PLJIT_COUNTALLOCATIONS_HPP